@@ -0,0 +1,172 @@
+#include "FreeRTOS.h"
+#include "core/rt_profile.h"
+#include "task.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_LOOPS 10000
+#define DEFAULT_INTERVAL_MS 1
+#define BUCKET_US 10
+#define BUCKETS 100 // The last bucket collects every later wakeup
+
+static struct {
+  unsigned loops;
+  unsigned interval_ms;
+  bool native;
+  bool rt;
+} options = {DEFAULT_LOOPS, DEFAULT_INTERVAL_MS, false, false};
+
+static struct {
+  unsigned long count;
+  double min_us;
+  double max_us;
+  double total_us;
+  double total_period_us;
+  unsigned long histogram[BUCKETS];
+} stats = {.min_us = 1e12};
+
+static double now_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void record(double error_us) {
+  stats.count++;
+  stats.total_us += error_us;
+  if (error_us < stats.min_us)
+    stats.min_us = error_us;
+  if (error_us > stats.max_us)
+    stats.max_us = error_us;
+
+  unsigned bucket = (unsigned)(error_us / BUCKET_US);
+  stats.histogram[bucket < BUCKETS ? bucket : BUCKETS - 1]++;
+}
+
+// Upper bound of the bucket holding the given fraction of wakeups
+static void report_percentile(const char *name, double fraction) {
+  unsigned long wanted = (unsigned long)(stats.count * fraction);
+  unsigned long seen = 0;
+  for (unsigned i = 0; i < BUCKETS - 1; i++) {
+    seen += stats.histogram[i];
+    if (seen >= wanted) {
+      printf("  %-6s < %u us\n", name, (i + 1) * BUCKET_US);
+      return;
+    }
+  }
+  printf("  %-6s <= %.1f us\n", name, stats.max_us);
+}
+
+static void report(void) {
+  printf("Cyclic latency: %s, %u ms interval, %lu loops, RT profile %s\n",
+         options.native ? "native thread" : "FreeRTOS task",
+         options.interval_ms, stats.count, options.rt ? "on" : "off");
+  if (!stats.count)
+    return;
+
+  printf("  min %8.1f us  avg %8.1f us  max %8.1f us\n", stats.min_us,
+         stats.total_us / stats.count, stats.max_us);
+  if (!options.native)
+    printf("  mean period %.1f us\n", stats.total_period_us / stats.count);
+  report_percentile("p99", 0.99);
+  report_percentile("p99.9", 0.999);
+  report_percentile("p99.99", 0.9999);
+
+  printf("  histogram (%d us buckets)\n", BUCKET_US);
+  for (unsigned i = 0; i < BUCKETS; i++) {
+    if (stats.histogram[i])
+      printf("  %6u%s us %10lu\n", i * BUCKET_US, i == BUCKETS - 1 ? "+" : " ",
+             stats.histogram[i]);
+  }
+}
+
+// Ticks come from the port's tick thread rather than the clock, so each
+// period is measured against the interval instead of an absolute deadline
+static void cyclic_task(void *pvParameters) {
+  (void)pvParameters;
+  const TickType_t period = pdMS_TO_TICKS(options.interval_ms);
+  double interval_us = options.interval_ms * 1e3;
+
+  TickType_t wake = xTaskGetTickCount();
+  vTaskDelayUntil(&wake, period);
+  double last = now_us();
+
+  for (unsigned i = 0; i < options.loops; i++) {
+    vTaskDelayUntil(&wake, period);
+    double now = now_us();
+    double error = now - last - interval_us;
+    stats.total_period_us += now - last;
+    record(error < 0 ? -error : error);
+    last = now;
+  }
+
+  report();
+  exit(0);
+}
+
+// Absolute deadlines on the monotonic clock, like cyclictest
+static void run_native(void) {
+  struct timespec next;
+  clock_gettime(CLOCK_MONOTONIC, &next);
+
+  for (unsigned i = 0; i < options.loops; i++) {
+    next.tv_nsec += options.interval_ms * 1000000L;
+    while (next.tv_nsec >= 1000000000L) {
+      next.tv_nsec -= 1000000000L;
+      next.tv_sec++;
+    }
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    record(now_us() - (next.tv_sec * 1e6 + next.tv_nsec / 1e3));
+  }
+
+  report();
+}
+
+int main(int argc, char **argv) {
+  int opt;
+  while ((opt = getopt(argc, argv, "l:i:nr")) != -1) {
+    switch (opt) {
+    case 'l':
+      options.loops = strtoul(optarg, NULL, 0);
+      break;
+    case 'i':
+      options.interval_ms = strtoul(optarg, NULL, 0);
+      break;
+    case 'n':
+      options.native = true;
+      break;
+    case 'r':
+      options.rt = true;
+      break;
+    default:
+      fprintf(stderr, "usage: %s [-l loops] [-i interval_ms] [-n] [-r]\n",
+              argv[0]);
+      return 2;
+    }
+  }
+  if (!options.interval_ms)
+    options.interval_ms = DEFAULT_INTERVAL_MS;
+
+  // Before any task exists, so the task and tick threads inherit it
+  if (options.rt && !rt_profile_apply(NULL)) {
+    fprintf(stderr, "Failed to apply the RT profile: %s\n", strerror(errno));
+    return 1;
+  }
+
+  if (options.native) {
+    run_native();
+    return 0;
+  }
+
+  if (xTaskCreate(cyclic_task, "cyclic", configMINIMAL_STACK_SIZE * 2, NULL,
+                  configMAX_PRIORITIES - 1, NULL) != pdPASS) {
+    fprintf(stderr, "Failed to create the cyclic task\n");
+    return 1;
+  }
+  vTaskStartScheduler();
+  return 1;
+}
@@ -0,0 +1,201 @@
+#include "core/uni_loop.h"
+#include "hal/gpio_linux.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define EDGES 50
+#define EDGE_INTERVAL_US 20000
+
+// Character device input line, driven by a producer thread through either
+// an output line wired back to it or the pull attribute of a gpio-sim line
+static struct {
+  gpio_handle_t input;
+  linux_gpio_line_t input_line;
+  gpio_handle_t output;
+  linux_gpio_line_t output_line;
+  const char *pull_path; // gpio-sim sim_gpioN/pull, NULL with an output
+  bool level;
+  _Atomic double edge_ns; // When the producer last drove a change
+  atomic_bool done;
+} pin;
+
+typedef struct {
+  unsigned long wakeups;
+  unsigned edges;
+  bool last;
+  double total_ns;
+  double max_ns;
+} result_t;
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static bool drive(bool level) {
+  if (!pin.pull_path)
+    return gpio_write(&pin.output, level);
+
+  int fd = open(pin.pull_path, O_WRONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+  const char *value = level ? "pull-up" : "pull-down";
+  bool ok = write(fd, value, strlen(value)) == (ssize_t)strlen(value);
+  close(fd);
+  return ok;
+}
+
+// <chip> <input offset> <output offset | gpio-sim pull attribute>
+static bool setup_pins(int argc, char **argv) {
+  if (argc < 4) {
+    printf("usage: %s <chip> <input offset> <output offset>\n"
+           "       %s <chip> <input offset> <gpio-sim pull attribute>\n"
+           "The output must be wired to the input.\n",
+           argv[0], argv[0]);
+    return false;
+  }
+
+  pin.input_line = (linux_gpio_line_t){
+      .chip = argv[1], .offset = (uint32_t)strtoul(argv[2], NULL, 0)};
+  gpio_config_t input = {.is_output = false,
+                         .active_high = true,
+                         .platform_specific = &pin.input_line};
+  if (!linux_gpio_driver.create(&pin.input) || !gpio_init(&pin.input, &input))
+    return false;
+
+  if (argv[3][0] == '/') {
+    pin.pull_path = argv[3];
+  } else {
+    pin.output_line = (linux_gpio_line_t){
+        .chip = argv[1], .offset = (uint32_t)strtoul(argv[3], NULL, 0)};
+    gpio_config_t output = {.is_output = true,
+                            .active_high = true,
+                            .platform_specific = &pin.output_line};
+    if (!linux_gpio_driver.create(&pin.output) ||
+        !gpio_init(&pin.output, &output))
+      return false;
+  }
+
+  pin.level = false;
+  return drive(false);
+}
+
+static void teardown_pins(void) {
+  gpio_deinit(&pin.input);
+  linux_gpio_driver.destroy(&pin.input);
+  if (!pin.pull_path) {
+    gpio_deinit(&pin.output);
+    linux_gpio_driver.destroy(&pin.output);
+  }
+}
+
+static void *producer(void *arg) {
+  (void)arg;
+  for (int i = 0; i < EDGES; i++) {
+    usleep(EDGE_INTERVAL_US);
+    pin.level = !pin.level;
+    atomic_store(&pin.edge_ns, now_ns());
+    if (!drive(pin.level))
+      break;
+  }
+  usleep(EDGE_INTERVAL_US);
+  atomic_store(&pin.done, true);
+  return NULL;
+}
+
+// Count a change of the input level read back from the line
+static void record_level(result_t *result) {
+  bool level = gpio_read(&pin.input);
+  if (level == result->last)
+    return;
+  result->last = level;
+
+  double latency = now_ns() - atomic_load(&pin.edge_ns);
+  result->edges++;
+  result->total_ns += latency;
+  if (latency > result->max_ns)
+    result->max_ns = latency;
+}
+
+static void report(const char *name, const result_t *result) {
+  printf("  %-12s %6lu wakeups %4u edges  avg %8.1f us  max %8.1f us\n", name,
+         result->wakeups, result->edges,
+         result->edges ? result->total_ns / result->edges / 1e3 : 0.0,
+         result->max_ns / 1e3);
+}
+
+static void start_producer(pthread_t *thread) {
+  atomic_store(&pin.done, false);
+  pthread_create(thread, NULL, producer, NULL);
+}
+
+// Read the level every period, like the old button example
+static void bench_polling(const char *name, unsigned period_us) {
+  result_t result = {.last = pin.level};
+  pthread_t thread;
+  start_producer(&thread);
+
+  while (!atomic_load(&pin.done)) {
+    usleep(period_us);
+    result.wakeups++;
+    record_level(&result);
+  }
+
+  pthread_join(thread, NULL);
+  report(name, &result);
+}
+
+static void on_edge(uni_loop_source_t *source, void *arg) {
+  (void)source;
+  record_level(arg);
+}
+
+// Sleep in the loop until the line reports an edge
+static void bench_loop(void) {
+  result_t result = {.last = pin.level};
+  uni_loop_t loop;
+  uni_loop_source_t source;
+
+  if (!uni_loop_init(&loop) ||
+      !uni_loop_add_gpio(&loop, &source, &pin.input, on_edge, &result)) {
+    printf("Failed to initialize event loop\n");
+    return;
+  }
+
+  pthread_t thread;
+  start_producer(&thread);
+
+  // The timeout only lets the loop notice the producer finishing
+  while (!atomic_load(&pin.done))
+    uni_loop_run_once(&loop, 100);
+
+  result.wakeups = loop.stats.wakeups;
+  uni_loop_remove(&source);
+  uni_loop_deinit(&loop);
+  pthread_join(thread, NULL);
+  report("uni_loop", &result);
+}
+
+int main(int argc, char **argv) {
+  if (!setup_pins(argc, argv)) {
+    printf("Failed to initialize GPIO\n");
+    return 1;
+  }
+
+  printf("Edge wakeup benchmark (%d edges, %d ms apart, %s)\n", EDGES,
+         EDGE_INTERVAL_US / 1000, pin.pull_path ? "gpio-sim" : "loopback");
+
+  bench_polling("poll 10 ms", 10000);
+  bench_polling("poll 1 ms", 1000);
+  bench_loop();
+
+  teardown_pins();
+  return 0;
+}
@@ -0,0 +1,73 @@
+#include "hal/gpio.h"
+#include "mocks/gpio_mock.h"
+#include <stdio.h>
+#include <time.h>
+
+#define ITERATIONS 10000000UL
+
+#ifdef UNI_LIB_STATIC_DISPATCH
+#define DISPATCH_MODE "static"
+#else
+#define DISPATCH_MODE "dynamic"
+#endif
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void report(const char *name, double start_ns) {
+  double elapsed = now_ns() - start_ns;
+  printf("  %-10s %8.2f ns/call\n", name, elapsed / ITERATIONS);
+}
+
+int main(void) {
+  gpio_handle_t gpio;
+  gpio_config_t config = {.pin = 1, .is_output = true, .active_high = true};
+
+  if (!gpio_mock_driver.create(&gpio) || !gpio_init(&gpio, &config)) {
+    printf("Failed to initialize GPIO\n");
+    return 1;
+  }
+
+  printf("GPIO dispatch benchmark (%s dispatch, mock backend)\n",
+         DISPATCH_MODE);
+  printf("  handle     %8zu bytes\n", sizeof(gpio_handle_t));
+
+  // Results feed a volatile sink so the calls cannot be dropped
+  volatile unsigned sink = 0;
+
+  double start = now_ns();
+  for (unsigned long i = 0; i < ITERATIONS; i++)
+    gpio_write(&gpio, i & 1);
+  report("write", start);
+
+#ifndef UNI_LIB_STATIC_DISPATCH
+  // Method copy in the handle, as called before the ops table existed
+  start = now_ns();
+  for (unsigned long i = 0; i < ITERATIONS; i++)
+    gpio.write(&gpio, i & 1);
+  report("write (m)", start);
+#endif
+
+  start = now_ns();
+  for (unsigned long i = 0; i < ITERATIONS; i++)
+    sink += gpio_read(&gpio);
+  report("read", start);
+
+  start = now_ns();
+  for (unsigned long i = 0; i < ITERATIONS; i++)
+    gpio_toggle(&gpio);
+  report("toggle", start);
+
+  start = now_ns();
+  for (unsigned long i = 0; i < ITERATIONS; i++)
+    sink += gpio_is_active(&gpio);
+  report("is_active", start);
+
+  gpio_mock_driver.destroy(&gpio);
+  (void)sink;
+
+  return 0;
+}
@@ -0,0 +1,172 @@
+#include "hal/gpio.h"
+#include "hal/soft_i2c.h"
+#include "hal/soft_spi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifdef BENCH_SOFT_BUS_LINUX
+#include "hal/gpio_linux.h"
+#define BACKEND "linux_gpio"
+#else
+#include "mocks/gpio_mock.h"
+#define BACKEND "mock"
+#endif
+
+#ifdef UNI_LIB_STATIC_DISPATCH
+#define DISPATCH_MODE "static"
+#else
+#define DISPATCH_MODE "dynamic"
+#endif
+
+#define TOGGLES 1000000UL
+#define SPI_BYTES 4096
+#define I2C_PROBES 20000
+
+enum { PIN_SCK, PIN_MOSI, PIN_SCL, PIN_SDA, NUM_PINS };
+
+static gpio_handle_t pins[NUM_PINS];
+static uint8_t buffer[SPI_BYTES];
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+#ifdef BENCH_SOFT_BUS_LINUX
+static linux_gpio_line_t lines[NUM_PINS];
+
+// Four consecutive lines from offset: SCK, MOSI, SCL, SDA
+static bool setup_pins(int argc, char **argv) {
+  if (argc < 3) {
+    printf("usage: %s <chip> <first offset>\n", argv[0]);
+    return false;
+  }
+  for (int i = 0; i < NUM_PINS; i++) {
+    lines[i].chip = argv[1];
+    lines[i].offset = (uint32_t)strtoul(argv[2], NULL, 0) + i;
+    gpio_config_t config = {.is_output = true,
+                            .active_high = true,
+                            .open_drain = i >= PIN_SCL,
+                            .platform_specific = &lines[i]};
+    if (!linux_gpio_driver.create(&pins[i]) || !gpio_init(&pins[i], &config))
+      return false;
+  }
+  return true;
+}
+
+static void teardown_pins(void) {
+  for (int i = 0; i < NUM_PINS; i++) {
+    gpio_deinit(&pins[i]);
+    linux_gpio_driver.destroy(&pins[i]);
+  }
+}
+
+static bool attach_bank(gpio_bank_t *bank) {
+  (void)bank; // Generic bank path, one pin write per changed bit
+  return true;
+}
+#else
+static bool setup_pins(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  for (int i = 0; i < NUM_PINS; i++) {
+    gpio_config_t config = {.pin = i, .is_output = true, .active_high = true};
+    if (!gpio_mock_driver.create(&pins[i]) || !gpio_init(&pins[i], &config))
+      return false;
+  }
+  return true;
+}
+
+static void teardown_pins(void) {
+  for (int i = 0; i < NUM_PINS; i++)
+    gpio_mock_driver.destroy(&pins[i]);
+}
+
+static bool attach_bank(gpio_bank_t *bank) {
+  return gpio_mock_bank_attach(bank);
+}
+#endif
+
+// Edge time of a plain write loop, the ceiling for any bit-banged bus
+static double bench_toggle(void) {
+  double start = now_ns();
+  for (unsigned long i = 0; i < TOGGLES; i++)
+    gpio_write(&pins[PIN_SCK], i & 1);
+  double edge_ns = (now_ns() - start) / TOGGLES;
+  printf("  %-14s %8.1f ns/edge  %8.2f Mbit/s max (2 edges/bit)\n", "toggle",
+         edge_ns, 1e3 / (2 * edge_ns));
+  return edge_ns;
+}
+
+static void bench_spi(const char *name, uint32_t speed_hz, gpio_bank_t *bank,
+                      double edge_ns) {
+  soft_spi_config_t config = {.sck = &pins[PIN_SCK],
+                              .mosi = &pins[PIN_MOSI],
+                              .speed_hz = speed_hz,
+                              .bank = bank};
+  soft_spi_t bus;
+  if (!soft_spi_init(&bus, &config)) {
+    printf("  %-14s init failed\n", name);
+    return;
+  }
+
+  double start = now_ns();
+  if (!soft_spi_transfer(&bus, 0, buffer, NULL, sizeof(buffer))) {
+    printf("  %-14s transfer failed\n", name);
+    return;
+  }
+  double bit_ns = (now_ns() - start) / (sizeof(buffer) * 8);
+  printf("  %-14s %8.1f ns/bit   %8.2f Mbit/s   %5.1f%% of %s\n", name, bit_ns,
+         1e3 / bit_ns,
+         speed_hz ? 100 * 1e9 / speed_hz / bit_ns : 100 * 2 * edge_ns / bit_ns,
+         speed_hz ? "speed" : "toggle rate");
+}
+
+// Start, address byte with its (missing) ACK, stop: 9 clocks per probe
+static void bench_i2c(const char *name, uint32_t speed_hz) {
+  soft_i2c_config_t config = {
+      .scl = &pins[PIN_SCL], .sda = &pins[PIN_SDA], .speed_hz = speed_hz};
+  soft_i2c_t bus;
+  if (!soft_i2c_init(&bus, &config)) {
+    printf("  %-14s bus not idle (pull-ups?), skipped\n", name);
+    return;
+  }
+
+  double start = now_ns();
+  for (int i = 0; i < I2C_PROBES; i++)
+    soft_i2c_probe(&bus, 0x50);
+  double probe_ns = (now_ns() - start) / I2C_PROBES;
+  printf("  %-14s %8.1f us/probe %8.1f kbit/s (9 clocks + start/stop)\n",
+         name, probe_ns / 1e3, 9e6 / probe_ns);
+}
+
+int main(int argc, char **argv) {
+  if (!setup_pins(argc, argv)) {
+    printf("Failed to initialize GPIO\n");
+    return 1;
+  }
+  for (int i = 0; i < SPI_BYTES; i++)
+    buffer[i] = (uint8_t)(i * 37);
+
+  printf("Soft bus benchmark (%s dispatch, %s backend)\n", DISPATCH_MODE,
+         BACKEND);
+
+  double edge_ns = bench_toggle();
+
+  bench_spi("spi pins", 0, NULL, edge_ns);
+
+  gpio_handle_t *bank_pins[] = {&pins[PIN_SCK], &pins[PIN_MOSI]};
+  gpio_bank_t bank;
+  if (gpio_bank_init(&bank, bank_pins, 2) && attach_bank(&bank))
+    bench_spi("spi bank", 0, &bank, edge_ns);
+
+  bench_spi("spi 1 MHz", 1000000, NULL, edge_ns);
+
+  bench_i2c("i2c", 0);
+  bench_i2c("i2c 400 kHz", 400000);
+
+  teardown_pins();
+  return 0;
+}
@@ -1,11 +1,58 @@
 #include "components/button.h"
-#include <stdio.h>
-#include <unistd.h>
+#include "core/uni_log.h"
+#include "core/uni_loop.h"
+#include "queue.h"
+#include <signal.h>
+
+static uni_loop_t loop;
+
+static void on_signal(int sig) {
+    (void)sig;
+    uni_loop_stop(&loop);
+}
+
+// Edge on the button pin: let the button start its debounce
+static void on_edge(uni_loop_source_t *source, void *arg) {
+    (void)source;
+    button_handle_t *button = arg;
+    button_event_t ignored;
+    button->process(button, &ignored);
+}
+
+static void print_event(button_event_t event) {
+    switch (event) {
+        case BUTTON_EVENT_PRESSED:
+            UNI_LOG_INFO("Button pressed");
+            break;
+        case BUTTON_EVENT_RELEASED:
+            UNI_LOG_INFO("Button released");
+            break;
+        case BUTTON_EVENT_CLICKED:
+            UNI_LOG_INFO("Button clicked");
+            break;
+        case BUTTON_EVENT_HELD:
+            UNI_LOG_INFO("Button held");
+            break;
+        case BUTTON_EVENT_REPEAT:
+            UNI_LOG_INFO("Button repeat");
+            break;
+    }
+}
 
 int main(void) {
+    // The loop drives the timer service, so it comes before the button
+    if (!uni_loop_init(&loop)) {
+        UNI_LOG_ERROR("Failed to initialize event loop");
+        return -1;
+    }
+
     // Create button instance
     button_handle_t button;
     button_driver.create(&button);
+    linux_gpio_driver.create(&button.gpio);
+
+    // Debounce and hold timeouts report through the queue
+    QueueHandle_t events = xQueueCreate(16, sizeof(button_event_t));
 
     // Configure button
     button_config_t config = {
@@ -18,43 +65,56 @@ int main(void) {
         },
         .debounce_ms = 50,           // 50ms debounce
         .long_press_ms = 1000,       // 1 second for long press
-        .pull_up = true              // Using pull-up resistor
+        .repeat_ms = 250,            // Repeat every 250ms while held
+        .pull_up = true,             // Using pull-up resistor
+        .event_queue = events,
     };
 
     // Initialize button
-    if (!button.init(&button, &config)) {
-        printf("Failed to initialize button\n");
+    if (!events || !button.init(&button, &config)) {
+        UNI_LOG_ERROR("Failed to initialize button");
+        return -1;
+    }
+
+    // Wake on both edges instead of polling the pin
+    uni_loop_source_t edge;
+    if (!uni_loop_add_gpio(&loop, &edge, &button.gpio, on_edge, &button)) {
+        UNI_LOG_ERROR("Failed to watch button edges");
         return -1;
     }
 
-    printf("Button example started. Press Ctrl+C to exit.\n");
-    printf("Short press for click, long press (>1s) for hold.\n");
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    UNI_LOG_INFO("Button example started. Press Ctrl+C to exit.");
+    UNI_LOG_INFO("Short press for click, long press (>1s) for hold.");
+
+    // Main loop: sleeps until an edge or a button timeout
+    atomic_store(&loop.running, true);
+    while (atomic_load(&loop.running)) {
+        if (uni_loop_run_once(&loop, -1) < 0) {
+            break;
+        }
 
-    // Main loop
-    while (1) {
         button_event_t event;
-        if (button.process(&button, &event)) {
-            switch (event) {
-                case BUTTON_EVENT_PRESSED:
-                    printf("Button pressed\n");
-                    break;
-                case BUTTON_EVENT_RELEASED:
-                    printf("Button released\n");
-                    break;
-                case BUTTON_EVENT_CLICKED:
-                    printf("Button clicked\n");
-                    break;
-                case BUTTON_EVENT_HELD:
-                    printf("Button held\n");
-                    break;
-            }
+        while (xQueueReceive(events, &event, 0) == pdTRUE) {
+            print_event(event);
         }
-        usleep(10000); // 10ms sleep to prevent busy waiting
+
+        // No scheduler runs the drain task here; write out between waits
+        uni_log_flush();
     }
 
+    UNI_LOG_INFO("Loop woke %llu times",
+                 (unsigned long long)loop.stats.wakeups);
+
     // Cleanup
+    uni_loop_remove(&edge);
     button.deinit(&button);
     button_driver.destroy(&button);
+    linux_gpio_driver.destroy(&button.gpio);
+    vQueueDelete(events);
+    uni_loop_deinit(&loop);
 
     return 0;
 }
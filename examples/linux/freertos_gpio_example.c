@@ -1,8 +1,13 @@
 #include "FreeRTOS.h"
 #include "config/linux_config.h"
+#include "core/rt_profile.h"
+#include "core/uni_log.h"
 #include "hal/gpio.h"
+#include "hal/hal_worker.h"
 #include "task.h"
+#include <errno.h>
 #include <stdio.h>
+#include <string.h>
 
 // Task handles
 static TaskHandle_t led_task_handle = NULL;
@@ -18,29 +23,46 @@ void vLedControlTask(void *pvParameters) {
                           .platform_specific = NULL};
 
   // Initialize GPIO
-  if (!gpio.init(&gpio, &config)) {
-    printf("Failed to initialize GPIO\n");
+  if (!gpio_init(&gpio, &config)) {
+    UNI_LOG_ERROR("Failed to initialize GPIO");
     vTaskDelete(NULL);
     return;
   }
 
   while (1) {
-    gpio.write(&gpio, true);
-    printf("LED ON\n");
+    gpio_write(&gpio, true);
+    UNI_LOG_INFO("LED ON");
     vTaskDelay(pdMS_TO_TICKS(1000));
 
-    gpio.write(&gpio, false);
-    printf("LED OFF\n");
+    gpio_write(&gpio, false);
+    UNI_LOG_INFO("LED OFF");
     vTaskDelay(pdMS_TO_TICKS(1000));
   }
 }
 
-int main(void) {
-  printf("FreeRTOS GPIO Example\n");
+int main(int argc, char **argv) {
+  // --rt: lock memory and run the tasks under SCHED_FIFO. Applied before
+  // the log drain task exists, so every task thread inherits it.
+  if (argc > 1 && strcmp(argv[1], "--rt") == 0 && !rt_profile_apply(NULL)) {
+    fprintf(stderr, "Failed to apply the RT profile: %s\n", strerror(errno));
+    return -1;
+  }
+
+  // Messages drain from a low-priority task instead of blocking the LED task
+  if (!uni_log_start(NULL)) {
+    return -1;
+  }
+  UNI_LOG_INFO("FreeRTOS GPIO Example");
 
   // Create GPIO handle
   if (!linux_gpio_driver.create(&gpio)) {
-    printf("Failed to create GPIO handle\n");
+    UNI_LOG_ERROR("Failed to create GPIO handle");
+    return -1;
+  }
+
+  // Run blocking sysfs I/O off the scheduler
+  if (!hal_worker_start(2)) {
+    UNI_LOG_ERROR("Failed to start HAL worker pool");
     return -1;
   }
 
@@ -50,15 +72,15 @@ int main(void) {
                   NULL, tskIDLE_PRIORITY + 1, &led_task_handle);
 
   if (result != pdPASS) {
-    printf("Failed to create LED task\n");
+    UNI_LOG_ERROR("Failed to create LED task");
     return -1;
   }
 
   // Start the scheduler
-  printf("Starting FreeRTOS scheduler\n");
+  UNI_LOG_INFO("Starting FreeRTOS scheduler");
   vTaskStartScheduler();
 
   // Should never reach here
-  printf("Scheduler ended unexpectedly\n");
+  UNI_LOG_ERROR("Scheduler ended unexpectedly");
   return 0;
 }
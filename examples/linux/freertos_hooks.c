@@ -1,10 +1,14 @@
 #include "FreeRTOS.h"
+#include "core/rt_profile.h"
+#include "core/uni_log.h"
+#include "hal/hal_worker.h"
 #include "task.h"
-#include <stdio.h>
 
 // FreeRTOS Assert Hook
 void vAssertCalled(const char *pcFile, uint32_t ulLine) {
-  printf("ASSERT failed! File: %s, Line: %lu\n", pcFile, (unsigned long)ulLine);
+  UNI_LOG_ERROR("ASSERT failed! File: %s, Line: %lu", pcFile,
+                (unsigned long)ulLine);
+  uni_log_flush();
   taskDISABLE_INTERRUPTS();
   for (;;) {
     /* hang here */
@@ -34,3 +38,9 @@ void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
   *ppxTimerTaskStackBuffer = uxTimerTaskStack;
   *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
 }
+
+// Tick Hook: wakes tasks whose HAL calls completed on the worker pool
+void vApplicationTickHook(void) { hal_worker_tick_hook(); }
+
+// Idle Hook: under the real-time profile, sleep instead of spinning
+void vApplicationIdleHook(void) { rt_profile_idle_hook(); }
@@ -1,11 +1,13 @@
 #ifndef UNI_LIB_BUTTON_H
 #define UNI_LIB_BUTTON_H
 
+#include "components/event_sink.h"
+#include "core/timer_service.h"
 #include "hal/gpio.h"
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
-#include "timers.h"
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -17,6 +19,7 @@ typedef enum {
     BUTTON_EVENT_RELEASED,
     BUTTON_EVENT_CLICKED,
     BUTTON_EVENT_HELD,
+    BUTTON_EVENT_REPEAT,
 } button_event_t;
 
 /**
@@ -26,28 +29,54 @@ typedef struct {
     gpio_config_t gpio_config;
     uint32_t debounce_ms;     // Debounce time in milliseconds
     uint32_t long_press_ms;   // Time threshold for long press detection
+    uint32_t repeat_ms;       // REPEAT period while held past long_press_ms (0: off)
     bool pull_up;             // true: pull-up (active low), false: pull-down (active high)
     QueueHandle_t event_queue; // Queue to send button events (optional)
+    event_policy_t overflow_policy; // When the queue is full (default: drop newest)
 } button_config_t;
 
 /**
  * Button handle structure following OOP pattern
+ *
+ * Debounce, long press and repeat run on timeouts of the shared timer
+ * service, started by init. Releases (CLICKED, HELD) never displace queued
+ * events; on a full queue the debounce timeout waits briefly for the
+ * consumer (see event_sink_t). Lost events are counted in events.
+ *
+ * process() may be called from several tasks at once: only the debounce
+ * timeout changes the state, and only the caller that claims is_debouncing
+ * arms it, so each press produces its events once. Like timeout_arm(), it
+ * must not be called from native threads or interrupts.
+ *
+ * If the kernel or hardware filters the pin for at least debounce_ms (set
+ * gpio_config.debounce_us, see gpio_debounce_in_hw()), process() skips the
+ * debounce timeout and handles a change of level right away. A pin the
+ * driver filters keeps the debounce timeout, and since its edges are raw,
+ * each process() call that sees no change also arms a settle timeout that
+ * reads the pin again once the filter can have caught up.
  */
 typedef struct button_handle {
     // Hardware
     gpio_handle_t gpio;
-    TimerHandle_t debounce_timer;
+    timeout_t debounce;
+    timeout_t settle;           // Re-read of a driver filtered pin
+    timeout_t hold;             // Long press, then repeat
     QueueHandle_t event_queue;
+    event_sink_t events;
 
     // Configuration
     uint32_t debounce_ms;
     uint32_t long_press_ms;
+    uint32_t repeat_ms;
+    bool pin_debounced;         // The pin filters for debounce_ms in hardware
+    TickType_t settle_ticks;    // Driver filter period, rounded up (0: none)
 
-    // State
-    TickType_t press_start_tick;
-    bool last_state;
-    bool is_pressed;
-    bool is_debouncing;
+    // State, shared by the timer service and the tasks calling process()
+    _Atomic TickType_t press_start_tick;
+    atomic_bool last_state;
+    atomic_bool is_pressed;
+    atomic_bool is_held;
+    atomic_bool is_debouncing;
 
     // Methods
     bool (*init)(struct button_handle *self, const button_config_t *config);
@@ -0,0 +1,89 @@
+#ifndef UNI_LIB_ENCODER_H
+#define UNI_LIB_ENCODER_H
+
+#include "components/event_sink.h"
+#include "hal/gpio.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Encoder event types
+ */
+typedef enum {
+    ENCODER_EVENT_CW,   // One detent clockwise (A leads B)
+    ENCODER_EVENT_CCW,  // One detent counter-clockwise (B leads A)
+} encoder_event_t;
+
+/**
+ * Encoder configuration structure
+ */
+typedef struct {
+    gpio_config_t gpio_a;
+    gpio_config_t gpio_b;
+    uint8_t steps_per_detent;   // Quadrature steps per event (0 or 1: every step)
+    uint32_t velocity_window_ms; // Averaging window for velocity (0: 100 ms)
+    bool use_interrupts;        // Decode from GPIO edge callbacks (not on Linux)
+    QueueHandle_t event_queue;  // Queue to send encoder events (optional)
+    event_policy_t overflow_policy; // When the queue is full (default: drop newest)
+} encoder_config_t;
+
+/**
+ * Quadrature encoder handle structure following OOP pattern
+ *
+ * Steps are decoded with a 16-entry state table, either from edge callbacks
+ * on both pins or from samples fed by the application (e.g. one
+ * gpio_bank_read() per scan). Backends without edge callbacks fail init
+ * with use_interrupts and errno ENOTSUP; on Linux, call process() when
+ * linux_gpio_edge_fd() of either pin fires instead.
+ *
+ * Decoding must happen in one context at a time; position and error count
+ * may be read from any task or thread, velocity from any task (it takes a
+ * critical section).
+ */
+typedef struct encoder_handle {
+    // Hardware
+    gpio_handle_t gpio_a;
+    gpio_handle_t gpio_b;
+    QueueHandle_t event_queue;
+    event_sink_t events;        // Overflow policy and lost-event counters
+
+    // Configuration
+    uint8_t steps_per_detent;
+    TickType_t velocity_window;
+
+    // Decoder state
+    uint8_t state;              // Last AB sample, A in bit 1
+    int32_t detent_steps;       // Steps not yet reported as an event
+    atomic_int_fast32_t position;
+    atomic_uint_fast32_t errors; // Transitions that skipped a state
+
+    // Velocity, under a critical section
+    int32_t velocity;           // Steps per second over the last window
+    int32_t velocity_position;
+    TickType_t velocity_tick;
+
+    // Methods
+    bool (*init)(struct encoder_handle *self, const encoder_config_t *config);
+    void (*deinit)(struct encoder_handle *self);
+    void (*process)(struct encoder_handle *self);   // Sample both pins and decode
+    void (*update)(struct encoder_handle *self, bool a, bool b); // Decode a sample
+    int32_t (*get_position)(struct encoder_handle *self);
+    int32_t (*get_velocity)(struct encoder_handle *self);
+    void (*reset)(struct encoder_handle *self);
+} encoder_handle_t;
+
+/**
+ * Encoder driver interface
+ */
+typedef struct {
+    bool (*create)(encoder_handle_t *handle);
+    void (*destroy)(encoder_handle_t *handle);
+} encoder_driver_t;
+
+extern const encoder_driver_t encoder_driver;
+
+#endif // UNI_LIB_ENCODER_H
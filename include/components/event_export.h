@@ -0,0 +1,43 @@
+#ifndef UNI_LIB_EVENT_EXPORT_H
+#define UNI_LIB_EVENT_EXPORT_H
+
+#include "core/event_ring.h"
+#include "hal/gpio.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Shared memory event export
+ *
+ * Publishes component events into an event ring (see core/event_ring.h) so
+ * processes outside the simulation can follow them with the reader library
+ * or uni-event-tail. Components export everything they post through their
+ * event sink, whether or not it fits in their queue. Publishing is a few
+ * stores into shared memory plus a futex wake when a reader sleeps, and is
+ * a no-op while the export is stopped.
+ */
+bool event_export_start(const char *name, uint32_t capacity);
+void event_export_stop(void);
+
+// Safe from any task, and from native threads marked with
+// hal_worker_register_native_thread() (see hal/hal_worker.h)
+void event_export_publish(event_kind_t kind, uint16_t source, uint32_t code);
+
+/**
+ * GPIO edge export
+ *
+ * Takes the pin's edge interrupt: each edge publishes an EVENT_KIND_GPIO_EDGE
+ * record with the level read after it, then calls callback(arg) if set. The
+ * tap must stay valid until the interrupt is replaced or the pin deinit.
+ */
+typedef struct {
+    gpio_handle_t *gpio;
+    uint16_t pin;
+    void (*callback)(void *arg);
+    void *arg;
+} event_export_edge_t;
+
+bool event_export_edges(event_export_edge_t *tap, gpio_handle_t *gpio, uint16_t pin,
+                        void (*callback)(void *arg), void *arg);
+
+#endif // UNI_LIB_EVENT_EXPORT_H
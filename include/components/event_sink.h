@@ -0,0 +1,90 @@
+#ifndef UNI_LIB_EVENT_SINK_H
+#define UNI_LIB_EVENT_SINK_H
+
+#include "components/event_export.h"
+#include "FreeRTOS.h"
+#include "queue.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define EVENT_SINK_MAX_ITEM_SIZE 16
+#define EVENT_SINK_MAX_RETRIES 4
+
+// How long a guaranteed post waits for the consumer to free a slot
+#ifndef EVENT_SINK_GUARANTEED_WAIT_MS
+#define EVENT_SINK_GUARANTEED_WAIT_MS 10
+#endif
+
+/**
+ * What to do with an event when the component queue is full
+ */
+typedef enum {
+    EVENT_POLICY_DROP_NEWEST,     // Discard the new event
+    EVENT_POLICY_OVERWRITE_OLDEST, // Discard the oldest queued event
+    EVENT_POLICY_COALESCE,        // Merge repeats of the last queued event,
+                                  // overwrite the oldest on a change
+} event_policy_t;
+
+/**
+ * Counter snapshot
+ *
+ * Every event posted is either sent, dropped, lost or coalesced. Lost
+ * counts guaranteed events (releases) the consumer made no room for in
+ * time; dropped counts the others. Overwritten counts older queued events
+ * this component discarded to make room, so sent - overwritten events
+ * reached the consumer.
+ */
+typedef struct {
+    uint32_t sent;
+    uint32_t dropped;
+    uint32_t overwritten;
+    uint32_t coalesced;
+    uint32_t lost;
+} event_sink_stats_t;
+
+/**
+ * Component side of an event queue
+ *
+ * Applies the overflow policy and counts every loss. Events posted as
+ * guaranteed (releases) never displace queued events, which may be
+ * releases too: on a full queue the posting task waits up to
+ * EVENT_SINK_GUARANTEED_WAIT_MS for the consumer, then counts the event
+ * as lost. Native threads and posts before the scheduler runs do not
+ * wait. The overwrite policies still let other events displace the
+ * oldest queued one, release or not; queues whose releases must arrive
+ * use EVENT_POLICY_DROP_NEWEST. Coalescing compares the caller's key with
+ * the last event this component queued. Counters may be read from any
+ * task.
+ */
+typedef struct {
+    QueueHandle_t queue;
+    event_policy_t policy;
+    size_t item_size;
+    uint32_t last_key;
+    bool has_last;
+    uint16_t export_kind;   // event_kind_t, 0: not exported
+    uint16_t export_source;
+
+    atomic_uint_fast32_t sent;
+    atomic_uint_fast32_t dropped;
+    atomic_uint_fast32_t overwritten;
+    atomic_uint_fast32_t coalesced;
+    atomic_uint_fast32_t lost;
+} event_sink_t;
+
+// A NULL queue gives a sink that discards events without counting them
+bool event_sink_init(event_sink_t *sink, QueueHandle_t queue, size_t item_size,
+                     event_policy_t policy);
+
+// Publish every event posted to the shared memory export, with key as code
+void event_sink_set_export(event_sink_t *sink, event_kind_t kind, uint16_t source);
+
+// Returns true if the event was queued or coalesced
+bool event_sink_post(event_sink_t *sink, const void *event, uint32_t key, bool guaranteed);
+
+void event_sink_get_stats(event_sink_t *sink, event_sink_stats_t *stats);
+void event_sink_reset_stats(event_sink_t *sink);
+
+#endif // UNI_LIB_EVENT_SINK_H
@@ -0,0 +1,90 @@
+#ifndef UNI_LIB_KEYPAD_H
+#define UNI_LIB_KEYPAD_H
+
+#include "components/event_sink.h"
+#include "core/timer_service.h"
+#include "hal/gpio_bank.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define KEYPAD_MAX_ROWS 16
+#define KEYPAD_MAX_COLS 32
+
+/**
+ * Keypad event types
+ */
+typedef enum {
+    KEYPAD_EVENT_PRESSED,
+    KEYPAD_EVENT_RELEASED,
+} keypad_event_type_t;
+
+typedef struct {
+    keypad_event_type_t type;
+    uint16_t key; // row * num_cols + col
+} keypad_event_t;
+
+/**
+ * Keypad configuration structure
+ */
+typedef struct {
+    gpio_bank_t *rows;          // Row drive lines (outputs), bit i = row i
+    gpio_bank_t *cols;          // Column sense lines (inputs), bit i = column i
+    bool active_low;            // true: active row driven low, pressed keys read low
+    uint32_t scan_interval_ms;  // Scan period (0: application calls scan)
+    QueueHandle_t event_queue;  // Queue to send keypad events (optional)
+    event_policy_t overflow_policy; // When the queue is full (default: drop newest)
+} keypad_config_t;
+
+/**
+ * Matrix keypad handle structure following OOP pattern
+ *
+ * Each scan drives one row at a time with a single bank write and samples
+ * all columns with a single bank read; banks without native access fall
+ * back to per-pin calls. The whole matrix is debounced in parallel with
+ * 2-bit vertical counters, so a key changes state after 4 consecutive equal
+ * scans. Any number of keys may be held; when three pressed keys form the
+ * corners of a rectangle the fourth cannot be told from a ghost, and the
+ * keys of that rectangle keep their previous state until it resolves.
+ * Releases are never refused by a full queue; events coalesce per key.
+ */
+typedef struct keypad_handle {
+    // Hardware
+    gpio_bank_t *rows;
+    gpio_bank_t *cols;
+    timeout_t scan_timeout;
+    TickType_t scan_period;
+    QueueHandle_t event_queue;
+    event_sink_t events;        // Overflow policy and lost-event counters
+
+    // Configuration
+    uint8_t num_rows;
+    uint8_t num_cols;
+    bool active_low;
+
+    // State, one word per row and one bit per column
+    uint32_t pressed[KEYPAD_MAX_ROWS];
+    uint32_t count0[KEYPAD_MAX_ROWS]; // Vertical debounce counter, bit 0
+    uint32_t count1[KEYPAD_MAX_ROWS]; // Vertical debounce counter, bit 1
+    uint32_t ghost_scans;             // Scans with an ambiguous key pattern
+
+    // Methods
+    bool (*init)(struct keypad_handle *self, const keypad_config_t *config);
+    void (*deinit)(struct keypad_handle *self);
+    bool (*scan)(struct keypad_handle *self);
+    bool (*is_pressed)(struct keypad_handle *self, uint16_t key);
+} keypad_handle_t;
+
+/**
+ * Keypad driver interface
+ */
+typedef struct {
+    bool (*create)(keypad_handle_t *handle);
+    void (*destroy)(keypad_handle_t *handle);
+} keypad_driver_t;
+
+extern const keypad_driver_t keypad_driver;
+
+#endif // UNI_LIB_KEYPAD_H
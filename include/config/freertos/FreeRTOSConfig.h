@@ -34,8 +34,8 @@
 #define configAPPLICATION_ALLOCATED_HEAP 0
 
 /* Hook function related definitions. */
-#define configUSE_IDLE_HOOK 0
-#define configUSE_TICK_HOOK 0
+#define configUSE_IDLE_HOOK 1 /* Sleeps under the real-time profile */
+#define configUSE_TICK_HOOK 1 /* Drives HAL worker completions */
 #define configCHECK_FOR_STACK_OVERFLOW 0
 #define configUSE_MALLOC_FAILED_HOOK 0
 #define configUSE_DAEMON_TASK_STARTUP_HOOK 0
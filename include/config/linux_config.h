@@ -4,6 +4,21 @@
 // GPIO Configuration
 #define GPIO_MAX_PINS 64
 #define GPIO_INTERRUPT_SUPPORT 1
+#define GPIO_EXPORT_TIMEOUT_MS 1000 // Wait for udev to set up exported pins
+#define GPIO_EXPORT_POLL_US 1000
+
+// HAL Worker Configuration
+#define HAL_WORKER_MAX_THREADS 8
+#define HAL_WORKER_NOTIFY_INDEX 1 // Task notification slot used for completion
+
+// Real-time Profile Configuration (rt_profile_apply)
+#define RT_LOCK_MEMORY 1
+#define RT_HEAP_RESERVE_BYTES (1024 * 1024) // Task stacks, queues and buffers
+#define RT_STACK_PREFAULT_BYTES (64 * 1024) // Stack of the thread calling main
+#define RT_SCHED_PRIORITY 80                // SCHED_FIFO priority of the tasks
+#define RT_SCHED_CPUS 0x0                   // Task CPU mask, 0 for any
+#define RT_HAL_WORKER_PRIORITY 70           // Below the tasks, above the rest
+#define RT_HAL_WORKER_CPUS 0x0
 
 // I2C Configuration
 #define I2C_MAX_DEVICES 2
@@ -20,5 +35,9 @@
 // Debug Configuration
 #define DEBUG_ENABLE 1
 #define DEBUG_UART "/dev/ttyUSB0"
+#define LOG_MAX_RINGS 8        // Per-task message rings, the first one shared
+#define LOG_RING_SLOTS 64      // Messages per ring, a power of two
+#define LOG_TLS_INDEX 0        // Thread local storage slot holding a task's ring
+#define LOG_DRAIN_PERIOD_MS 10 // Drain task sleep between passes
 
 #endif // UNI_LIB_LINUX_CONFIG_H
@@ -0,0 +1,102 @@
+#ifndef UNI_LIB_EVENT_RING_H
+#define UNI_LIB_EVENT_RING_H
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define EVENT_RING_MAGIC 0x52494e55u // "UNIR"
+#define EVENT_RING_VERSION 1
+#define EVENT_RING_DEFAULT_NAME "/uni-lib-events"
+
+/**
+ * Event record sources
+ */
+typedef enum {
+  EVENT_KIND_GPIO_EDGE = 1, // source: pin, code: level
+  EVENT_KIND_BUTTON,        // source: pin, code: button_event_t
+  EVENT_KIND_ENCODER,       // source: pin A, code: encoder_event_t
+  EVENT_KIND_KEYPAD,        // source: 0, code: type << 16 | key
+} event_kind_t;
+
+/**
+ * Event record as seen by readers
+ */
+typedef struct {
+  uint64_t seq;     // Position in the stream, consecutive from 0
+  uint64_t time_ns; // CLOCK_MONOTONIC at publication
+  uint16_t kind;    // event_kind_t
+  uint16_t source;
+  uint32_t code;
+} event_record_t;
+
+// Ring slot, a per-slot seqlock around the record payload
+typedef struct {
+  atomic_uint_fast64_t lock; // 2 * seq + 1 while writing, 2 * seq + 2 after
+  atomic_uint_fast64_t time_ns;
+  atomic_uint_fast64_t data; // kind << 48 | source << 32 | code
+} event_ring_slot_t;
+
+/**
+ * Shared memory layout
+ *
+ * One producer appends records; any number of readers in other processes
+ * follow it without locks or syscalls. A reader that falls more than a ring
+ * behind skips ahead and counts the records it lost. Idle readers sleep on
+ * a futex which the producer only wakes when someone is waiting.
+ */
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t capacity; // Slots, a power of two
+  uint32_t reserved;
+
+  alignas(64) atomic_uint_fast64_t head; // Next sequence number
+  alignas(64) atomic_uint waiters;       // Readers sleeping on wake_seq
+  atomic_uint wake_seq;                  // Futex word
+
+  alignas(64) event_ring_slot_t slots[];
+} event_ring_t;
+
+/**
+ * Producer side, creates and owns the shared memory object
+ *
+ * Publishing must be serialized by the caller.
+ */
+typedef struct {
+  event_ring_t *ring;
+  size_t map_size;
+  char name[64];
+} event_ring_writer_t;
+
+// name is a POSIX shared memory name such as "/uni-lib-events"
+bool event_ring_writer_create(event_ring_writer_t *writer, const char *name,
+                              uint32_t capacity);
+void event_ring_writer_destroy(event_ring_writer_t *writer);
+void event_ring_publish(event_ring_writer_t *writer, uint16_t kind,
+                        uint16_t source, uint32_t code);
+
+/**
+ * Reader side, one per consumer
+ */
+typedef struct {
+  event_ring_t *ring;
+  size_t map_size;
+  uint64_t next; // Next sequence number to read
+  uint64_t lost; // Records overwritten before they were read
+} event_ring_reader_t;
+
+// Start at the oldest record still in the ring, or at the newest with tail
+bool event_ring_reader_open(event_ring_reader_t *reader, const char *name,
+                            bool tail);
+void event_ring_reader_close(event_ring_reader_t *reader);
+
+// Copy the next record, false if the reader has caught up
+bool event_ring_read(event_ring_reader_t *reader, event_record_t *record);
+
+// Sleep until a record is available, false on timeout (-1: forever)
+bool event_ring_wait(event_ring_reader_t *reader, int timeout_ms);
+
+#endif // UNI_LIB_EVENT_RING_H
@@ -0,0 +1,55 @@
+#ifndef UNI_LIB_RT_PROFILE_H
+#define UNI_LIB_RT_PROFILE_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Scheduling of a group of threads
+ */
+typedef struct {
+  int priority;  // SCHED_FIFO priority, 0 keeps the default policy
+  uint32_t cpus; // CPU affinity mask, 0 for any CPU
+} rt_thread_config_t;
+
+/**
+ * Real-time profile configuration
+ */
+typedef struct {
+  bool lock_memory;             // mlockall() current and future pages
+  size_t heap_reserve;          // Heap bytes prefaulted and never trimmed
+  size_t stack_prefault;        // Stack bytes of the calling thread prefaulted
+  rt_thread_config_t scheduler; // Calling thread and tasks created after it
+  rt_thread_config_t hal_worker;
+} rt_profile_config_t;
+
+/**
+ * Real-time execution profile for the Linux build
+ *
+ * Under the default policy, page faults and other processes add milliseconds
+ * of jitter to FreeRTOS delays. rt_profile_apply() locks the process memory,
+ * prefaults the heap that task stacks and queues are allocated from, and
+ * moves the calling thread to SCHED_FIFO on the configured CPUs. The POSIX
+ * port creates a thread per task, plus its tick thread, from the thread
+ * creating the task, and they inherit its policy and affinity; the HAL
+ * worker pool gets its own (hal_worker_set_sched()).
+ *
+ * Call it from main() before creating any task and before starting the
+ * scheduler. NULL applies the RT_* defaults of linux_config.h. Needs
+ * CAP_SYS_NICE and CAP_IPC_LOCK (or matching rlimits); on failure errno is
+ * set and the steps done so far stay applied.
+ */
+bool rt_profile_apply(const rt_profile_config_t *config);
+
+// Move one thread to the given policy and CPUs
+bool rt_profile_apply_thread(pthread_t thread,
+                             const rt_thread_config_t *config);
+
+// Call from vApplicationIdleHook(). Once the profile runs the tasks under
+// SCHED_FIFO, a spinning idle task would starve the rest of its CPU, so
+// the hook sleeps for a tick; otherwise it returns at once.
+void rt_profile_idle_hook(void);
+
+#endif // UNI_LIB_RT_PROFILE_H
@@ -0,0 +1,98 @@
+#ifndef UNI_LIB_TIMER_SERVICE_H
+#define UNI_LIB_TIMER_SERVICE_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1u << TIMER_WHEEL_BITS)
+
+#ifndef TIMER_SERVICE_PRIORITY
+#define TIMER_SERVICE_PRIORITY configTIMER_TASK_PRIORITY
+#endif
+
+#ifndef TIMER_SERVICE_STACK_DEPTH
+#define TIMER_SERVICE_STACK_DEPTH configTIMER_TASK_STACK_DEPTH
+#endif
+
+typedef void (*timeout_callback_t)(void *arg);
+
+/**
+ * Timeout owned by a component, linked into the wheel while armed
+ */
+typedef struct timeout {
+  struct timeout *next;
+  struct timeout **pprev; // NULL while disarmed
+  TickType_t expires;
+  uint8_t level; // Wheel level, TIMER_WHEEL_LEVELS once due
+  uint8_t slot;
+  timeout_callback_t callback;
+  void *arg;
+} timeout_t;
+
+/**
+ * Timer service
+ *
+ * All component timeouts share one hierarchical timing wheel: 4 levels of
+ * 64 slots, each level 64 times coarser than the one below. Arming links
+ * the timeout into a slot and cancelling unlinks it, both O(1) with no
+ * allocation and no command queue, so thousands of timeouts can be in
+ * flight at once. Timeouts further out than a level's span wait in a
+ * coarser slot and cascade down as the wheel turns.
+ *
+ * A single task drives the wheel from the RTOS tick. It sleeps until the
+ * next occupied slot or cascade, then runs every timeout that came due in
+ * one pass. Callbacks run in that task and may arm or cancel timeouts,
+ * including their own; they must not block.
+ *
+ * Without the task (timer_service_start() not called) the wheel only moves
+ * when timer_service_advance() is called, and arm delays count from the
+ * last tick passed to it; tests use this to step time deterministically.
+ * An event loop can take the task's place with timer_service_set_clock():
+ * it sleeps for timer_service_next(), then calls timer_service_advance().
+ *
+ * Arm and cancel may be called from any task but not from interrupts.
+ * Cancelling does not wait for a callback that is already running.
+ */
+bool timer_service_start(void);
+void timer_service_stop(void);
+
+/**
+ * External driver of the wheel. wake() is called when a timeout is armed
+ * earlier than the delay last returned by timer_service_next() (optional).
+ */
+typedef struct {
+  TickType_t (*now)(void *arg);
+  void (*wake)(void *arg);
+  void *arg;
+} timer_service_clock_t;
+
+// Fails while the task runs or another clock is set; NULL detaches
+bool timer_service_set_clock(const timer_service_clock_t *clock);
+
+// Ticks until the wheel next has work; false if nothing is armed
+bool timer_service_next(TickType_t *delay);
+
+// Run every timeout due up to now, in expiry order tick by tick
+void timer_service_advance(TickType_t now);
+
+// Tick the wheel counts delays from
+TickType_t timer_service_now(void);
+
+// Number of armed timeouts
+uint32_t timer_service_armed(void);
+
+void timeout_init(timeout_t *timeout, timeout_callback_t callback, void *arg);
+
+// Fire callback(arg) after delay ticks (at least one); re-arming moves it
+void timeout_arm(timeout_t *timeout, TickType_t delay);
+
+// Returns true if the timeout was armed
+bool timeout_cancel(timeout_t *timeout);
+
+bool timeout_is_armed(const timeout_t *timeout);
+
+#endif // UNI_LIB_TIMER_SERVICE_H
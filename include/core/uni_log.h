@@ -0,0 +1,191 @@
+#ifndef UNI_LIB_UNI_LOG_H
+#define UNI_LIB_UNI_LOG_H
+
+#include "config/linux_config.h"
+#include "core/uni_log_format.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Lowest level compiled in; calls below it generate no code
+#ifndef UNI_LOG_LEVEL
+#if DEBUG_ENABLE
+#define UNI_LOG_LEVEL UNI_LOG_LEVEL_DEBUG
+#else
+#define UNI_LOG_LEVEL UNI_LOG_LEVEL_INFO
+#endif
+#endif
+
+#ifndef UNI_LOG_DRAIN_PRIORITY
+#define UNI_LOG_DRAIN_PRIORITY (tskIDLE_PRIORITY + 1)
+#endif
+
+#ifndef UNI_LOG_DRAIN_STACK_DEPTH
+#define UNI_LOG_DRAIN_STACK_DEPTH (configMINIMAL_STACK_SIZE * 4)
+#endif
+
+/**
+ * Call site of a log statement, one static instance per site
+ */
+typedef struct {
+  uint8_t level;
+  const char *fmt;
+  _Atomic uint32_t id; // Binary log session << 16 | format id
+} uni_log_site_t;
+
+typedef enum {
+  UNI_LOG_SINK_STDOUT,
+  UNI_LOG_SINK_FILE,
+  UNI_LOG_SINK_UART,
+} uni_log_sink_t;
+
+/**
+ * Drain configuration
+ */
+typedef struct {
+  uni_log_sink_t sink;
+  const char *path;   // File, or serial device (default DEBUG_UART)
+  uint32_t baud_rate; // Serial only (default 115200)
+  bool binary;        // Write records for the host decoder instead of text
+} uni_log_config_t;
+
+/**
+ * Deferred logging
+ *
+ * UNI_LOG_INFO("pin %u at %d", pin, level) records the call site and the raw
+ * arguments into a lock-free ring of the calling task; no formatting and no
+ * I/O happen at the call. A low-priority drain task formats the messages in
+ * order and writes them to stdout, a file or the DEBUG_UART serial device,
+ * as text or as binary records for tools/uni_log_decode.
+ *
+ * Formats must be string literals with at most UNI_LOG_MAX_ARGS arguments.
+ * Arguments are converted by type, so %s arguments are kept as pointers and
+ * must stay valid until drained (literals, task names). A full ring drops
+ * the new message and counts it. Logging is safe from tasks, native
+ * threads and the tick hook; before the scheduler runs, and once every ring
+ * is taken, callers share one ring. A task keeps its ring after it is
+ * deleted, so tasks created and deleted at run time use up the
+ * LOG_MAX_RINGS - 1 private rings and later ones share.
+ *
+ * Without uni_log_start() nothing drains on its own; uni_log_flush() writes
+ * pending messages to stdout as text, and runs at exit.
+ */
+bool uni_log_start(const uni_log_config_t *config);
+void uni_log_stop(void);
+
+// Drain every pending message now, on the calling task
+void uni_log_flush(void);
+
+// Messages dropped on full rings since start
+uint32_t uni_log_dropped(void);
+
+void uni_log_write(uni_log_site_t *site, const uni_log_arg_t *args,
+                   uint8_t count);
+
+static inline uni_log_arg_t uni_log_arg_int(int64_t value) {
+  uni_log_arg_t arg = {.i = value};
+  return arg;
+}
+
+static inline uni_log_arg_t uni_log_arg_uint(uint64_t value) {
+  uni_log_arg_t arg = {.u = value};
+  return arg;
+}
+
+static inline uni_log_arg_t uni_log_arg_double(double value) {
+  uni_log_arg_t arg = {.d = value};
+  return arg;
+}
+
+static inline uni_log_arg_t uni_log_arg_pointer(const void *value) {
+  uni_log_arg_t arg = {.p = value};
+  return arg;
+}
+
+// Format checking only, never called
+static inline void uni_log_check(const char *fmt, ...)
+    __attribute__((format(printf, 1, 2)));
+static inline void uni_log_check(const char *fmt, ...) { (void)fmt; }
+
+#define UNI_LOG_ARG(x)                                                         \
+  _Generic((x),                                                                \
+      float: uni_log_arg_double,                                               \
+      double: uni_log_arg_double,                                              \
+      long double: uni_log_arg_double,                                         \
+      char: uni_log_arg_int,                                                   \
+      signed char: uni_log_arg_int,                                            \
+      short: uni_log_arg_int,                                                  \
+      int: uni_log_arg_int,                                                    \
+      long: uni_log_arg_int,                                                   \
+      long long: uni_log_arg_int,                                              \
+      _Bool: uni_log_arg_uint,                                                 \
+      unsigned char: uni_log_arg_uint,                                         \
+      unsigned short: uni_log_arg_uint,                                        \
+      unsigned: uni_log_arg_uint,                                              \
+      unsigned long: uni_log_arg_uint,                                         \
+      unsigned long long: uni_log_arg_uint,                                    \
+      default: uni_log_arg_pointer)(x)
+
+// Argument list helpers: the format counts as the first argument
+#define UNI_LOG_COUNT(...)                                                     \
+  UNI_LOG_COUNT_(__VA_ARGS__, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define UNI_LOG_COUNT_(_1, _2, _3, _4, _5, _6, _7, _8, _9, n, ...) n
+#define UNI_LOG_FIRST(...) UNI_LOG_FIRST_(__VA_ARGS__, ~)
+#define UNI_LOG_FIRST_(first, ...) first
+#define UNI_LOG_CAT(a, b) UNI_LOG_CAT_(a, b)
+#define UNI_LOG_CAT_(a, b) a##b
+#define UNI_LOG_ARGS(...)                                                      \
+  UNI_LOG_CAT(UNI_LOG_ARGS_, UNI_LOG_COUNT(__VA_ARGS__))(__VA_ARGS__)
+#define UNI_LOG_ARGS_1(a) UNI_LOG_ARG(a)
+#define UNI_LOG_ARGS_2(a, ...) UNI_LOG_ARG(a), UNI_LOG_ARGS_1(__VA_ARGS__)
+#define UNI_LOG_ARGS_3(a, ...) UNI_LOG_ARG(a), UNI_LOG_ARGS_2(__VA_ARGS__)
+#define UNI_LOG_ARGS_4(a, ...) UNI_LOG_ARG(a), UNI_LOG_ARGS_3(__VA_ARGS__)
+#define UNI_LOG_ARGS_5(a, ...) UNI_LOG_ARG(a), UNI_LOG_ARGS_4(__VA_ARGS__)
+#define UNI_LOG_ARGS_6(a, ...) UNI_LOG_ARG(a), UNI_LOG_ARGS_5(__VA_ARGS__)
+#define UNI_LOG_ARGS_7(a, ...) UNI_LOG_ARG(a), UNI_LOG_ARGS_6(__VA_ARGS__)
+#define UNI_LOG_ARGS_8(a, ...) UNI_LOG_ARG(a), UNI_LOG_ARGS_7(__VA_ARGS__)
+#define UNI_LOG_ARGS_9(a, ...) UNI_LOG_ARG(a), UNI_LOG_ARGS_8(__VA_ARGS__)
+
+#define UNI_LOG(level, ...)                                                    \
+  do {                                                                         \
+    static uni_log_site_t uni_log_site_ = {level, UNI_LOG_FIRST(__VA_ARGS__),  \
+                                           0};                                 \
+    const uni_log_arg_t uni_log_args_[] = {UNI_LOG_ARGS(__VA_ARGS__)};         \
+    uni_log_write(&uni_log_site_, uni_log_args_ + 1,                           \
+                  UNI_LOG_COUNT(__VA_ARGS__) - 1);                             \
+    if (0)                                                                     \
+      uni_log_check(__VA_ARGS__);                                              \
+  } while (0)
+
+// Filtered out: arguments are still type checked but never evaluated
+#define UNI_LOG_NONE(...)                                                      \
+  do {                                                                         \
+    if (0)                                                                     \
+      uni_log_check(__VA_ARGS__);                                              \
+  } while (0)
+
+#if UNI_LOG_LEVEL <= UNI_LOG_LEVEL_DEBUG
+#define UNI_LOG_DEBUG(...) UNI_LOG(UNI_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define UNI_LOG_DEBUG(...) UNI_LOG_NONE(__VA_ARGS__)
+#endif
+
+#if UNI_LOG_LEVEL <= UNI_LOG_LEVEL_INFO
+#define UNI_LOG_INFO(...) UNI_LOG(UNI_LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define UNI_LOG_INFO(...) UNI_LOG_NONE(__VA_ARGS__)
+#endif
+
+#if UNI_LOG_LEVEL <= UNI_LOG_LEVEL_WARN
+#define UNI_LOG_WARN(...) UNI_LOG(UNI_LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define UNI_LOG_WARN(...) UNI_LOG_NONE(__VA_ARGS__)
+#endif
+
+#if UNI_LOG_LEVEL <= UNI_LOG_LEVEL_ERROR
+#define UNI_LOG_ERROR(...) UNI_LOG(UNI_LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define UNI_LOG_ERROR(...) UNI_LOG_NONE(__VA_ARGS__)
+#endif
+
+#endif // UNI_LIB_UNI_LOG_H
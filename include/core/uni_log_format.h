@@ -0,0 +1,107 @@
+#ifndef UNI_LIB_UNI_LOG_FORMAT_H
+#define UNI_LIB_UNI_LOG_FORMAT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Levels, usable in #if
+#define UNI_LOG_LEVEL_DEBUG 0
+#define UNI_LOG_LEVEL_INFO 1
+#define UNI_LOG_LEVEL_WARN 2
+#define UNI_LOG_LEVEL_ERROR 3
+#define UNI_LOG_LEVEL_NONE 4
+
+#define UNI_LOG_MAX_ARGS 8
+#define UNI_LOG_MAX_STRING 63  // Longest %s argument kept in binary logs
+#define UNI_LOG_MAX_LINE 256   // Longest formatted line, newline included
+
+#define UNI_LOG_MAGIC "ULOG"
+#define UNI_LOG_VERSION 1
+
+/**
+ * Raw log argument, converted by type at the call site
+ */
+typedef union {
+  int64_t i; // Signed and unsigned integers alike
+  uint64_t u;
+  double d;
+  const void *p;
+  const char *s;
+} uni_log_arg_t;
+
+typedef enum {
+  UNI_LOG_ARG_INT,
+  UNI_LOG_ARG_DOUBLE,
+  UNI_LOG_ARG_STRING,
+  UNI_LOG_ARG_POINTER,
+} uni_log_arg_type_t;
+
+/**
+ * Binary log stream
+ *
+ * A header ("ULOG", version, reserved byte, tick rate as u16), then
+ * records led by a type byte. Integers are little endian.
+ *
+ *   'F' format:  u16 id, u8 level, u16 length, format string
+ *   'T' task:    u8 ring, u8 length, task name
+ *   'M' message: u16 format id, u8 ring, u32 tick, u8 count, then per
+ *                argument u8 length + bytes for %s, u64 otherwise
+ *   'D' dropped: u8 ring, u32 messages lost to a full ring
+ *
+ * Format and task records come before the first message using them.
+ */
+#define UNI_LOG_RECORD_FORMAT 'F'
+#define UNI_LOG_RECORD_TASK 'T'
+#define UNI_LOG_RECORD_MESSAGE 'M'
+#define UNI_LOG_RECORD_DROPPED 'D'
+
+// Argument types consumed by a printf format, * widths included; returns
+// their number (at most max are stored)
+int uni_log_arg_types(const char *fmt, uni_log_arg_type_t *types, int max);
+
+// snprintf() over raw arguments; missing ones print as <?>
+size_t uni_log_format(char *buf, size_t size, const char *fmt,
+                      const uni_log_arg_t *args, int count);
+
+// One output line: tick, level, task and message
+size_t uni_log_format_line(char *buf, size_t size, uint8_t level,
+                           uint32_t tick, const char *task, const char *fmt,
+                           const uni_log_arg_t *args, int count);
+
+const char *uni_log_level_name(uint8_t level);
+
+/**
+ * Message decoded from a binary log
+ */
+typedef struct {
+  uint8_t level;
+  uint32_t tick;
+  const char *task;
+  const char *fmt;
+  uint8_t count;
+  uni_log_arg_t args[UNI_LOG_MAX_ARGS];
+  char strings[UNI_LOG_MAX_ARGS][UNI_LOG_MAX_STRING + 1];
+} uni_log_message_t;
+
+/**
+ * Host side reader of binary logs
+ */
+typedef struct {
+  FILE *file;
+  uint16_t tick_rate;
+  uint64_t dropped; // Messages the target lost, so far
+  char **formats;   // By id
+  uint8_t *levels;
+  size_t num_formats;
+  char *tasks[256]; // By ring
+} uni_log_reader_t;
+
+bool uni_log_reader_open(uni_log_reader_t *reader, FILE *file);
+void uni_log_reader_close(uni_log_reader_t *reader);
+
+// Next message; false at the end of the stream or on a malformed record
+bool uni_log_reader_next(uni_log_reader_t *reader, uni_log_message_t *message);
+
+#endif // UNI_LIB_UNI_LOG_FORMAT_H
@@ -0,0 +1,106 @@
+#ifndef UNI_LIB_UNI_LOOP_H
+#define UNI_LIB_UNI_LOOP_H
+
+#include "core/timer_service.h"
+#include "hal/gpio.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct uni_loop uni_loop_t;
+typedef struct uni_loop_source uni_loop_source_t;
+
+typedef void (*uni_loop_callback_t)(uni_loop_source_t *source, void *arg);
+
+typedef enum {
+  UNI_LOOP_SOURCE_FD,
+  UNI_LOOP_SOURCE_GPIO,
+  UNI_LOOP_SOURCE_TIMER,
+  UNI_LOOP_SOURCE_WAKEUP,
+} uni_loop_source_kind_t;
+
+/**
+ * Something the loop waits on, owned by the caller while registered
+ */
+struct uni_loop_source {
+  uni_loop_t *loop;
+  uni_loop_source_kind_t kind;
+  int fd;
+  uint32_t events;
+  uni_loop_callback_t callback;
+  void *arg;
+  gpio_handle_t *gpio;
+  uint64_t dispatch_seq; // Event the source was last called back for
+  uni_loop_source_t *next;
+};
+
+/**
+ * Loop statistics
+ */
+typedef struct {
+  uint64_t wakeups;    // Returns from epoll_wait
+  uint64_t dispatched; // Source callbacks run
+} uni_loop_stats_t;
+
+/**
+ * Blocking event loop for Linux native applications
+ *
+ * One epoll_wait covers every source: GPIO edges, timerfd timers, eventfd
+ * wakeups from other threads and arbitrary descriptors. The loop also
+ * drives the timer service in place of its FreeRTOS task, so component
+ * timeouts (button debounce, long press, repeat) fire from the loop and
+ * the thread sleeps until a pin changes or a timeout is due.
+ *
+ * Sources are dispatched on the thread running the loop; only
+ * uni_loop_wake() and uni_loop_stop() may be called from other threads.
+ * Component methods and timeouts must be used from the loop thread too.
+ * One loop at a time can drive the timer service; initialize it before
+ * the components so they do not start the service task. GPIO sources
+ * must be Linux GPIO handles.
+ */
+struct uni_loop {
+  int epoll_fd;
+  int wake_fd; // eventfd: stop requests and timer service wakeups
+  pthread_t thread;
+  atomic_bool running;
+  uni_loop_source_t *sources;
+  uint64_t dispatch_seq;
+  timer_service_clock_t clock;
+  bool drives_timers;
+  uni_loop_stats_t stats;
+};
+
+bool uni_loop_init(uni_loop_t *loop);
+void uni_loop_deinit(uni_loop_t *loop);
+
+// Call back on every edge of an input; the callback should read the pin
+bool uni_loop_add_gpio(uni_loop_t *loop, uni_loop_source_t *source,
+                       gpio_handle_t *gpio, uni_loop_callback_t callback,
+                       void *arg);
+
+// Call back after first_ms, then every period_ms (0: once)
+bool uni_loop_add_timer(uni_loop_t *loop, uni_loop_source_t *source,
+                        uint32_t first_ms, uint32_t period_ms,
+                        uni_loop_callback_t callback, void *arg);
+
+// Call back on the loop thread after uni_loop_wake() from any thread
+bool uni_loop_add_wakeup(uni_loop_t *loop, uni_loop_source_t *source,
+                         uni_loop_callback_t callback, void *arg);
+bool uni_loop_wake(uni_loop_source_t *source);
+
+// Call back when fd reports any of the epoll events
+bool uni_loop_add_fd(uni_loop_t *loop, uni_loop_source_t *source, int fd,
+                     uint32_t events, uni_loop_callback_t callback, void *arg);
+
+void uni_loop_remove(uni_loop_source_t *source);
+
+// Wait up to timeout_ms (-1: forever) and dispatch; returns the number of
+// callbacks run, or -1 on error
+int uni_loop_run_once(uni_loop_t *loop, int timeout_ms);
+
+// Dispatch until uni_loop_stop()
+bool uni_loop_run(uni_loop_t *loop);
+void uni_loop_stop(uni_loop_t *loop);
+
+#endif // UNI_LIB_UNI_LOOP_H
@@ -2,6 +2,7 @@
 #define UNI_LIB_GPIO_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 /**
@@ -13,33 +14,70 @@ typedef struct {
   bool pull_up;
   bool pull_down;
   bool active_high;        // Added to specify active high/low logic
+  bool open_drain;         // Outputs only pull low; high releases the line
+  uint32_t debounce_us;    // Inputs: ignore levels shorter than this (0: off)
   void *platform_specific; // Platform-specific configuration
 } gpio_config_t;
 
-/**
- * GPIO Handle structure following OOP pattern
- */
-typedef struct gpio_handle {
-  void *hw_handle;  // Platform-specific hardware handle
-  bool active_high; // Store the active logic configuration
+typedef struct gpio_handle gpio_handle_t;
 
-  // Methods (function pointers for OOP)
-  bool (*init)(struct gpio_handle *self, const gpio_config_t *config);
-  bool (*deinit)(struct gpio_handle *self);
+// Method members, shared by the ops table and the per-handle copy below
+#define GPIO_OPS_METHODS                                                       \
+  bool (*init)(gpio_handle_t * self, const gpio_config_t *config);             \
+  bool (*deinit)(gpio_handle_t * self);                                        \
+                                                                               \
+  bool (*write)(gpio_handle_t * self, bool state);                             \
+  bool (*read)(gpio_handle_t * self);                                          \
+                                                                               \
+  bool (*activate)(gpio_handle_t * self);                                      \
+  bool (*deactivate)(gpio_handle_t * self);                                    \
+  bool (*is_active)(gpio_handle_t * self);                                     \
+                                                                               \
+  bool (*toggle)(gpio_handle_t * self);                                        \
+                                                                               \
+  /* Optional interrupt support */                                             \
+  bool (*set_interrupt)(gpio_handle_t * self, void (*callback)(void *),        \
+                        void *arg);
 
-  bool (*write)(struct gpio_handle *self, bool state);
-  bool (*read)(struct gpio_handle *self);
+/**
+ * GPIO operations table, shared by every handle of a backend
+ */
+typedef struct gpio_ops {
+  GPIO_OPS_METHODS
+} gpio_ops_t;
 
-  bool (*activate)(struct gpio_handle *self);
-  bool (*deactivate)(struct gpio_handle *self);
-  bool (*is_active)(struct gpio_handle *self);
+/**
+ * GPIO Handle structure following OOP pattern
+ *
+ * With dynamic dispatch (the default) the handle also carries a copy of its
+ * methods, so handle.write(&handle, state) calls keep working next to
+ * gpio_write(&handle, state). UNI_LIB_STATIC_DISPATCH builds drop the copy
+ * to shrink the handle; there only the gpio_*() calls are available.
+ */
+struct gpio_handle {
+  void *hw_handle;      // Platform-specific hardware handle
+  bool active_high;     // Store the active logic configuration
+  uint32_t debounce_us; // Filter the backend applies to reads, set by init
+  bool debounce_hw;     // debounce_us runs in the kernel or hardware
 
-  bool (*toggle)(struct gpio_handle *self);
+  const gpio_ops_t *ops; // Methods, shared with all handles of the backend
+#ifndef UNI_LIB_STATIC_DISPATCH
+  union {
+    gpio_ops_t methods;
+    struct {
+      GPIO_OPS_METHODS
+    };
+  };
+#endif
+};
 
-  // Optional interrupt support
-  bool (*set_interrupt)(struct gpio_handle *self, void (*callback)(void *),
-                        void *arg);
-} gpio_handle_t;
+// Attach a backend's methods, called by its create()
+static inline void gpio_bind_ops(gpio_handle_t *self, const gpio_ops_t *ops) {
+  self->ops = ops;
+#ifndef UNI_LIB_STATIC_DISPATCH
+  self->methods = *ops;
+#endif
+}
 
 /**
  * Platform-specific GPIO driver interface
@@ -47,6 +85,11 @@ typedef struct gpio_handle {
 typedef struct {
   bool (*create)(gpio_handle_t *handle);
   bool (*destroy)(gpio_handle_t *handle);
+
+  // Optional bulk bring-up and teardown, see gpio_provision()
+  bool (*provision)(gpio_handle_t *handles, const gpio_config_t *configs,
+                    size_t count, int *errors);
+  void (*unprovision)(gpio_handle_t *handles, size_t count);
 } gpio_driver_t;
 
 // Platform-specific driver implementation declarations
@@ -56,4 +99,110 @@ extern const gpio_driver_t stm32_gpio_driver;
 extern const gpio_driver_t linux_gpio_driver;
 #endif
 
+/**
+ * Method dispatch
+ *
+ * By default every call goes through the handle's ops table, so backends
+ * can be mixed at runtime (e.g. the test mock next to the Linux driver).
+ * Building with UNI_LIB_STATIC_DISPATCH binds the methods at compile time
+ * to the backend named by UNI_LIB_GPIO_BACKEND (e.g. linux_gpio resolves
+ * gpio_write() to linux_gpio_write()), which lets LTO inline them into the
+ * caller. Backends define their methods with GPIO_BACKEND_API so they get
+ * external linkage in that mode.
+ */
+#ifdef UNI_LIB_STATIC_DISPATCH
+
+#ifndef UNI_LIB_GPIO_BACKEND
+#error "UNI_LIB_STATIC_DISPATCH requires UNI_LIB_GPIO_BACKEND"
+#endif
+
+#define GPIO_BACKEND_API
+#define GPIO_METHOD_CAT_(backend, method) backend##_##method
+#define GPIO_METHOD_CAT(backend, method) GPIO_METHOD_CAT_(backend, method)
+#define GPIO_METHOD(method) GPIO_METHOD_CAT(UNI_LIB_GPIO_BACKEND, method)
+#define GPIO_CALL(self, method) GPIO_METHOD(method)
+
+bool GPIO_METHOD(init)(gpio_handle_t *self, const gpio_config_t *config);
+bool GPIO_METHOD(deinit)(gpio_handle_t *self);
+bool GPIO_METHOD(write)(gpio_handle_t *self, bool state);
+bool GPIO_METHOD(read)(gpio_handle_t *self);
+bool GPIO_METHOD(activate)(gpio_handle_t *self);
+bool GPIO_METHOD(deactivate)(gpio_handle_t *self);
+bool GPIO_METHOD(is_active)(gpio_handle_t *self);
+bool GPIO_METHOD(toggle)(gpio_handle_t *self);
+bool GPIO_METHOD(set_interrupt)(gpio_handle_t *self, void (*callback)(void *),
+                                void *arg);
+
+#else
+
+#define GPIO_BACKEND_API static
+#define GPIO_CALL(self, method) (self)->ops->method
+
+#endif // UNI_LIB_STATIC_DISPATCH
+
+static inline bool gpio_init(gpio_handle_t *self, const gpio_config_t *config) {
+  return GPIO_CALL(self, init)(self, config);
+}
+
+static inline bool gpio_deinit(gpio_handle_t *self) {
+  return GPIO_CALL(self, deinit)(self);
+}
+
+static inline bool gpio_write(gpio_handle_t *self, bool state) {
+  return GPIO_CALL(self, write)(self, state);
+}
+
+static inline bool gpio_read(gpio_handle_t *self) {
+  return GPIO_CALL(self, read)(self);
+}
+
+static inline bool gpio_activate(gpio_handle_t *self) {
+  return GPIO_CALL(self, activate)(self);
+}
+
+static inline bool gpio_deactivate(gpio_handle_t *self) {
+  return GPIO_CALL(self, deactivate)(self);
+}
+
+static inline bool gpio_is_active(gpio_handle_t *self) {
+  return GPIO_CALL(self, is_active)(self);
+}
+
+static inline bool gpio_toggle(gpio_handle_t *self) {
+  return GPIO_CALL(self, toggle)(self);
+}
+
+/**
+ * Debounce period in effect on the pin, 0 if reads see the raw level
+ *
+ * Backends filter in the kernel or hardware where they can and in the
+ * driver otherwise; either way a level shorter than this never reaches
+ * read() or is_active(). See gpio_debounce_in_hw() for edges.
+ */
+static inline uint32_t gpio_debounce_us(const gpio_handle_t *self) {
+  return self->debounce_us;
+}
+
+/**
+ * True if the kernel or hardware debounces the pin
+ *
+ * Such a filter runs continuously: edge events and interrupts only report
+ * settled levels. A driver filter (false here with a nonzero period) only
+ * advances when the pin is read, edges still report every bounce, and a
+ * read right after the last bounce can return the old level; callers woken
+ * by edges must read again once the period has passed.
+ */
+static inline bool gpio_debounce_in_hw(const gpio_handle_t *self) {
+  return self->debounce_us && self->debounce_hw;
+}
+
+static inline bool gpio_set_interrupt(gpio_handle_t *self,
+                                      void (*callback)(void *), void *arg) {
+#ifndef UNI_LIB_STATIC_DISPATCH
+  if (!self->ops->set_interrupt)
+    return false;
+#endif
+  return GPIO_CALL(self, set_interrupt)(self, callback, arg);
+}
+
 #endif // UNI_LIB_GPIO_H
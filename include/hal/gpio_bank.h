@@ -0,0 +1,73 @@
+#ifndef UNI_LIB_GPIO_BANK_H
+#define UNI_LIB_GPIO_BANK_H
+
+#include "hal/gpio.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define GPIO_BANK_MAX_PINS 32
+
+typedef struct gpio_bank gpio_bank_t;
+
+/**
+ * Native bank access for backends that can update several pins at once.
+ * Bit i of mask/bits maps to pins[i] of the bank.
+ */
+typedef struct {
+  bool (*write)(gpio_bank_t *self, uint32_t mask, uint32_t bits);
+  bool (*read)(gpio_bank_t *self, uint32_t *bits);
+} gpio_bank_ops_t;
+
+/**
+ * GPIO bank: a group of pins written and read as one word
+ *
+ * The bank keeps a shadow of the last level written to each output, so
+ * writes that would not change a pin are dropped and toggles are a
+ * read-modify-write on the shadow. In deferred mode writes only update the
+ * pending word and reach the hardware in a single bank write at
+ * gpio_bank_commit(), typically once per control loop tick.
+ *
+ * Concurrency: every function may be called from several tasks and native
+ * threads at once. The shadow and pending words are updated with a single
+ * compare-and-swap, so writes, sets, clears and toggles on different pins
+ * never clobber each other and toggles are never lost. A writer then pushes
+ * its pins to the hardware and pushes again if another writer changed the
+ * shadow meanwhile, so the hardware ends up at the last level stored in
+ * the shadow. Backend bank ops must only touch the pins in their mask.
+ * Init, ops and hw_handle must be set up before the bank is shared.
+ */
+struct gpio_bank {
+  gpio_handle_t *pins[GPIO_BANK_MAX_PINS];
+  uint8_t num_pins;
+
+  // Shadow register: generation << 32 | last level written to each output
+  atomic_uint_fast64_t shadow;
+  atomic_uint_fast32_t known; // Pins whose shadow reflects the hardware
+
+  // Deferred writes: mask << 32 | bits
+  atomic_bool deferred;
+  atomic_uint_fast64_t pending;
+
+  // Optional native access, NULL falls back to the pin handles
+  const gpio_bank_ops_t *ops;
+  void *hw_handle;
+};
+
+bool gpio_bank_init(gpio_bank_t *bank, gpio_handle_t *const *pins,
+                    uint8_t num_pins);
+
+bool gpio_bank_write(gpio_bank_t *bank, uint32_t mask, uint32_t bits);
+bool gpio_bank_set(gpio_bank_t *bank, uint32_t mask);
+bool gpio_bank_clear(gpio_bank_t *bank, uint32_t mask);
+bool gpio_bank_toggle(gpio_bank_t *bank, uint32_t mask);
+bool gpio_bank_read(gpio_bank_t *bank, uint32_t *bits);
+
+// Leaving deferred mode commits the pending writes
+bool gpio_bank_set_deferred(gpio_bank_t *bank, bool deferred);
+bool gpio_bank_commit(gpio_bank_t *bank);
+
+// Forget the shadow, e.g. after the pins were driven behind the bank's back
+void gpio_bank_invalidate(gpio_bank_t *bank);
+
+#endif // UNI_LIB_GPIO_BANK_H
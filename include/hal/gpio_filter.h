@@ -0,0 +1,67 @@
+#ifndef UNI_LIB_GPIO_FILTER_H
+#define UNI_LIB_GPIO_FILTER_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// State word: since_us << 3 | primed << 2 | seen << 1 | stable
+#define GPIO_FILTER_STABLE 1u
+#define GPIO_FILTER_SEEN 2u
+#define GPIO_FILTER_PRIMED 4u
+
+/**
+ * Debounce of one input, for backends that cannot filter in hardware
+ *
+ * The filter only moves when it is sampled: a new level replaces the
+ * stable one at the first sample taken period_us or more after the level
+ * was first seen, with no other level seen in between. A caller that stops
+ * sampling after the last bounce keeps getting the old level. The state is
+ * one atomic word, so several threads may sample the same input, even with
+ * clock readings that reach the filter out of order.
+ */
+typedef struct {
+  uint32_t period_us; // 0: the filter is off
+  _Atomic uint64_t state;
+} gpio_filter_t;
+
+static inline void gpio_filter_init(gpio_filter_t *filter,
+                                    uint32_t period_us) {
+  filter->period_us = period_us;
+  atomic_init(&filter->state, 0);
+}
+
+// Level the filter settled on, false before the first sample
+static inline bool gpio_filter_level(gpio_filter_t *filter) {
+  return atomic_load(&filter->state) & GPIO_FILTER_STABLE;
+}
+
+// Feed the level read at now_us, returns the filtered level
+static inline bool gpio_filter_sample(gpio_filter_t *filter, bool raw,
+                                      uint64_t now_us) {
+  if (!filter->period_us)
+    return raw;
+
+  uint64_t word = atomic_load(&filter->state);
+  uint64_t next;
+  bool stable;
+  do {
+    uint64_t since = word >> 3;
+    stable = word & GPIO_FILTER_STABLE;
+    if (!(word & GPIO_FILTER_PRIMED))
+      stable = raw; // The first sample has nothing to filter against
+    else if (raw != (bool)(word & GPIO_FILTER_SEEN))
+      since = now_us; // A new level starts
+    else if (raw != stable && now_us > since &&
+             now_us - since >= filter->period_us)
+      stable = raw; // Samples older than since count as no time passed
+
+    next = since << 3 | GPIO_FILTER_PRIMED | (raw ? GPIO_FILTER_SEEN : 0) |
+           (stable ? GPIO_FILTER_STABLE : 0);
+  } while (next != word &&
+           !atomic_compare_exchange_weak(&filter->state, &word, next));
+
+  return stable;
+}
+
+#endif // UNI_LIB_GPIO_FILTER_H
@@ -0,0 +1,43 @@
+#ifndef UNI_LIB_GPIO_LINUX_H
+#define UNI_LIB_GPIO_LINUX_H
+
+#include "hal/gpio.h"
+#include <stdint.h>
+
+/**
+ * Character device line, passed as gpio_config_t.platform_specific
+ *
+ * Pins with a line are driven through the GPIO character device (uAPI v2)
+ * and gpio_config_t.pin is ignored. Pins without one use sysfs and the
+ * global pin number; sysfs has no open drain outputs.
+ *
+ * gpio_config_t.debounce_us goes to the kernel as the line's debounce
+ * period, which the chip applies in hardware if it can. Sysfs pins, and
+ * lines the kernel cannot debounce, are filtered by the driver on read;
+ * gpio_debounce_in_hw() tells the two apart.
+ */
+typedef struct {
+  const char *chip; // e.g. "/dev/gpiochip0"
+  uint32_t offset;  // Line offset on the chip
+} linux_gpio_line_t;
+
+/**
+ * Edge events for event loops
+ *
+ * Enables detection of both edges on an input and returns a descriptor to
+ * poll with the poll(2) events stored in *events, or -1. Sysfs pins report
+ * POLLPRI on their value file; character device lines report POLLIN on the
+ * descriptor of their line request, shared with the other lines requested
+ * with them. After it fired, call linux_gpio_edge_ack() and read the pin.
+ * The descriptor is closed by deinit. Lines debounced by the kernel only
+ * report settled edges; pins the driver debounces report every bounce.
+ *
+ * This is the only edge path of the driver: set_interrupt() fails with
+ * errno ENOTSUP, so components that decode from edge callbacks (encoder
+ * use_interrupts, event_export_edges()) are driven from the descriptor,
+ * e.g. with uni_loop_add_gpio(), calling their process() instead.
+ */
+int linux_gpio_edge_fd(gpio_handle_t *self, short *events);
+bool linux_gpio_edge_ack(gpio_handle_t *self);
+
+#endif // UNI_LIB_GPIO_LINUX_H
@@ -0,0 +1,28 @@
+#ifndef UNI_LIB_GPIO_PROVISION_H
+#define UNI_LIB_GPIO_PROVISION_H
+
+#include "hal/gpio.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Bring up a table of pins in one pass
+ *
+ * Creates handles[i] with the driver and initializes it from configs[i].
+ * Drivers with a provision method batch the work: the Linux backend issues
+ * one line request per chip for character device lines and exports sysfs
+ * pins in parallel before waiting for them to become ready. Other drivers
+ * initialize pin by pin.
+ *
+ * errors (optional, count entries) receives 0 or an errno value per pin.
+ * Pins that failed are left destroyed, the others are ready to use.
+ * Returns true if every pin came up.
+ */
+bool gpio_provision(const gpio_driver_t *driver, gpio_handle_t *handles,
+                    const gpio_config_t *configs, size_t count, int *errors);
+
+// Deinitialize and destroy every handle gpio_provision() brought up
+void gpio_unprovision(const gpio_driver_t *driver, gpio_handle_t *handles,
+                      size_t count);
+
+#endif // UNI_LIB_GPIO_PROVISION_H
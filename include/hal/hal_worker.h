@@ -0,0 +1,52 @@
+#ifndef UNI_LIB_HAL_WORKER_H
+#define UNI_LIB_HAL_WORKER_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Blocking HAL operation executed on a worker thread
+ */
+typedef bool (*hal_worker_fn_t)(void *arg);
+
+/**
+ * HAL worker pool
+ *
+ * Under the FreeRTOS POSIX port only one task thread runs at a time, so a
+ * task stuck in a blocking syscall stalls the whole scheduler. The worker
+ * pool runs such operations on native threads outside the scheduler while
+ * the calling task blocks on a task notification. Completions are handed
+ * back from the RTOS tick hook, so other tasks keep running and several
+ * tasks can have I/O in flight at once.
+ *
+ * hal_worker_call() runs the operation inline when the pool is not started,
+ * the scheduler is not running, or the caller is a native thread.
+ */
+bool hal_worker_start(size_t num_threads);
+void hal_worker_stop(void);
+
+// Run the workers, current and started later, under SCHED_FIFO at priority
+// (0 keeps the default policy) on the CPUs in the cpus mask (0 for any).
+// Without it, workers inherit the policy and affinity of the thread that
+// starts them.
+bool hal_worker_set_sched(int priority, uint32_t cpus);
+
+// Move one thread to the same policy and CPUs; sets errno on failure.
+// rt_profile_apply_thread() uses it too.
+bool hal_worker_sched_thread(pthread_t thread, int priority, uint32_t cpus);
+
+// Run fn(arg) synchronously from the caller's point of view
+bool hal_worker_call(hal_worker_fn_t fn, void *arg);
+
+// Mark the calling native (non-FreeRTOS) thread so its calls run inline
+void hal_worker_register_native_thread(void);
+
+// True on workers and on threads marked as native
+bool hal_worker_is_native_thread(void);
+
+// Must be called from vApplicationTickHook() to wake completed callers
+void hal_worker_tick_hook(void);
+
+#endif // UNI_LIB_HAL_WORKER_H
@@ -0,0 +1,89 @@
+#ifndef UNI_LIB_SOFT_BUS_H
+#define UNI_LIB_SOFT_BUS_H
+
+#include "hal/gpio.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * Pin of a bit-banged bus
+ *
+ * The write and read methods are looked up once at init, so a transfer
+ * makes one call per edge instead of going through the ops table for every
+ * bit. Under UNI_LIB_STATIC_DISPATCH the calls bind to the backend and can
+ * inline into the transfer loop.
+ */
+typedef struct {
+  gpio_handle_t *gpio; // NULL if the bus does not use the pin
+  bool (*write)(gpio_handle_t *self, bool state);
+  bool (*read)(gpio_handle_t *self);
+} soft_bus_pin_t;
+
+/**
+ * Bus clock pacing: at least half_ns between consecutive edges, measured
+ * from the end of the previous wait so a slow pin never shortens a phase
+ */
+typedef struct {
+  uint32_t half_ns; // 0: as fast as the pins toggle
+  uint64_t last_ns;
+} soft_bus_clock_t;
+
+static inline void soft_bus_pin_init(soft_bus_pin_t *pin, gpio_handle_t *gpio) {
+  pin->gpio = gpio;
+#ifdef UNI_LIB_STATIC_DISPATCH
+  pin->write = NULL;
+  pin->read = NULL;
+#else
+  pin->write = gpio ? gpio->ops->write : NULL;
+  pin->read = gpio ? gpio->ops->read : NULL;
+#endif
+}
+
+static inline bool soft_bus_write(const soft_bus_pin_t *pin, bool level) {
+#ifdef UNI_LIB_STATIC_DISPATCH
+  return GPIO_METHOD(write)(pin->gpio, level);
+#else
+  return pin->write(pin->gpio, level);
+#endif
+}
+
+static inline bool soft_bus_read(const soft_bus_pin_t *pin) {
+#ifdef UNI_LIB_STATIC_DISPATCH
+  return GPIO_METHOD(read)(pin->gpio);
+#else
+  return pin->read(pin->gpio);
+#endif
+}
+
+static inline uint64_t soft_bus_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+// Half a bus clock period, 0 when speed_hz is 0 (unpaced)
+static inline void soft_bus_clock_init(soft_bus_clock_t *clock,
+                                       uint32_t speed_hz) {
+  clock->half_ns = speed_hz ? 500000000u / speed_hz : 0;
+  clock->last_ns = 0;
+}
+
+static inline void soft_bus_clock_start(soft_bus_clock_t *clock) {
+  if (clock->half_ns)
+    clock->last_ns = soft_bus_now_ns();
+}
+
+// Wait out the rest of the current half period
+static inline void soft_bus_delay(soft_bus_clock_t *clock) {
+  if (!clock->half_ns)
+    return;
+
+  uint64_t until = clock->last_ns + clock->half_ns;
+  uint64_t now = soft_bus_now_ns();
+  while (now < until)
+    now = soft_bus_now_ns();
+  clock->last_ns = now;
+}
+
+#endif // UNI_LIB_SOFT_BUS_H
@@ -0,0 +1,74 @@
+#ifndef UNI_LIB_SOFT_I2C_H
+#define UNI_LIB_SOFT_I2C_H
+
+#include "hal/soft_bus.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef SOFT_I2C_STRETCH_TIMEOUT_US
+#define SOFT_I2C_STRETCH_TIMEOUT_US 10000 // Longest clock stretch by a slave
+#endif
+
+typedef enum {
+  SOFT_I2C_OK,
+  SOFT_I2C_NACK_ADDRESS, // No slave answered the address
+  SOFT_I2C_NACK_DATA,    // The slave refused a data byte
+  SOFT_I2C_TIMEOUT,      // SCL held low longer than the stretch timeout
+  SOFT_I2C_BUS_ERROR,    // A pin call failed, or SDA is stuck low
+} soft_i2c_error_t;
+
+/**
+ * Bus configuration
+ *
+ * SCL and SDA must be outputs with open_drain set, so writing high
+ * releases the line and reading returns the level on the wire.
+ */
+typedef struct {
+  gpio_handle_t *scl;
+  gpio_handle_t *sda;
+  uint32_t speed_hz;          // e.g. 100000, 400000; 0: as fast as possible
+  uint32_t stretch_timeout_us; // 0: SOFT_I2C_STRETCH_TIMEOUT_US
+  bool ignore_stretch;        // No slave stretches: skip reading SCL back
+} soft_i2c_config_t;
+
+/**
+ * Bit-banged I2C master (single master, 7-bit addresses)
+ *
+ * Transfers run on the calling thread and busy-wait between edges to keep
+ * the configured clock; under the FreeRTOS POSIX port, pins of the Linux
+ * backend are fastest from a native thread, where HAL calls run inline.
+ * Unless ignore_stretch is set, every SCL release waits for slaves holding
+ * the clock low, up to the stretch timeout.
+ */
+typedef struct {
+  soft_bus_pin_t scl;
+  soft_bus_pin_t sda;
+  soft_bus_clock_t clock;
+  uint32_t stretch_timeout_us;
+  bool ignore_stretch;
+  soft_i2c_error_t error; // Why the last transfer failed
+} soft_i2c_t;
+
+// Also frees a bus left mid-transfer by clocking SDA loose and sending a stop
+bool soft_i2c_init(soft_i2c_t *bus, const soft_i2c_config_t *config);
+
+// Write tx, then read rx after a repeated start; either may be empty
+bool soft_i2c_transfer(soft_i2c_t *bus, uint8_t address, const uint8_t *tx,
+                       size_t tx_len, uint8_t *rx, size_t rx_len);
+
+bool soft_i2c_write(soft_i2c_t *bus, uint8_t address, const uint8_t *data,
+                    size_t len);
+bool soft_i2c_read(soft_i2c_t *bus, uint8_t address, uint8_t *data,
+                   size_t len);
+
+// Register access of the usual kind: 8-bit register address, then data
+bool soft_i2c_write_reg(soft_i2c_t *bus, uint8_t address, uint8_t reg,
+                        const uint8_t *data, size_t len);
+bool soft_i2c_read_reg(soft_i2c_t *bus, uint8_t address, uint8_t reg,
+                       uint8_t *data, size_t len);
+
+// True if a slave acknowledges the address
+bool soft_i2c_probe(soft_i2c_t *bus, uint8_t address);
+
+#endif // UNI_LIB_SOFT_I2C_H
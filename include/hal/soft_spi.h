@@ -0,0 +1,67 @@
+#ifndef UNI_LIB_SOFT_SPI_H
+#define UNI_LIB_SOFT_SPI_H
+
+#include "hal/gpio_bank.h"
+#include "hal/soft_bus.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef SOFT_SPI_MAX_DEVICES
+#define SOFT_SPI_MAX_DEVICES 4 // Chip selects per bus
+#endif
+
+/**
+ * Bus configuration
+ *
+ * mode is CPOL << 1 | CPHA, as in the usual SPI modes 0 to 3. Chip selects
+ * are active low outputs; a NULL entry addresses a slave that is always
+ * selected. If bank is set and holds SCK and MOSI, each clock edge updates
+ * both with a single bank write, which pays off with native bank access.
+ */
+typedef struct {
+  gpio_handle_t *sck;
+  gpio_handle_t *mosi; // NULL for a receive-only bus
+  gpio_handle_t *miso; // NULL for a transmit-only bus
+  gpio_handle_t *cs[SOFT_SPI_MAX_DEVICES];
+  uint8_t mode;
+  bool lsb_first;
+  uint32_t speed_hz; // 0: as fast as possible
+  gpio_bank_t *bank; // Optional, see above
+} soft_spi_config_t;
+
+/**
+ * Bit-banged SPI master
+ *
+ * Transfers run on the calling thread and busy-wait between edges to keep
+ * the configured clock. MOSI is only written when the next bit differs.
+ */
+typedef struct {
+  soft_bus_pin_t sck;
+  soft_bus_pin_t mosi;
+  soft_bus_pin_t miso;
+  soft_bus_pin_t cs[SOFT_SPI_MAX_DEVICES];
+  soft_bus_clock_t clock;
+  bool cpol;
+  bool cpha;
+  bool lsb_first;
+  bool mosi_level; // Last level written to MOSI
+
+  // Bank path: bits of SCK and MOSI in the bank, 0 if not in it
+  gpio_bank_t *bank;
+  uint32_t sck_bit;
+  uint32_t mosi_bit;
+} soft_spi_t;
+
+bool soft_spi_init(soft_spi_t *bus, const soft_spi_config_t *config);
+
+// Full duplex under one chip select; tx NULL sends zeros, rx NULL discards
+bool soft_spi_transfer(soft_spi_t *bus, uint8_t device, const uint8_t *tx,
+                       uint8_t *rx, size_t len);
+
+// Send tx, then read rx, under one chip select (commands, register reads)
+bool soft_spi_write_then_read(soft_spi_t *bus, uint8_t device,
+                              const uint8_t *tx, size_t tx_len, uint8_t *rx,
+                              size_t rx_len);
+
+#endif // UNI_LIB_SOFT_SPI_H
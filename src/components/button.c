@@ -1,40 +1,44 @@
 #include "components/button.h"
 #include <stdlib.h>
 #include "FreeRTOS.h"
-#include "timers.h"
 #include "queue.h"
 
-// Forward declarations
-static void button_debounce_callback(TimerHandle_t timer);
-
 static bool button_init(button_handle_t *self, const button_config_t *config) {
     if (!self || !config) return false;
 
     // Initialize GPIO
-    if (!self->gpio.init(&self->gpio, &config->gpio_config)) {
+    if (!gpio_init(&self->gpio, &config->gpio_config)) {
         return false;
     }
     
     // Store configuration
     self->debounce_ms = config->debounce_ms;
     self->long_press_ms = config->long_press_ms;
-    self->press_start_tick = 0;
-    self->last_state = false;
-    self->is_pressed = false;
-    self->is_debouncing = false;
+    self->repeat_ms = config->repeat_ms;
+    uint32_t pin_debounce_us = gpio_debounce_us(&self->gpio);
+    bool in_hw = gpio_debounce_in_hw(&self->gpio);
+    self->pin_debounced = in_hw && pin_debounce_us >= config->debounce_ms * 1000u;
+    // A driver filter only moves on reads: read again once it has settled
+    self->settle_ticks = pin_debounce_us && !in_hw
+                             ? pdMS_TO_TICKS((pin_debounce_us + 999) / 1000) + 1
+                             : 0;
+    atomic_init(&self->press_start_tick, 0);
+    atomic_init(&self->last_state, false);
+    atomic_init(&self->is_pressed, false);
+    atomic_init(&self->is_held, false);
+    atomic_init(&self->is_debouncing, false);
     self->event_queue = config->event_queue;
 
-    // Create debounce timer
-    self->debounce_timer = xTimerCreate(
-        "btn_debounce",
-        pdMS_TO_TICKS(config->debounce_ms),
-        pdFALSE,  // One-shot timer
-        (void*)self,
-        button_debounce_callback
-    );
-
-    if (self->debounce_timer == NULL) {
-        self->gpio.deinit(&self->gpio);
+    if (!event_sink_init(&self->events, config->event_queue, sizeof(button_event_t),
+                         config->overflow_policy)) {
+        gpio_deinit(&self->gpio);
+        return false;
+    }
+    event_sink_set_export(&self->events, EVENT_KIND_BUTTON, (uint16_t)config->gpio_config.pin);
+
+    // Debounce and long press run on the shared timer service
+    if (!timer_service_start()) {
+        gpio_deinit(&self->gpio);
         return false;
     }
 
@@ -44,35 +48,52 @@ static bool button_init(button_handle_t *self, const button_config_t *config) {
 static void button_deinit(button_handle_t *self) {
     if (!self) return;
     
-    if (self->debounce_timer) {
-        xTimerDelete(self->debounce_timer, portMAX_DELAY);
-    }
+    timeout_cancel(&self->debounce);
+    timeout_cancel(&self->settle);
+    timeout_cancel(&self->hold);
     
-    self->gpio.deinit(&self->gpio);
+    gpio_deinit(&self->gpio);
 }
 
 static bool button_is_pressed(button_handle_t *self) {
     if (!self) return false;
-    return self->gpio.is_active(&self->gpio);
+    return gpio_is_active(&self->gpio);
 }
 
-static void button_debounce_callback(TimerHandle_t timer) {
-    button_handle_t *self = (button_handle_t *)pvTimerGetTimerID(timer);
-    if (!self) return;
+static void button_hold_expired(void *arg) {
+    button_handle_t *self = arg;
+
+    // The first expiry marks the long press, later ones repeat
+    if (atomic_exchange(&self->is_held, true)) {
+        button_event_t event = BUTTON_EVENT_REPEAT;
+        event_sink_post(&self->events, &event, event, false);
+    }
+
+    if (self->repeat_ms) {
+        timeout_arm(&self->hold, pdMS_TO_TICKS(self->repeat_ms));
+    }
+}
+
+static void button_debounce_expired(void *arg) {
+    button_handle_t *self = arg;
 
     bool current_state = button_is_pressed(self);
     button_event_t event;
 
-    if (current_state != self->last_state) {
+    if (current_state != atomic_load(&self->last_state)) {
         if (current_state) {
             // Button pressed
-            self->is_pressed = true;
-            self->press_start_tick = xTaskGetTickCount();
+            atomic_store(&self->press_start_tick, timer_service_now());
+            atomic_store(&self->is_held, false);
+            atomic_store(&self->is_pressed, true);
+            timeout_arm(&self->hold, pdMS_TO_TICKS(self->long_press_ms));
             event = BUTTON_EVENT_PRESSED;
         } else {
             // Button released
-            self->is_pressed = false;
-            TickType_t press_duration = xTaskGetTickCount() - self->press_start_tick;
+            atomic_store(&self->is_pressed, false);
+            timeout_cancel(&self->hold);
+            TickType_t press_duration =
+                timer_service_now() - atomic_load(&self->press_start_tick);
             
             if (press_duration >= pdMS_TO_TICKS(self->long_press_ms)) {
                 event = BUTTON_EVENT_HELD;
@@ -81,15 +102,25 @@ static void button_debounce_callback(TimerHandle_t timer) {
             }
         }
 
-        self->last_state = current_state;
+        atomic_store(&self->last_state, current_state);
 
-        // Send event if queue is configured
-        if (self->event_queue) {
-            xQueueSend(self->event_queue, &event, 0);
-        }
+        // Queue and export the event; releases must not be lost
+        event_sink_post(&self->events, &event, event, !current_state);
     }
 
-    self->is_debouncing = false;
+    // Published last, so process() sees the state above once it may restart
+    atomic_store(&self->is_debouncing, false);
+}
+
+static void button_settle_expired(void *arg) {
+    button_handle_t *self = arg;
+
+    // The read the last process() call made may predate the filter settling
+    bool idle = false;
+    if (button_is_pressed(self) != atomic_load(&self->last_state) &&
+        atomic_compare_exchange_strong(&self->is_debouncing, &idle, true)) {
+        timeout_arm(&self->debounce, pdMS_TO_TICKS(self->debounce_ms));
+    }
 }
 
 static bool button_process(button_handle_t *self, button_event_t *event) {
@@ -97,19 +128,27 @@ static bool button_process(button_handle_t *self, button_event_t *event) {
 
     bool current_state = button_is_pressed(self);
 
-    // Check if state changed and not currently debouncing
-    if (current_state != self->last_state && !self->is_debouncing) {
-        self->is_debouncing = true;
-        xTimerStart(self->debounce_timer, 0);
+    // Check if state changed and not currently debouncing; only the task
+    // that claims is_debouncing arms the timeout. A pin debounced in
+    // hardware only reports settled levels, so the change is taken at once.
+    bool idle = false;
+    if (current_state != atomic_load(&self->last_state) &&
+        atomic_compare_exchange_strong(&self->is_debouncing, &idle, true)) {
+        if (self->pin_debounced) {
+            button_debounce_expired(self);
+        } else {
+            timeout_arm(&self->debounce, pdMS_TO_TICKS(self->debounce_ms));
+        }
+    } else if (self->settle_ticks && !atomic_load(&self->is_debouncing)) {
+        // Woken by a bounce the driver filter hid; each call pushes it out
+        timeout_arm(&self->settle, self->settle_ticks);
     }
 
-    // Check for long press while button is held
-    if (self->is_pressed && !self->is_debouncing) {
-        TickType_t press_duration = xTaskGetTickCount() - self->press_start_tick;
-        if (press_duration >= pdMS_TO_TICKS(self->long_press_ms)) {
-            *event = BUTTON_EVENT_HELD;
-            return true;
-        }
+    // Long press, flagged by the hold timeout while the button is held
+    if (atomic_load(&self->is_held) && atomic_load(&self->is_pressed) &&
+        !atomic_load(&self->is_debouncing)) {
+        *event = BUTTON_EVENT_HELD;
+        return true;
     }
 
     return false;
@@ -124,6 +163,10 @@ bool button_create(button_handle_t *handle) {
     handle->is_pressed = button_is_pressed;
     handle->process = button_process;
 
+    timeout_init(&handle->debounce, button_debounce_expired, handle);
+    timeout_init(&handle->settle, button_settle_expired, handle);
+    timeout_init(&handle->hold, button_hold_expired, handle);
+
     return true;
 }
 
@@ -0,0 +1,179 @@
+#include "components/encoder.h"
+#include <errno.h>
+#include <stdlib.h>
+#include "FreeRTOS.h"
+#include "queue.h"
+
+#define ENCODER_DEFAULT_VELOCITY_WINDOW_MS 100
+
+// Step for each (previous AB << 2 | current AB) transition, A leading B is +1.
+// Transitions where both inputs changed decode as 0 and count as errors.
+static const int8_t encoder_steps[16] = {
+     0, -1, +1,  0,
+    +1,  0,  0, -1,
+    -1,  0,  0, +1,
+     0, +1, -1,  0,
+};
+
+static void encoder_update(encoder_handle_t *self, bool a, bool b) {
+    if (!self) return;
+
+    uint8_t current = (uint8_t)((a ? 2 : 0) | (b ? 1 : 0));
+    uint8_t previous = self->state;
+    if (current == previous) return;
+
+    self->state = current;
+    if ((current ^ previous) == 3) {
+        atomic_fetch_add_explicit(&self->errors, 1, memory_order_relaxed);
+        return;
+    }
+
+    int8_t step = encoder_steps[(previous << 2) | current];
+    atomic_fetch_add_explicit(&self->position, step, memory_order_relaxed);
+
+    // Queue and export one event per detent
+    self->detent_steps += step;
+    while (self->detent_steps >= self->steps_per_detent) {
+        encoder_event_t event = ENCODER_EVENT_CW;
+        event_sink_post(&self->events, &event, event, false);
+        self->detent_steps -= self->steps_per_detent;
+    }
+    while (self->detent_steps <= -(int32_t)self->steps_per_detent) {
+        encoder_event_t event = ENCODER_EVENT_CCW;
+        event_sink_post(&self->events, &event, event, false);
+        self->detent_steps += self->steps_per_detent;
+    }
+}
+
+static void encoder_process(encoder_handle_t *self) {
+    if (!self) return;
+    encoder_update(self, gpio_read(&self->gpio_a), gpio_read(&self->gpio_b));
+}
+
+static void encoder_edge_callback(void *arg) {
+    encoder_process((encoder_handle_t *)arg);
+}
+
+static bool encoder_init(encoder_handle_t *self, const encoder_config_t *config) {
+    if (!self || !config) return false;
+
+    // Initialize GPIO
+    if (!gpio_init(&self->gpio_a, &config->gpio_a)) {
+        return false;
+    }
+    if (!gpio_init(&self->gpio_b, &config->gpio_b)) {
+        gpio_deinit(&self->gpio_a);
+        return false;
+    }
+
+    // Store configuration
+    self->event_queue = config->event_queue;
+    if (!event_sink_init(&self->events, config->event_queue, sizeof(encoder_event_t),
+                         config->overflow_policy)) {
+        gpio_deinit(&self->gpio_b);
+        gpio_deinit(&self->gpio_a);
+        return false;
+    }
+    event_sink_set_export(&self->events, EVENT_KIND_ENCODER, (uint16_t)config->gpio_a.pin);
+    self->steps_per_detent = config->steps_per_detent ? config->steps_per_detent : 1;
+    self->velocity_window = pdMS_TO_TICKS(config->velocity_window_ms
+                                              ? config->velocity_window_ms
+                                              : ENCODER_DEFAULT_VELOCITY_WINDOW_MS);
+
+    // Start from the current pin levels so the first edge decodes correctly
+    self->state = (uint8_t)((gpio_read(&self->gpio_a) ? 2 : 0) |
+                            (gpio_read(&self->gpio_b) ? 1 : 0));
+    self->detent_steps = 0;
+    atomic_init(&self->position, 0);
+    atomic_init(&self->errors, 0);
+    self->velocity = 0;
+    self->velocity_position = 0;
+    self->velocity_tick = xTaskGetTickCount();
+
+    if (config->use_interrupts) {
+        if (!gpio_set_interrupt(&self->gpio_a, encoder_edge_callback, self) ||
+            !gpio_set_interrupt(&self->gpio_b, encoder_edge_callback, self)) {
+            // Keep the backend's reason, e.g. ENOTSUP on Linux
+            int error = errno;
+            gpio_deinit(&self->gpio_b);
+            gpio_deinit(&self->gpio_a);
+            errno = error;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void encoder_deinit(encoder_handle_t *self) {
+    if (!self) return;
+
+    gpio_deinit(&self->gpio_b);
+    gpio_deinit(&self->gpio_a);
+}
+
+static int32_t encoder_get_position(encoder_handle_t *self) {
+    if (!self) return 0;
+    return (int32_t)atomic_load_explicit(&self->position, memory_order_relaxed);
+}
+
+static int32_t encoder_get_velocity(encoder_handle_t *self) {
+    if (!self) return 0;
+
+    // Recompute once per window, in between return the last value. Readers
+    // in several tasks must not close the same window twice or mix the
+    // fields of two windows.
+    taskENTER_CRITICAL();
+    TickType_t now = xTaskGetTickCount();
+    TickType_t elapsed = now - self->velocity_tick;
+    if (elapsed >= self->velocity_window && elapsed > 0) {
+        int32_t position = encoder_get_position(self);
+        self->velocity = (int32_t)((int64_t)(position - self->velocity_position) *
+                                   configTICK_RATE_HZ / elapsed);
+        self->velocity_position = position;
+        self->velocity_tick = now;
+    }
+    int32_t velocity = self->velocity;
+    taskEXIT_CRITICAL();
+
+    return velocity;
+}
+
+static void encoder_reset(encoder_handle_t *self) {
+    if (!self) return;
+
+    atomic_store(&self->position, 0);
+    self->detent_steps = 0;
+    taskENTER_CRITICAL();
+    self->velocity = 0;
+    self->velocity_position = 0;
+    self->velocity_tick = xTaskGetTickCount();
+    taskEXIT_CRITICAL();
+}
+
+bool encoder_create(encoder_handle_t *handle) {
+    if (!handle) return false;
+
+    // Initialize function pointers
+    handle->init = encoder_init;
+    handle->deinit = encoder_deinit;
+    handle->process = encoder_process;
+    handle->update = encoder_update;
+    handle->get_position = encoder_get_position;
+    handle->get_velocity = encoder_get_velocity;
+    handle->reset = encoder_reset;
+
+    return true;
+}
+
+void encoder_destroy(encoder_handle_t *handle) {
+    if (!handle) return;
+    if (handle->deinit) {
+        handle->deinit(handle);
+    }
+}
+
+const encoder_driver_t encoder_driver = {
+    .create = encoder_create,
+    .destroy = encoder_destroy
+};
@@ -0,0 +1,80 @@
+#include "components/event_export.h"
+#include "hal/hal_worker.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdatomic.h>
+
+static event_ring_writer_t writer;
+static atomic_bool exporting;
+
+// The ring has a single producer: tasks and native threads (HAL workers,
+// edge callbacks, loop callbacks) take turns on a spin lock. A task takes
+// it in a critical section so it is never switched out holding it; native
+// threads must not enter one, and hold it for one record at most.
+static atomic_flag producer = ATOMIC_FLAG_INIT;
+
+static bool event_export_lock(void) {
+    bool task = !hal_worker_is_native_thread() &&
+                xTaskGetSchedulerState() == taskSCHEDULER_RUNNING;
+    if (task) {
+        taskENTER_CRITICAL();
+    }
+    while (atomic_flag_test_and_set_explicit(&producer, memory_order_acquire)) {
+    }
+    return task;
+}
+
+static void event_export_unlock(bool task) {
+    atomic_flag_clear_explicit(&producer, memory_order_release);
+    if (task) {
+        taskEXIT_CRITICAL();
+    }
+}
+
+bool event_export_start(const char *name, uint32_t capacity) {
+    if (atomic_load(&exporting)) return false;
+    if (!event_ring_writer_create(&writer, name, capacity)) return false;
+
+    atomic_store(&exporting, true);
+    return true;
+}
+
+void event_export_stop(void) {
+    if (!atomic_load(&exporting)) return;
+
+    bool task = event_export_lock();
+    atomic_store(&exporting, false);
+    event_export_unlock(task);
+
+    event_ring_writer_destroy(&writer);
+}
+
+void event_export_publish(event_kind_t kind, uint16_t source, uint32_t code) {
+    if (!atomic_load(&exporting)) return;
+
+    bool task = event_export_lock();
+    if (atomic_load(&exporting)) {
+        event_ring_publish(&writer, (uint16_t)kind, source, code);
+    }
+    event_export_unlock(task);
+}
+
+static void event_export_edge(void *arg) {
+    event_export_edge_t *tap = arg;
+
+    event_export_publish(EVENT_KIND_GPIO_EDGE, tap->pin, gpio_read(tap->gpio));
+    if (tap->callback) {
+        tap->callback(tap->arg);
+    }
+}
+
+bool event_export_edges(event_export_edge_t *tap, gpio_handle_t *gpio, uint16_t pin,
+                        void (*callback)(void *arg), void *arg) {
+    if (!tap || !gpio) return false;
+
+    tap->gpio = gpio;
+    tap->pin = pin;
+    tap->callback = callback;
+    tap->arg = arg;
+    return gpio_set_interrupt(gpio, event_export_edge, tap);
+}
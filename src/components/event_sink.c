@@ -0,0 +1,111 @@
+#include "components/event_sink.h"
+#include "hal/hal_worker.h"
+#include "task.h"
+
+static void event_sink_count(atomic_uint_fast32_t *counter) {
+    atomic_fetch_add_explicit(counter, 1, memory_order_relaxed);
+}
+
+static bool event_sink_sent(event_sink_t *sink, uint32_t key) {
+    sink->last_key = key;
+    sink->has_last = true;
+    event_sink_count(&sink->sent);
+    return true;
+}
+
+bool event_sink_init(event_sink_t *sink, QueueHandle_t queue, size_t item_size,
+                     event_policy_t policy) {
+    if (!sink || item_size > EVENT_SINK_MAX_ITEM_SIZE) return false;
+
+    sink->queue = queue;
+    sink->policy = policy;
+    sink->item_size = item_size;
+    sink->has_last = false;
+    sink->last_key = 0;
+    sink->export_kind = 0;
+    sink->export_source = 0;
+    event_sink_reset_stats(sink);
+
+    return true;
+}
+
+void event_sink_set_export(event_sink_t *sink, event_kind_t kind, uint16_t source) {
+    if (!sink) return;
+
+    sink->export_kind = (uint16_t)kind;
+    sink->export_source = source;
+}
+
+bool event_sink_post(event_sink_t *sink, const void *event, uint32_t key, bool guaranteed) {
+    if (!sink || !event) return false;
+
+    // Exported regardless of what happens to it in the queue
+    if (sink->export_kind) {
+        event_export_publish((event_kind_t)sink->export_kind, sink->export_source, key);
+    }
+
+    if (!sink->queue) return false;
+
+    if (xQueueSend(sink->queue, event, 0) == pdPASS) {
+        return event_sink_sent(sink, key);
+    }
+
+    // Queue is full
+    if (sink->policy == EVENT_POLICY_COALESCE && sink->has_last && key == sink->last_key) {
+        event_sink_count(&sink->coalesced);
+        return true;
+    }
+
+    // A release must not push out another release: wait for the consumer
+    // instead, where blocking is allowed
+    if (guaranteed) {
+        bool task = !hal_worker_is_native_thread() &&
+                    xTaskGetSchedulerState() == taskSCHEDULER_RUNNING;
+        if (task &&
+            xQueueSend(sink->queue, event, pdMS_TO_TICKS(EVENT_SINK_GUARANTEED_WAIT_MS)) == pdPASS) {
+            return event_sink_sent(sink, key);
+        }
+        event_sink_count(&sink->lost);
+        return false;
+    }
+
+    if (sink->policy == EVENT_POLICY_DROP_NEWEST) {
+        event_sink_count(&sink->dropped);
+        return false;
+    }
+
+    // Make room by discarding the oldest event; another producer may take
+    // the slot first, so retry a bounded number of times
+    uint8_t oldest[EVENT_SINK_MAX_ITEM_SIZE];
+    for (int attempt = 0; attempt < EVENT_SINK_MAX_RETRIES; attempt++) {
+        if (xQueueReceive(sink->queue, oldest, 0) == pdPASS) {
+            event_sink_count(&sink->overwritten);
+        }
+        if (xQueueSend(sink->queue, event, 0) == pdPASS) {
+            return event_sink_sent(sink, key);
+        }
+    }
+
+    event_sink_count(&sink->dropped);
+    return false;
+}
+
+void event_sink_get_stats(event_sink_t *sink, event_sink_stats_t *stats) {
+    if (!sink || !stats) return;
+
+    stats->sent = (uint32_t)atomic_load_explicit(&sink->sent, memory_order_relaxed);
+    stats->dropped = (uint32_t)atomic_load_explicit(&sink->dropped, memory_order_relaxed);
+    stats->overwritten = (uint32_t)atomic_load_explicit(&sink->overwritten, memory_order_relaxed);
+    stats->coalesced = (uint32_t)atomic_load_explicit(&sink->coalesced, memory_order_relaxed);
+    stats->lost = (uint32_t)atomic_load_explicit(&sink->lost, memory_order_relaxed);
+}
+
+void event_sink_reset_stats(event_sink_t *sink) {
+    if (!sink) return;
+
+    atomic_store(&sink->sent, 0);
+    atomic_store(&sink->dropped, 0);
+    atomic_store(&sink->overwritten, 0);
+    atomic_store(&sink->coalesced, 0);
+    atomic_store(&sink->lost, 0);
+}
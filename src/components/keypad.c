@@ -0,0 +1,174 @@
+#include "components/keypad.h"
+#include <stdlib.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "queue.h"
+
+static uint32_t keypad_mask(uint8_t bits) {
+    return bits >= 32 ? UINT32_MAX : (1u << bits) - 1;
+}
+
+static bool keypad_init(keypad_handle_t *self, const keypad_config_t *config) {
+    if (!self || !config || !config->rows || !config->cols) return false;
+    if (config->rows->num_pins > KEYPAD_MAX_ROWS ||
+        config->cols->num_pins > KEYPAD_MAX_COLS) {
+        return false;
+    }
+
+    // Store configuration
+    self->rows = config->rows;
+    self->cols = config->cols;
+    self->num_rows = config->rows->num_pins;
+    self->num_cols = config->cols->num_pins;
+    self->active_low = config->active_low;
+    self->event_queue = config->event_queue;
+    if (!event_sink_init(&self->events, config->event_queue, sizeof(keypad_event_t),
+                         config->overflow_policy)) {
+        return false;
+    }
+    event_sink_set_export(&self->events, EVENT_KIND_KEYPAD, 0);
+    self->scan_period = pdMS_TO_TICKS(config->scan_interval_ms);
+    self->ghost_scans = 0;
+
+    // All keys released, all debounce counters idle
+    memset(self->pressed, 0, sizeof(self->pressed));
+    memset(self->count0, 0xff, sizeof(self->count0));
+    memset(self->count1, 0xff, sizeof(self->count1));
+
+    // Park all rows inactive
+    uint32_t all_rows = keypad_mask(self->num_rows);
+    if (!gpio_bank_write(self->rows, all_rows, self->active_low ? all_rows : 0)) {
+        return false;
+    }
+
+    if (config->scan_interval_ms) {
+        // Periodic scan on the shared timer service
+        if (!timer_service_start()) {
+            return false;
+        }
+        timeout_arm(&self->scan_timeout, self->scan_period);
+    }
+
+    return true;
+}
+
+static void keypad_deinit(keypad_handle_t *self) {
+    if (!self) return;
+
+    timeout_cancel(&self->scan_timeout);
+}
+
+static void keypad_send(keypad_handle_t *self, keypad_event_type_t type,
+                        uint8_t row, uint32_t cols) {
+    while (cols) {
+        uint8_t col = (uint8_t)__builtin_ctz(cols);
+        cols &= cols - 1;
+
+        keypad_event_t event = {
+            .type = type,
+            .key = (uint16_t)(row * self->num_cols + col),
+        };
+        event_sink_post(&self->events, &event, (uint32_t)type << 16 | event.key,
+                        type == KEYPAD_EVENT_RELEASED);
+    }
+}
+
+static bool keypad_scan(keypad_handle_t *self) {
+    if (!self) return false;
+
+    uint32_t all_rows = keypad_mask(self->num_rows);
+    uint32_t all_cols = keypad_mask(self->num_cols);
+    uint32_t raw[KEYPAD_MAX_ROWS];
+
+    // One bank write and one bank read per row
+    for (uint8_t row = 0; row < self->num_rows; row++) {
+        uint32_t drive = self->active_low ? all_rows & ~(1u << row) : 1u << row;
+        uint32_t cols;
+
+        if (!gpio_bank_write(self->rows, all_rows, drive) ||
+            !gpio_bank_read(self->cols, &cols)) {
+            return false;
+        }
+        raw[row] = (self->active_low ? ~cols : cols) & all_cols;
+    }
+
+    // Two rows sharing two or more columns form a rectangle in which one
+    // corner may be a ghost; freeze those keys for this scan
+    uint32_t ghost[KEYPAD_MAX_ROWS] = {0};
+    bool ghosting = false;
+    for (uint8_t r1 = 0; r1 < self->num_rows; r1++) {
+        for (uint8_t r2 = r1 + 1; r2 < self->num_rows; r2++) {
+            uint32_t common = raw[r1] & raw[r2];
+            if (common & (common - 1)) {
+                ghost[r1] |= common;
+                ghost[r2] |= common;
+                ghosting = true;
+            }
+        }
+    }
+    if (ghosting) {
+        self->ghost_scans++;
+    }
+
+    for (uint8_t row = 0; row < self->num_rows; row++) {
+        uint32_t sample = (raw[row] & ~ghost[row]) | (self->pressed[row] & ghost[row]);
+
+        // 2-bit vertical counters: a bit flips after 4 equal differing samples
+        uint32_t delta = sample ^ self->pressed[row];
+        self->count0[row] = ~(self->count0[row] & delta);
+        self->count1[row] = self->count0[row] ^ (self->count1[row] & delta);
+        uint32_t changed = delta & self->count0[row] & self->count1[row];
+        if (!changed) continue;
+
+        self->pressed[row] ^= changed;
+
+        // Queue and export the events
+        keypad_send(self, KEYPAD_EVENT_PRESSED, row, changed & self->pressed[row]);
+        keypad_send(self, KEYPAD_EVENT_RELEASED, row, changed & ~self->pressed[row]);
+    }
+
+    return true;
+}
+
+static void keypad_scan_expired(void *arg) {
+    keypad_handle_t *self = arg;
+
+    keypad_scan(self);
+    timeout_arm(&self->scan_timeout, self->scan_period);
+}
+
+static bool keypad_is_pressed(keypad_handle_t *self, uint16_t key) {
+    if (!self || !self->num_cols) return false;
+
+    uint16_t row = key / self->num_cols;
+    uint16_t col = key % self->num_cols;
+    if (row >= self->num_rows) return false;
+
+    return (self->pressed[row] >> col) & 1;
+}
+
+bool keypad_create(keypad_handle_t *handle) {
+    if (!handle) return false;
+
+    // Initialize function pointers
+    handle->init = keypad_init;
+    handle->deinit = keypad_deinit;
+    handle->scan = keypad_scan;
+    handle->is_pressed = keypad_is_pressed;
+
+    timeout_init(&handle->scan_timeout, keypad_scan_expired, handle);
+
+    return true;
+}
+
+void keypad_destroy(keypad_handle_t *handle) {
+    if (!handle) return;
+    if (handle->deinit) {
+        handle->deinit(handle);
+    }
+}
+
+const keypad_driver_t keypad_driver = {
+    .create = keypad_create,
+    .destroy = keypad_destroy
+};
@@ -0,0 +1,218 @@
+#include "core/event_ring.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+static size_t event_ring_size(uint32_t capacity) {
+  return sizeof(event_ring_t) + (size_t)capacity * sizeof(event_ring_slot_t);
+}
+
+static void event_ring_futex_wake(atomic_uint *word) {
+  syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+bool event_ring_writer_create(event_ring_writer_t *writer, const char *name,
+                              uint32_t capacity) {
+  if (!writer || !name || capacity == 0 || (capacity & (capacity - 1)) ||
+      strlen(name) >= sizeof(writer->name))
+    return false;
+
+  int fd = shm_open(name, O_CREAT | O_RDWR | O_TRUNC, 0644);
+  if (fd < 0)
+    return false;
+
+  size_t size = event_ring_size(capacity);
+  if (ftruncate(fd, (off_t)size) < 0) {
+    close(fd);
+    shm_unlink(name);
+    return false;
+  }
+
+  event_ring_t *ring =
+      mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (ring == MAP_FAILED) {
+    shm_unlink(name);
+    return false;
+  }
+
+  // The object is zero filled, so every slot reads as never written
+  ring->capacity = capacity;
+  ring->version = EVENT_RING_VERSION;
+  atomic_init(&ring->head, 0);
+  atomic_init(&ring->waiters, 0);
+  atomic_init(&ring->wake_seq, 0);
+  atomic_thread_fence(memory_order_release);
+  ring->magic = EVENT_RING_MAGIC;
+
+  writer->ring = ring;
+  writer->map_size = size;
+  strcpy(writer->name, name);
+
+  return true;
+}
+
+void event_ring_writer_destroy(event_ring_writer_t *writer) {
+  if (!writer || !writer->ring)
+    return;
+
+  // Wake sleeping readers so they notice the producer is gone
+  atomic_fetch_add(&writer->ring->wake_seq, 1);
+  event_ring_futex_wake(&writer->ring->wake_seq);
+
+  munmap(writer->ring, writer->map_size);
+  shm_unlink(writer->name);
+  writer->ring = NULL;
+}
+
+void event_ring_publish(event_ring_writer_t *writer, uint16_t kind,
+                        uint16_t source, uint32_t code) {
+  if (!writer || !writer->ring)
+    return;
+
+  event_ring_t *ring = writer->ring;
+  uint64_t seq = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  event_ring_slot_t *slot = &ring->slots[seq & (ring->capacity - 1)];
+
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  // Seqlock write: odd while the payload changes
+  atomic_store_explicit(&slot->lock, 2 * seq + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  atomic_store_explicit(&slot->time_ns,
+                        (uint64_t)now.tv_sec * 1000000000u + now.tv_nsec,
+                        memory_order_relaxed);
+  atomic_store_explicit(&slot->data,
+                        (uint64_t)kind << 48 | (uint64_t)source << 32 | code,
+                        memory_order_relaxed);
+  atomic_store_explicit(&slot->lock, 2 * seq + 2, memory_order_release);
+
+  // Pairs with the waiter count check in event_ring_wait()
+  atomic_store(&ring->head, seq + 1);
+  if (atomic_load(&ring->waiters)) {
+    atomic_fetch_add(&ring->wake_seq, 1);
+    event_ring_futex_wake(&ring->wake_seq);
+  }
+}
+
+bool event_ring_reader_open(event_ring_reader_t *reader, const char *name,
+                            bool tail) {
+  if (!reader || !name)
+    return false;
+
+  int fd = shm_open(name, O_RDWR, 0);
+  if (fd < 0)
+    return false;
+
+  // magic, version, capacity
+  uint32_t header[3];
+  if (pread(fd, header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+      header[0] != EVENT_RING_MAGIC || header[1] != EVENT_RING_VERSION ||
+      header[2] == 0 || (header[2] & (header[2] - 1))) {
+    close(fd);
+    return false;
+  }
+
+  // Readers only write the waiter count and the futex word
+  size_t size = event_ring_size(header[2]);
+  event_ring_t *ring =
+      mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (ring == MAP_FAILED)
+    return false;
+
+  uint64_t head = atomic_load(&ring->head);
+  reader->ring = ring;
+  reader->map_size = size;
+  reader->lost = 0;
+  if (tail)
+    reader->next = head;
+  else
+    reader->next = head > ring->capacity ? head - ring->capacity : 0;
+
+  return true;
+}
+
+void event_ring_reader_close(event_ring_reader_t *reader) {
+  if (!reader || !reader->ring)
+    return;
+
+  munmap(reader->ring, reader->map_size);
+  reader->ring = NULL;
+}
+
+bool event_ring_read(event_ring_reader_t *reader, event_record_t *record) {
+  if (!reader || !reader->ring || !record)
+    return false;
+
+  event_ring_t *ring = reader->ring;
+  for (;;) {
+    uint64_t seq = reader->next;
+    event_ring_slot_t *slot = &ring->slots[seq & (ring->capacity - 1)];
+
+    uint64_t lock = atomic_load_explicit(&slot->lock, memory_order_acquire);
+    uint64_t time_ns =
+        atomic_load_explicit(&slot->time_ns, memory_order_relaxed);
+    uint64_t data = atomic_load_explicit(&slot->data, memory_order_relaxed);
+    atomic_thread_fence(memory_order_acquire);
+    uint64_t check = atomic_load_explicit(&slot->lock, memory_order_relaxed);
+
+    if (lock == 2 * seq + 2 && check == lock) {
+      record->seq = seq;
+      record->time_ns = time_ns;
+      record->kind = (uint16_t)(data >> 48);
+      record->source = (uint16_t)(data >> 32);
+      record->code = (uint32_t)data;
+      reader->next = seq + 1;
+      return true;
+    }
+
+    // Not written yet, or still being written
+    if (check <= 2 * seq + 1)
+      return false;
+
+    // Completed while we copied, read it again
+    if (check == 2 * seq + 2)
+      continue;
+
+    // Overwritten: skip to the oldest record still in the ring
+    uint64_t head = atomic_load(&ring->head);
+    uint64_t oldest = head > ring->capacity ? head - ring->capacity : 0;
+    if (oldest <= seq)
+      oldest = seq + 1;
+    reader->lost += oldest - seq;
+    reader->next = oldest;
+  }
+}
+
+bool event_ring_wait(event_ring_reader_t *reader, int timeout_ms) {
+  if (!reader || !reader->ring)
+    return false;
+
+  event_ring_t *ring = reader->ring;
+  if (atomic_load(&ring->head) > reader->next)
+    return true;
+
+  // Announce the waiter before the final check, pairs with the producer
+  atomic_fetch_add(&ring->waiters, 1);
+  unsigned wake_seq = atomic_load(&ring->wake_seq);
+  bool ready = atomic_load(&ring->head) > reader->next;
+  if (!ready) {
+    struct timespec timeout = {.tv_sec = timeout_ms / 1000,
+                               .tv_nsec = (timeout_ms % 1000) * 1000000L};
+    syscall(SYS_futex, &ring->wake_seq, FUTEX_WAIT, wake_seq,
+            timeout_ms < 0 ? NULL : &timeout, NULL, 0);
+    ready = atomic_load(&ring->head) > reader->next;
+  }
+  atomic_fetch_sub(&ring->waiters, 1);
+
+  return ready;
+}
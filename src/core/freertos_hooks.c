@@ -1,6 +1,6 @@
 #include "FreeRTOS.h"
 #include "task.h"
-#include <stdio.h>
+#include "core/uni_log.h"
 #include <stdlib.h>
 
 /* Static memory for idle task */
@@ -32,14 +32,16 @@ void vApplicationGetTimerTaskMemory( StaticTask_t **ppxTimerTaskTCBBuffer,
 void vAssertCalled( const char * pcFile,
                     uint32_t ulLine )
 {
-    printf("ASSERT failed in %s, line %d\n", pcFile, ulLine);
+    UNI_LOG_ERROR("ASSERT failed in %s, line %u", pcFile, ulLine);
+    uni_log_flush();
     taskDISABLE_INTERRUPTS();
     abort();
 }
 
 void vApplicationMallocFailedHook( void )
 {
-    printf("Malloc failed!\n");
+    UNI_LOG_ERROR("Malloc failed!");
+    uni_log_flush();
     taskDISABLE_INTERRUPTS();
     abort();
 }
@@ -48,17 +50,32 @@ void vApplicationStackOverflowHook( TaskHandle_t xTask,
                                     const char * pcTaskName )
 {
     (void)xTask;
-    printf("Stack overflow in task %s\n", pcTaskName);
+    UNI_LOG_ERROR("Stack overflow in task %s", pcTaskName);
+    uni_log_flush();
     taskDISABLE_INTERRUPTS();
     abort();
 }
 
+/* Provided by the HAL worker pool when it is linked in */
+void hal_worker_tick_hook( void ) __attribute__( ( weak ) );
+
 void vApplicationTickHook( void )
 {
     /* Called for each RTOS tick. */
+    if( hal_worker_tick_hook )
+    {
+        hal_worker_tick_hook();
+    }
 }
 
+/* Provided by the real-time profile when it is linked in */
+void rt_profile_idle_hook( void ) __attribute__( ( weak ) );
+
 void vApplicationIdleHook( void )
 {
     /* Called when idle. */
+    if( rt_profile_idle_hook )
+    {
+        rt_profile_idle_hook();
+    }
 }
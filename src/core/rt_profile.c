@@ -0,0 +1,87 @@
+#include "core/rt_profile.h"
+#include "FreeRTOS.h"
+#include "config/linux_config.h"
+#include "hal/hal_worker.h"
+#include <alloca.h>
+#include <errno.h>
+#include <malloc.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Set once the tasks run under SCHED_FIFO
+static atomic_bool idle_sleep;
+
+bool rt_profile_apply_thread(pthread_t thread,
+                             const rt_thread_config_t *config) {
+  if (!config)
+    return false;
+  return hal_worker_sched_thread(thread, config->priority, config->cpus);
+}
+
+// Grow the heap by size and keep it: freed memory is never handed back to
+// the kernel and large blocks do not get their own mapping, so allocations
+// made later reuse resident, locked pages
+static bool rt_profile_reserve_heap(size_t size) {
+  if (!mallopt(M_TRIM_THRESHOLD, -1) || !mallopt(M_MMAP_MAX, 0))
+    return false;
+  if (!size)
+    return true;
+
+  char *reserve = malloc(size);
+  if (!reserve)
+    return false;
+
+  long page = sysconf(_SC_PAGESIZE);
+  for (size_t i = 0; i < size; i += page)
+    reserve[i] = 0;
+  free(reserve);
+  return true;
+}
+
+// Touch the stack below the caller, so the pages are mapped before the
+// scheduler starts
+static __attribute__((noinline)) void rt_profile_prefault_stack(size_t size) {
+  volatile char *stack = alloca(size);
+  long page = sysconf(_SC_PAGESIZE);
+  for (size_t i = 0; i < size; i += page)
+    stack[i] = 0;
+}
+
+bool rt_profile_apply(const rt_profile_config_t *config) {
+  rt_profile_config_t defaults = {
+      .lock_memory = RT_LOCK_MEMORY,
+      .heap_reserve = RT_HEAP_RESERVE_BYTES,
+      .stack_prefault = RT_STACK_PREFAULT_BYTES,
+      .scheduler = {RT_SCHED_PRIORITY, RT_SCHED_CPUS},
+      .hal_worker = {RT_HAL_WORKER_PRIORITY, RT_HAL_WORKER_CPUS},
+  };
+  if (!config)
+    config = &defaults;
+
+  // Future pages too: heap growth and thread stacks are locked and
+  // populated as they are mapped
+  if (config->lock_memory && mlockall(MCL_CURRENT | MCL_FUTURE) < 0)
+    return false;
+
+  if (!rt_profile_reserve_heap(config->heap_reserve)) {
+    errno = ENOMEM;
+    return false;
+  }
+  if (config->stack_prefault)
+    rt_profile_prefault_stack(config->stack_prefault);
+
+  if (!rt_profile_apply_thread(pthread_self(), &config->scheduler))
+    return false;
+  atomic_store(&idle_sleep, config->scheduler.priority != 0);
+
+  return hal_worker_set_sched(config->hal_worker.priority,
+                              config->hal_worker.cpus);
+}
+
+void rt_profile_idle_hook(void) {
+  // The tick signal interrupts the sleep, so nothing is woken late
+  if (atomic_load(&idle_sleep))
+    usleep(portTICK_PERIOD_MS * 1000);
+}
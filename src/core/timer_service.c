@@ -0,0 +1,313 @@
+#include "core/timer_service.h"
+
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_DUE TIMER_WHEEL_LEVELS
+#define TIMER_WHEEL_SPAN ((TickType_t)1 << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS))
+
+static struct {
+  timeout_t *slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+  uint64_t occupied[TIMER_WHEEL_LEVELS]; // Bit per non-empty slot
+
+  // Timeouts that came due, in expiry order, waiting for their callback
+  timeout_t *due;
+  timeout_t **due_tail;
+
+  TickType_t now;     // Last tick processed
+  uint32_t pending;   // Timeouts in the slots
+  uint32_t num_due;   // Timeouts on the due list
+  TaskHandle_t task;
+  const timer_service_clock_t *clock; // External driver instead of the task
+  TickType_t wake;    // Tick the driver sleeps until
+  bool wake_on_arm;   // The driver sleeps with nothing armed
+} wheel = {.due_tail = &wheel.due};
+
+static void wheel_link(timeout_t **head, timeout_t *timeout) {
+  timeout->next = *head;
+  if (timeout->next)
+    timeout->next->pprev = &timeout->next;
+  timeout->pprev = head;
+  *head = timeout;
+}
+
+static void wheel_unlink(timeout_t *timeout) {
+  *timeout->pprev = timeout->next;
+  if (timeout->next)
+    timeout->next->pprev = timeout->pprev;
+  if (wheel.due_tail == &timeout->next)
+    wheel.due_tail = timeout->pprev;
+  timeout->next = NULL;
+  timeout->pprev = NULL;
+
+  if (timeout->level == TIMER_WHEEL_DUE) {
+    wheel.num_due--;
+  } else {
+    wheel.pending--;
+    if (!wheel.slots[timeout->level][timeout->slot])
+      wheel.occupied[timeout->level] &= ~(1ull << timeout->slot);
+  }
+}
+
+// File the timeout by its distance from the current tick; a timeout due
+// now goes to the level 0 slot about to be collected
+static void wheel_insert(timeout_t *timeout) {
+  TickType_t delta = timeout->expires - wheel.now;
+  TickType_t at = timeout->expires;
+  if ((int32_t)delta < 0) {
+    delta = 0;
+    at = wheel.now;
+  } else if (delta >= TIMER_WHEEL_SPAN) {
+    // Beyond the top level: park in its furthest slot and re-file later
+    delta = TIMER_WHEEL_SPAN - 1;
+    at = wheel.now + delta;
+  }
+
+  uint8_t level = 0;
+  while (level < TIMER_WHEEL_LEVELS - 1 &&
+         delta >= (TickType_t)1 << (TIMER_WHEEL_BITS * (level + 1)))
+    level++;
+
+  uint8_t slot = (at >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK;
+  timeout->level = level;
+  timeout->slot = slot;
+  wheel_link(&wheel.slots[level][slot], timeout);
+  wheel.occupied[level] |= 1ull << slot;
+  wheel.pending++;
+}
+
+// Re-file every timeout of a coarse slot that the wheel has reached
+static void wheel_cascade(uint8_t level, uint8_t slot) {
+  timeout_t *timeout = wheel.slots[level][slot];
+  wheel.slots[level][slot] = NULL;
+  wheel.occupied[level] &= ~(1ull << slot);
+
+  while (timeout) {
+    timeout_t *next = timeout->next;
+    wheel.pending--;
+    wheel_insert(timeout);
+    timeout = next;
+  }
+}
+
+// Move the level 0 slot of the current tick to the end of the due list
+static void wheel_collect(void) {
+  uint8_t slot = wheel.now & TIMER_WHEEL_MASK;
+  timeout_t *timeout = wheel.slots[0][slot];
+  wheel.slots[0][slot] = NULL;
+  wheel.occupied[0] &= ~(1ull << slot);
+
+  while (timeout) {
+    timeout_t *next = timeout->next;
+    timeout->level = TIMER_WHEEL_DUE;
+    timeout->next = NULL;
+    timeout->pprev = wheel.due_tail;
+    *wheel.due_tail = timeout;
+    wheel.due_tail = &timeout->next;
+    wheel.pending--;
+    wheel.num_due++;
+    timeout = next;
+  }
+}
+
+// Ticks from now to the next tick with a slot to collect or cascade, 0 if
+// nothing is pending
+static TickType_t wheel_next_delta(void) {
+  if (!wheel.pending)
+    return 0;
+
+  uint8_t first = (wheel.now + 1) & TIMER_WHEEL_MASK;
+  uint64_t occupied = wheel.occupied[0];
+  uint64_t ahead =
+      first ? occupied >> first | occupied << (TIMER_WHEEL_SLOTS - first)
+            : occupied;
+  TickType_t delta =
+      ahead ? (TickType_t)__builtin_ctzll(ahead) + 1 : TIMER_WHEEL_SLOTS;
+
+  // Coarser levels cascade when level 0 wraps around
+  TickType_t wrap = TIMER_WHEEL_SLOTS - (wheel.now & TIMER_WHEEL_MASK);
+  for (uint8_t level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+    if (wheel.occupied[level] && wrap < delta)
+      delta = wrap;
+  }
+  return delta;
+}
+
+// Process one tick: cascade coarser levels whose slot starts here, top
+// down, then collect the timeouts due on it
+static void wheel_step(void) {
+  wheel.now++;
+
+  uint8_t top = 0;
+  while (top < TIMER_WHEEL_LEVELS - 1 &&
+         ((wheel.now >> (TIMER_WHEEL_BITS * top)) & TIMER_WHEEL_MASK) == 0)
+    top++;
+  for (uint8_t level = top; level > 0; level--)
+    wheel_cascade(level, (wheel.now >> (TIMER_WHEEL_BITS * level)) &
+                             TIMER_WHEEL_MASK);
+
+  wheel_collect();
+}
+
+static timeout_t *wheel_pop_due(void) {
+  timeout_t *timeout = wheel.due;
+  if (timeout)
+    wheel_unlink(timeout);
+  return timeout;
+}
+
+void timer_service_advance(TickType_t now) {
+  for (;;) {
+    // Jump over the ticks with nothing to collect or cascade
+    taskENTER_CRITICAL();
+    TickType_t delta = wheel_next_delta();
+    int32_t behind = (int32_t)(now - wheel.now);
+    bool stepped = delta && behind >= (int32_t)delta;
+    if (stepped) {
+      wheel.now += delta - 1;
+      wheel_step();
+    } else if (!delta || behind > 0) {
+      // An empty wheel may also be set back
+      wheel.now = now;
+    }
+    taskEXIT_CRITICAL();
+
+    // One callback pass for everything collected on that tick
+    for (;;) {
+      taskENTER_CRITICAL();
+      timeout_t *timeout = wheel_pop_due();
+      taskEXIT_CRITICAL();
+      if (!timeout)
+        break;
+      timeout->callback(timeout->arg);
+    }
+
+    if (!stepped)
+      return;
+  }
+}
+
+bool timer_service_next(TickType_t *delay) {
+  taskENTER_CRITICAL();
+  TickType_t delta = wheel_next_delta();
+  wheel.wake_on_arm = !delta;
+  if (delta) {
+    wheel.wake = wheel.now + delta;
+    TickType_t now = timer_service_now();
+    *delay = (int32_t)(wheel.wake - now) > 0 ? wheel.wake - now : 0;
+  }
+  taskEXIT_CRITICAL();
+  return delta != 0;
+}
+
+static void timer_service_task(void *unused) {
+  (void)unused;
+
+  for (;;) {
+    timer_service_advance(xTaskGetTickCount());
+
+    TickType_t wait;
+    if (!timer_service_next(&wait))
+      wait = portMAX_DELAY;
+    ulTaskNotifyTake(pdTRUE, wait);
+  }
+}
+
+bool timer_service_set_clock(const timer_service_clock_t *clock) {
+  if (wheel.task || (clock && wheel.clock))
+    return false;
+
+  taskENTER_CRITICAL();
+  wheel.clock = clock;
+  if (!wheel.pending)
+    wheel.now = timer_service_now();
+  taskEXIT_CRITICAL();
+  return true;
+}
+
+bool timer_service_start(void) {
+  if (wheel.task || wheel.clock)
+    return true;
+
+  taskENTER_CRITICAL();
+  if (!wheel.pending)
+    wheel.now = xTaskGetTickCount();
+  taskEXIT_CRITICAL();
+
+  return xTaskCreate(timer_service_task, "timer_svc", TIMER_SERVICE_STACK_DEPTH,
+                     NULL, TIMER_SERVICE_PRIORITY, &wheel.task) == pdPASS;
+}
+
+void timer_service_stop(void) {
+  if (!wheel.task)
+    return;
+
+  TaskHandle_t task = wheel.task;
+  wheel.task = NULL;
+  vTaskDelete(task);
+}
+
+TickType_t timer_service_now(void) {
+  if (wheel.clock)
+    return wheel.clock->now(wheel.clock->arg);
+  return wheel.task ? xTaskGetTickCount() : wheel.now;
+}
+
+uint32_t timer_service_armed(void) {
+  taskENTER_CRITICAL();
+  uint32_t armed = wheel.pending + wheel.num_due;
+  taskEXIT_CRITICAL();
+  return armed;
+}
+
+void timeout_init(timeout_t *timeout, timeout_callback_t callback, void *arg) {
+  timeout->next = NULL;
+  timeout->pprev = NULL;
+  timeout->expires = 0;
+  timeout->callback = callback;
+  timeout->arg = arg;
+}
+
+void timeout_arm(timeout_t *timeout, TickType_t delay) {
+  bool notify = false;
+
+  taskENTER_CRITICAL();
+  if (timeout->pprev)
+    wheel_unlink(timeout);
+
+  // An empty wheel has nothing to catch up on and can jump to the present
+  TickType_t now = timer_service_now();
+  if (!wheel.pending && (int32_t)(now - wheel.now) > 0)
+    wheel.now = now;
+
+  timeout->expires = now + (delay ? delay : 1);
+  if ((int32_t)(timeout->expires - wheel.now) <= 0)
+    timeout->expires = wheel.now + 1;
+  wheel_insert(timeout);
+
+  if ((wheel.task || wheel.clock) &&
+      (wheel.wake_on_arm || (int32_t)(timeout->expires - wheel.wake) < 0)) {
+    wheel.wake_on_arm = false;
+    wheel.wake = timeout->expires;
+    notify = true;
+  }
+  TaskHandle_t task = wheel.task;
+  const timer_service_clock_t *clock = wheel.clock;
+  taskEXIT_CRITICAL();
+
+  if (notify && task)
+    xTaskNotifyGive(task);
+  else if (notify && clock->wake)
+    clock->wake(clock->arg);
+}
+
+bool timeout_cancel(timeout_t *timeout) {
+  taskENTER_CRITICAL();
+  bool armed = timeout->pprev != NULL;
+  if (armed)
+    wheel_unlink(timeout);
+  taskEXIT_CRITICAL();
+  return armed;
+}
+
+bool timeout_is_armed(const timeout_t *timeout) {
+  return timeout->pprev != NULL;
+}
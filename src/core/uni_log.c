@@ -0,0 +1,469 @@
+#include "core/uni_log.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdalign.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define LOG_RING_MASK (LOG_RING_SLOTS - 1)
+#define LOG_BATCH_SIZE 1024
+#define LOG_RECORD_MAX (9 + UNI_LOG_MAX_ARGS * (1 + UNI_LOG_MAX_STRING))
+
+typedef struct {
+  // Sequence minus the slot index, so zeroed slots start out free
+  _Atomic uint32_t seq;
+  _Atomic uint32_t order; // Global position, for merging the rings
+  uni_log_site_t *site;
+  TickType_t tick;
+  uint8_t count;
+  uni_log_arg_t args[UNI_LOG_MAX_ARGS];
+} log_slot_t;
+
+// Bounded multi-producer multi-consumer queue: the owning task, native
+// threads and the tick hook may all write, the drain and uni_log_flush()
+// may both read
+typedef struct {
+  alignas(64) _Atomic uint32_t tail;
+  alignas(64) _Atomic uint32_t head;
+  atomic_uint dropped;
+  _Atomic uint32_t announced; // Binary session the task record went out in
+  char name[configMAX_TASK_NAME_LEN];
+  log_slot_t slots[LOG_RING_SLOTS];
+} log_ring_t;
+
+typedef struct {
+  uni_log_site_t *site;
+  uint8_t ring;
+  TickType_t tick;
+  uint8_t count;
+  uni_log_arg_t args[UNI_LOG_MAX_ARGS];
+} log_entry_t;
+
+typedef struct {
+  uint8_t data[LOG_BATCH_SIZE];
+  size_t len;
+} log_batch_t;
+
+static struct {
+  log_ring_t rings[LOG_MAX_RINGS]; // rings[0] is shared
+  atomic_uint claimed;             // Rings handed to tasks
+  atomic_uint order;
+  atomic_uint dropped;
+
+  int fd;
+  bool binary;
+  uint32_t session; // Binary log session, format ids restart with each
+  atomic_uint next_id;
+  TaskHandle_t task;
+  atomic_bool stopping;
+} logger = {.fd = STDOUT_FILENO};
+
+_Static_assert((LOG_RING_SLOTS & LOG_RING_MASK) == 0,
+               "LOG_RING_SLOTS must be a power of two");
+_Static_assert(LOG_MAX_RINGS <= 256, "ring index is a byte");
+
+static log_ring_t *log_ring(void) {
+  if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED)
+    return &logger.rings[0];
+
+  TaskHandle_t task = xTaskGetCurrentTaskHandle();
+  log_ring_t *ring = pvTaskGetThreadLocalStoragePointer(task, LOG_TLS_INDEX);
+  if (ring)
+    return ring;
+
+  // First message of this task: claim a ring, or share the first one. Rings
+  // are never given back; a deleted task keeps its ring, so tasks created
+  // after LOG_MAX_RINGS - 1 others have logged share rings[0]
+  unsigned index = atomic_fetch_add(&logger.claimed, 1) + 1;
+  if (index < LOG_MAX_RINGS) {
+    ring = &logger.rings[index];
+    strncpy(ring->name, pcTaskGetName(task), sizeof(ring->name) - 1);
+  } else {
+    ring = &logger.rings[0];
+  }
+  vTaskSetThreadLocalStoragePointer(task, LOG_TLS_INDEX, ring);
+  return ring;
+}
+
+void uni_log_write(uni_log_site_t *site, const uni_log_arg_t *args,
+                   uint8_t count) {
+  log_ring_t *ring = log_ring();
+
+  log_slot_t *slot;
+  uint32_t pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  for (;;) {
+    slot = &ring->slots[pos & LOG_RING_MASK];
+    uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire) +
+                   (pos & LOG_RING_MASK);
+    int32_t diff = (int32_t)(seq - pos);
+    if (diff == 0) {
+      if (atomic_compare_exchange_weak_explicit(&ring->tail, &pos, pos + 1,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed))
+        break;
+    } else if (diff < 0) {
+      // Full: the drain has not caught up
+      atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+      return;
+    } else {
+      pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    }
+  }
+
+  if (count > UNI_LOG_MAX_ARGS)
+    count = UNI_LOG_MAX_ARGS;
+  slot->site = site;
+  slot->tick = xTaskGetTickCount();
+  slot->count = count;
+  memcpy(slot->args, args, count * sizeof(*args));
+  atomic_store_explicit(
+      &slot->order,
+      atomic_fetch_add_explicit(&logger.order, 1, memory_order_relaxed),
+      memory_order_relaxed);
+  atomic_store_explicit(&slot->seq, pos + 1 - (pos & LOG_RING_MASK),
+                        memory_order_release);
+}
+
+// Take the oldest published message across the rings
+static bool log_take(log_entry_t *entry) {
+  unsigned rings = atomic_load(&logger.claimed) + 1;
+  if (rings > LOG_MAX_RINGS)
+    rings = LOG_MAX_RINGS;
+
+  for (;;) {
+    unsigned best = LOG_MAX_RINGS;
+    uint32_t best_pos = 0, best_order = 0;
+    for (unsigned i = 0; i < rings; i++) {
+      log_ring_t *ring = &logger.rings[i];
+      uint32_t pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+      log_slot_t *slot = &ring->slots[pos & LOG_RING_MASK];
+      uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire) +
+                     (pos & LOG_RING_MASK);
+      if (seq != pos + 1)
+        continue;
+
+      uint32_t order =
+          atomic_load_explicit(&slot->order, memory_order_relaxed);
+      if (best == LOG_MAX_RINGS || (int32_t)(order - best_order) < 0) {
+        best = i;
+        best_pos = pos;
+        best_order = order;
+      }
+    }
+    if (best == LOG_MAX_RINGS)
+      return false;
+
+    // Another consumer may have taken it meanwhile
+    log_ring_t *ring = &logger.rings[best];
+    uint32_t pos = best_pos;
+    if (!atomic_compare_exchange_strong_explicit(&ring->head, &pos, pos + 1,
+                                                 memory_order_relaxed,
+                                                 memory_order_relaxed))
+      continue;
+
+    log_slot_t *slot = &ring->slots[pos & LOG_RING_MASK];
+    entry->site = slot->site;
+    entry->ring = (uint8_t)best;
+    entry->tick = slot->tick;
+    entry->count = slot->count;
+    memcpy(entry->args, slot->args, slot->count * sizeof(*slot->args));
+    atomic_store_explicit(&slot->seq,
+                          pos + LOG_RING_SLOTS - (pos & LOG_RING_MASK),
+                          memory_order_release);
+    return true;
+  }
+}
+
+static void log_output(const void *data, size_t len) {
+  const uint8_t *bytes = data;
+  while (len) {
+    ssize_t written = write(logger.fd, bytes, len);
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+      return;
+    }
+    bytes += written;
+    len -= (size_t)written;
+  }
+}
+
+// Room for n more bytes, writing out what is buffered if needed
+static uint8_t *log_reserve(log_batch_t *batch, size_t n) {
+  if (batch->len + n > sizeof(batch->data)) {
+    log_output(batch->data, batch->len);
+    batch->len = 0;
+  }
+  return batch->data + batch->len;
+}
+
+static uint8_t *put_uint(uint8_t *p, uint64_t value, size_t len) {
+  for (size_t i = 0; i < len; i++, value >>= 8)
+    *p++ = (uint8_t)value;
+  return p;
+}
+
+static uint8_t *put_string(uint8_t *p, const char *text, size_t max,
+                           size_t len_bytes) {
+  size_t len = text ? strnlen(text, max) : 0;
+  p = put_uint(p, len, len_bytes);
+  if (len)
+    memcpy(p, text, len);
+  return p + len;
+}
+
+static const char *log_ring_name(const log_ring_t *ring) {
+  return ring->name[0] ? ring->name : NULL;
+}
+
+static void log_emit_dropped(log_batch_t *batch, uint8_t index,
+                             uint32_t dropped) {
+  if (logger.binary) {
+    uint8_t *p = log_reserve(batch, 6);
+    *p++ = UNI_LOG_RECORD_DROPPED;
+    p = put_uint(p, index, 1);
+    p = put_uint(p, dropped, 4);
+    batch->len = p - batch->data;
+    return;
+  }
+
+  uni_log_arg_t arg = {.u = dropped};
+  char *line = (char *)log_reserve(batch, UNI_LOG_MAX_LINE);
+  batch->len += uni_log_format_line(
+      line, UNI_LOG_MAX_LINE, UNI_LOG_LEVEL_WARN, xTaskGetTickCount(),
+      log_ring_name(&logger.rings[index]), "dropped %u messages", &arg, 1);
+}
+
+// Format id of the site in this session, writing its format record first
+static uint16_t log_format_id(log_batch_t *batch, uni_log_site_t *site) {
+  uint32_t id = atomic_load(&site->id);
+  if (id >> 16 == (logger.session & 0xffff))
+    return (uint16_t)id;
+
+  uint32_t assigned = (logger.session & 0xffff) << 16 |
+                      ((atomic_fetch_add(&logger.next_id, 1) + 1) & 0xffff);
+  if (!atomic_compare_exchange_strong(&site->id, &id, assigned))
+    return (uint16_t)id; // Another consumer defined it
+
+  size_t len = strlen(site->fmt);
+  if (len > UINT16_MAX)
+    len = UINT16_MAX;
+  uint8_t *p = log_reserve(batch, 6);
+  *p++ = UNI_LOG_RECORD_FORMAT;
+  p = put_uint(p, assigned & 0xffff, 2);
+  p = put_uint(p, site->level, 1);
+  p = put_uint(p, len, 2);
+  batch->len = p - batch->data;
+
+  // Long formats go out in pieces
+  for (size_t done = 0; done < len;) {
+    size_t chunk = len - done < LOG_BATCH_SIZE ? len - done : LOG_BATCH_SIZE;
+    memcpy(log_reserve(batch, chunk), site->fmt + done, chunk);
+    batch->len += chunk;
+    done += chunk;
+  }
+  return (uint16_t)assigned;
+}
+
+static void log_emit_binary(log_batch_t *batch, const log_entry_t *entry) {
+  log_ring_t *ring = &logger.rings[entry->ring];
+  if (atomic_exchange(&ring->announced, logger.session) != logger.session) {
+    uint8_t *p = log_reserve(batch, 3 + sizeof(ring->name));
+    *p++ = UNI_LOG_RECORD_TASK;
+    p = put_uint(p, entry->ring, 1);
+    p = put_string(p, log_ring_name(ring) ? ring->name : "-",
+                   sizeof(ring->name) - 1, 1);
+    batch->len = p - batch->data;
+  }
+
+  uint16_t id = log_format_id(batch, entry->site);
+
+  uni_log_arg_type_t types[UNI_LOG_MAX_ARGS];
+  int typed = uni_log_arg_types(entry->site->fmt, types, UNI_LOG_MAX_ARGS);
+
+  uint8_t *p = log_reserve(batch, LOG_RECORD_MAX);
+  *p++ = UNI_LOG_RECORD_MESSAGE;
+  p = put_uint(p, id, 2);
+  p = put_uint(p, entry->ring, 1);
+  p = put_uint(p, entry->tick, 4);
+  p = put_uint(p, entry->count, 1);
+  for (int i = 0; i < entry->count; i++) {
+    if (i < typed && types[i] == UNI_LOG_ARG_STRING)
+      p = put_string(p, entry->args[i].s, UNI_LOG_MAX_STRING, 1);
+    else
+      p = put_uint(p, entry->args[i].u, 8);
+  }
+  batch->len = p - batch->data;
+}
+
+static void log_emit(log_batch_t *batch, const log_entry_t *entry) {
+  if (logger.binary) {
+    log_emit_binary(batch, entry);
+    return;
+  }
+
+  char *line = (char *)log_reserve(batch, UNI_LOG_MAX_LINE);
+  batch->len += uni_log_format_line(
+      line, UNI_LOG_MAX_LINE, entry->site->level, entry->tick,
+      log_ring_name(&logger.rings[entry->ring]), entry->site->fmt, entry->args,
+      entry->count);
+}
+
+void uni_log_flush(void) {
+  log_batch_t batch;
+  batch.len = 0;
+
+  for (unsigned i = 0; i < LOG_MAX_RINGS; i++) {
+    uint32_t dropped = atomic_exchange(&logger.rings[i].dropped, 0);
+    if (dropped) {
+      atomic_fetch_add(&logger.dropped, dropped);
+      log_emit_dropped(&batch, (uint8_t)i, dropped);
+    }
+  }
+
+  log_entry_t entry;
+  while (log_take(&entry))
+    log_emit(&batch, &entry);
+
+  log_output(batch.data, batch.len);
+}
+
+uint32_t uni_log_dropped(void) {
+  uint32_t dropped = atomic_load(&logger.dropped);
+  for (unsigned i = 0; i < LOG_MAX_RINGS; i++)
+    dropped += atomic_load(&logger.rings[i].dropped);
+  return dropped;
+}
+
+static void log_drain_task(void *unused) {
+  (void)unused;
+
+  for (;;) {
+    uni_log_flush();
+    if (atomic_load(&logger.stopping)) {
+      atomic_store(&logger.stopping, false);
+      vTaskDelete(NULL);
+    }
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LOG_DRAIN_PERIOD_MS));
+  }
+}
+
+static speed_t log_baud(uint32_t baud_rate) {
+  switch (baud_rate) {
+  case 9600:
+    return B9600;
+  case 19200:
+    return B19200;
+  case 38400:
+    return B38400;
+  case 57600:
+    return B57600;
+  case 230400:
+    return B230400;
+  case 460800:
+    return B460800;
+  case 921600:
+    return B921600;
+  default:
+    return B115200;
+  }
+}
+
+static int log_open(const uni_log_config_t *config) {
+  switch (config->sink) {
+  case UNI_LOG_SINK_STDOUT:
+    return STDOUT_FILENO;
+  case UNI_LOG_SINK_FILE:
+    if (!config->path)
+      return -1;
+    return open(config->path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  case UNI_LOG_SINK_UART:
+    break;
+  default:
+    return -1;
+  }
+
+  const char *path = config->path ? config->path : DEBUG_UART;
+  int fd = open(path, O_WRONLY | O_NOCTTY | O_CLOEXEC);
+  if (fd < 0)
+    return -1;
+
+  // Raw output, so binary records pass unchanged
+  struct termios tio;
+  if (tcgetattr(fd, &tio) == 0) {
+    cfmakeraw(&tio);
+    cfsetospeed(&tio, log_baud(config->baud_rate));
+    cfsetispeed(&tio, log_baud(config->baud_rate));
+    tcsetattr(fd, TCSANOW, &tio);
+  }
+  return fd;
+}
+
+bool uni_log_start(const uni_log_config_t *config) {
+  if (logger.task)
+    return false;
+
+  uni_log_config_t defaults = {.sink = UNI_LOG_SINK_STDOUT};
+  if (!config)
+    config = &defaults;
+
+  int fd = log_open(config);
+  if (fd < 0)
+    return false;
+
+  // Messages logged before start go to the new sink
+  logger.fd = fd;
+  logger.binary = config->binary;
+  if (config->binary) {
+    logger.session++;
+    atomic_store(&logger.next_id, 0);
+
+    uint8_t header[8] = UNI_LOG_MAGIC;
+    header[4] = UNI_LOG_VERSION;
+    put_uint(&header[6], configTICK_RATE_HZ, 2);
+    log_output(header, sizeof(header));
+  }
+
+  if (xTaskCreate(log_drain_task, "log", UNI_LOG_DRAIN_STACK_DEPTH, NULL,
+                  UNI_LOG_DRAIN_PRIORITY, &logger.task) != pdPASS) {
+    logger.task = NULL;
+    if (fd != STDOUT_FILENO)
+      close(fd);
+    logger.fd = STDOUT_FILENO;
+    logger.binary = false;
+    return false;
+  }
+  return true;
+}
+
+void uni_log_stop(void) {
+  TaskHandle_t task = logger.task;
+  if (!task)
+    return;
+
+  // Let the drain finish its pass so no slot is left half read
+  if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+    atomic_store(&logger.stopping, true);
+    xTaskNotifyGive(task);
+    while (atomic_load(&logger.stopping))
+      vTaskDelay(1);
+  } else {
+    vTaskDelete(task);
+  }
+  logger.task = NULL;
+
+  uni_log_flush();
+  if (logger.fd != STDOUT_FILENO)
+    close(logger.fd);
+  logger.fd = STDOUT_FILENO;
+  logger.binary = false;
+}
+
+// Whatever is still queued when the process exits
+__attribute__((constructor)) static void log_flush_at_exit(void) {
+  atexit(uni_log_flush);
+}
@@ -0,0 +1,461 @@
+#include "core/uni_log_format.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+typedef enum {
+  LENGTH_NONE,
+  LENGTH_HH,
+  LENGTH_H,
+  LENGTH_L,
+  LENGTH_LL,
+  LENGTH_J,
+  LENGTH_Z,
+  LENGTH_T,
+  LENGTH_LONG_DOUBLE,
+} length_t;
+
+// One conversion specification, from its '%' to past the conversion
+typedef struct {
+  const char *start;
+  const char *length; // Where the length modifier starts
+  const char *end;
+  char conversion;
+  length_t length_kind;
+  bool star_width;
+  bool star_precision;
+} spec_t;
+
+static bool spec_parse(const char *fmt, spec_t *spec) {
+  const char *p = fmt + 1;
+  spec->start = fmt;
+  spec->star_width = false;
+  spec->star_precision = false;
+
+  while (*p && strchr("-+ #0'", *p))
+    p++;
+  if (*p == '*') {
+    spec->star_width = true;
+    p++;
+  }
+  while (*p >= '0' && *p <= '9')
+    p++;
+  if (*p == '.') {
+    p++;
+    if (*p == '*') {
+      spec->star_precision = true;
+      p++;
+    }
+    while (*p >= '0' && *p <= '9')
+      p++;
+  }
+
+  spec->length = p;
+  spec->length_kind = LENGTH_NONE;
+  switch (*p) {
+  case 'h':
+    spec->length_kind = p[1] == 'h' ? LENGTH_HH : LENGTH_H;
+    p += p[1] == 'h' ? 2 : 1;
+    break;
+  case 'l':
+    spec->length_kind = p[1] == 'l' ? LENGTH_LL : LENGTH_L;
+    p += p[1] == 'l' ? 2 : 1;
+    break;
+  case 'j':
+    spec->length_kind = LENGTH_J;
+    p++;
+    break;
+  case 'z':
+    spec->length_kind = LENGTH_Z;
+    p++;
+    break;
+  case 't':
+    spec->length_kind = LENGTH_T;
+    p++;
+    break;
+  case 'L':
+    spec->length_kind = LENGTH_LONG_DOUBLE;
+    p++;
+    break;
+  }
+
+  if (!*p || !strchr("diouxXcfFeEgGaAsp", *p))
+    return false;
+  spec->conversion = *p;
+  spec->end = p + 1;
+  return true;
+}
+
+static uni_log_arg_type_t spec_type(const spec_t *spec) {
+  switch (spec->conversion) {
+  case 's':
+    return UNI_LOG_ARG_STRING;
+  case 'p':
+    return UNI_LOG_ARG_POINTER;
+  case 'f':
+  case 'F':
+  case 'e':
+  case 'E':
+  case 'g':
+  case 'G':
+  case 'a':
+  case 'A':
+    return UNI_LOG_ARG_DOUBLE;
+  default:
+    return UNI_LOG_ARG_INT;
+  }
+}
+
+int uni_log_arg_types(const char *fmt, uni_log_arg_type_t *types, int max) {
+  int count = 0;
+  for (const char *p = fmt; *p; p++) {
+    if (*p != '%')
+      continue;
+    if (p[1] == '%') {
+      p++;
+      continue;
+    }
+
+    spec_t spec;
+    if (!spec_parse(p, &spec))
+      continue;
+    if (spec.star_width && count++ < max)
+      types[count - 1] = UNI_LOG_ARG_INT;
+    if (spec.star_precision && count++ < max)
+      types[count - 1] = UNI_LOG_ARG_INT;
+    if (count++ < max)
+      types[count - 1] = spec_type(&spec);
+    p = spec.end - 1;
+  }
+  return count;
+}
+
+static long long narrow_signed(int64_t value, length_t length) {
+  switch (length) {
+  case LENGTH_HH:
+    return (signed char)value;
+  case LENGTH_H:
+    return (short)value;
+  case LENGTH_NONE:
+    return (int)value;
+  case LENGTH_L:
+    return (long)value;
+  case LENGTH_Z:
+    return (ssize_t)value;
+  case LENGTH_T:
+    return (ptrdiff_t)value;
+  default:
+    return (long long)value;
+  }
+}
+
+static unsigned long long narrow_unsigned(uint64_t value, length_t length) {
+  switch (length) {
+  case LENGTH_HH:
+    return (unsigned char)value;
+  case LENGTH_H:
+    return (unsigned short)value;
+  case LENGTH_NONE:
+    return (unsigned)value;
+  case LENGTH_L:
+    return (unsigned long)value;
+  case LENGTH_Z:
+    return (size_t)value;
+  default:
+    return (unsigned long long)value;
+  }
+}
+
+typedef struct {
+  char *buf;
+  size_t size;
+  size_t len;
+} output_t;
+
+static void output_advance(output_t *out, int written) {
+  if (written <= 0)
+    return;
+  out->len += (size_t)written;
+  if (out->len >= out->size)
+    out->len = out->size - 1;
+}
+
+static void output_char(output_t *out, char c) {
+  if (out->len + 1 < out->size) {
+    out->buf[out->len++] = c;
+    out->buf[out->len] = '\0';
+  }
+}
+
+static void output_text(output_t *out, const char *text) {
+  while (*text)
+    output_char(out, *text++);
+}
+
+size_t uni_log_format(char *buf, size_t size, const char *fmt,
+                      const uni_log_arg_t *args, int count) {
+  if (!size)
+    return 0;
+
+  output_t out = {buf, size, 0};
+  buf[0] = '\0';
+  int next = 0;
+
+  for (const char *p = fmt; *p; p++) {
+    spec_t spec;
+    if (*p != '%' || p[1] == '%' || !spec_parse(p, &spec)) {
+      output_char(&out, *p);
+      if (*p == '%' && p[1] == '%')
+        p++;
+      continue;
+    }
+    p = spec.end - 1;
+
+    int needed = 1 + spec.star_width + spec.star_precision;
+    if (next + needed > count) {
+      output_text(&out, "<?>");
+      next = count;
+      continue;
+    }
+
+    // Rebuild the spec with * resolved and the length fixed for the value
+    char text[48];
+    size_t len = 0;
+    for (const char *s = spec.start; s < spec.length && len < 24; s++) {
+      if (*s == '*')
+        len += snprintf(text + len, sizeof(text) - len, "%d",
+                        (int)args[next++].i);
+      else
+        text[len++] = *s;
+    }
+
+    const uni_log_arg_t *arg = &args[next++];
+    int written;
+    switch (spec.conversion) {
+    case 'd':
+    case 'i':
+      snprintf(text + len, sizeof(text) - len, "ll%c", spec.conversion);
+      written = snprintf(out.buf + out.len, out.size - out.len, text,
+                         narrow_signed(arg->i, spec.length_kind));
+      break;
+    case 'o':
+    case 'u':
+    case 'x':
+    case 'X':
+      snprintf(text + len, sizeof(text) - len, "ll%c", spec.conversion);
+      written = snprintf(out.buf + out.len, out.size - out.len, text,
+                         narrow_unsigned(arg->u, spec.length_kind));
+      break;
+    case 'c':
+      snprintf(text + len, sizeof(text) - len, "c");
+      written = snprintf(out.buf + out.len, out.size - out.len, text,
+                         (int)(unsigned char)arg->u);
+      break;
+    case 's':
+      snprintf(text + len, sizeof(text) - len, "s");
+      written = snprintf(out.buf + out.len, out.size - out.len, text,
+                         arg->s ? arg->s : "(null)");
+      break;
+    case 'p':
+      snprintf(text + len, sizeof(text) - len, "p");
+      written =
+          snprintf(out.buf + out.len, out.size - out.len, text, arg->p);
+      break;
+    default:
+      snprintf(text + len, sizeof(text) - len, "%c", spec.conversion);
+      written =
+          snprintf(out.buf + out.len, out.size - out.len, text, arg->d);
+      break;
+    }
+    output_advance(&out, written);
+  }
+  return out.len;
+}
+
+const char *uni_log_level_name(uint8_t level) {
+  switch (level) {
+  case UNI_LOG_LEVEL_DEBUG:
+    return "DEBUG";
+  case UNI_LOG_LEVEL_INFO:
+    return "INFO";
+  case UNI_LOG_LEVEL_WARN:
+    return "WARN";
+  case UNI_LOG_LEVEL_ERROR:
+    return "ERROR";
+  }
+  return "?";
+}
+
+size_t uni_log_format_line(char *buf, size_t size, uint8_t level,
+                           uint32_t tick, const char *task, const char *fmt,
+                           const uni_log_arg_t *args, int count) {
+  if (size < 2)
+    return 0;
+
+  // Leave room for the newline even when the message is cut short
+  output_t out = {buf, size - 1, 0};
+  output_advance(&out, snprintf(buf, out.size, "%10lu %-5s %-12s ",
+                                (unsigned long)tick, uni_log_level_name(level),
+                                task ? task : "-"));
+  out.len += uni_log_format(buf + out.len, out.size - out.len, fmt, args,
+                            count);
+  buf[out.len++] = '\n';
+  buf[out.len] = '\0';
+  return out.len;
+}
+
+// Binary reader
+
+static bool read_bytes(uni_log_reader_t *reader, void *data, size_t len) {
+  return fread(data, 1, len, reader->file) == len;
+}
+
+static bool read_uint(uni_log_reader_t *reader, size_t len, uint64_t *value) {
+  uint8_t bytes[8];
+  if (!read_bytes(reader, bytes, len))
+    return false;
+
+  *value = 0;
+  for (size_t i = len; i > 0; i--)
+    *value = *value << 8 | bytes[i - 1];
+  return true;
+}
+
+static char *read_string(uni_log_reader_t *reader, size_t len) {
+  char *text = malloc(len + 1);
+  if (!text || !read_bytes(reader, text, len)) {
+    free(text);
+    return NULL;
+  }
+  text[len] = '\0';
+  return text;
+}
+
+bool uni_log_reader_open(uni_log_reader_t *reader, FILE *file) {
+  memset(reader, 0, sizeof(*reader));
+  reader->file = file;
+
+  char magic[4];
+  uint64_t version, tick_rate;
+  if (!read_bytes(reader, magic, sizeof(magic)) ||
+      memcmp(magic, UNI_LOG_MAGIC, sizeof(magic)) != 0 ||
+      !read_uint(reader, 1, &version) || version != UNI_LOG_VERSION ||
+      fgetc(file) == EOF || !read_uint(reader, 2, &tick_rate))
+    return false;
+
+  reader->tick_rate = (uint16_t)tick_rate;
+  return true;
+}
+
+void uni_log_reader_close(uni_log_reader_t *reader) {
+  for (size_t i = 0; i < reader->num_formats; i++)
+    free(reader->formats[i]);
+  for (size_t i = 0; i < 256; i++)
+    free(reader->tasks[i]);
+  free(reader->formats);
+  free(reader->levels);
+  memset(reader, 0, sizeof(*reader));
+}
+
+static bool read_format(uni_log_reader_t *reader) {
+  uint64_t id, level, len;
+  if (!read_uint(reader, 2, &id) || !read_uint(reader, 1, &level) ||
+      !read_uint(reader, 2, &len))
+    return false;
+
+  if (id >= reader->num_formats) {
+    size_t num = id + 1;
+    char **formats = realloc(reader->formats, num * sizeof(*formats));
+    if (!formats)
+      return false;
+    reader->formats = formats;
+    uint8_t *levels = realloc(reader->levels, num);
+    if (!levels)
+      return false;
+    reader->levels = levels;
+    for (size_t i = reader->num_formats; i < num; i++)
+      reader->formats[i] = NULL;
+    reader->num_formats = num;
+  }
+
+  char *fmt = read_string(reader, len);
+  if (!fmt)
+    return false;
+  free(reader->formats[id]);
+  reader->formats[id] = fmt;
+  reader->levels[id] = (uint8_t)level;
+  return true;
+}
+
+static bool read_task(uni_log_reader_t *reader) {
+  uint64_t ring, len;
+  if (!read_uint(reader, 1, &ring) || !read_uint(reader, 1, &len))
+    return false;
+
+  char *name = read_string(reader, len);
+  if (!name)
+    return false;
+  free(reader->tasks[ring]);
+  reader->tasks[ring] = name;
+  return true;
+}
+
+static bool read_message(uni_log_reader_t *reader,
+                         uni_log_message_t *message) {
+  uint64_t id, ring, tick, count;
+  if (!read_uint(reader, 2, &id) || !read_uint(reader, 1, &ring) ||
+      !read_uint(reader, 4, &tick) || !read_uint(reader, 1, &count) ||
+      id >= reader->num_formats || !reader->formats[id] ||
+      count > UNI_LOG_MAX_ARGS)
+    return false;
+
+  message->fmt = reader->formats[id];
+  message->level = reader->levels[id];
+  message->task = reader->tasks[ring];
+  message->tick = (uint32_t)tick;
+  message->count = (uint8_t)count;
+
+  uni_log_arg_type_t types[UNI_LOG_MAX_ARGS];
+  int typed = uni_log_arg_types(message->fmt, types, UNI_LOG_MAX_ARGS);
+  for (int i = 0; i < (int)count; i++) {
+    if (i < typed && types[i] == UNI_LOG_ARG_STRING) {
+      uint64_t len;
+      if (!read_uint(reader, 1, &len) ||
+          !read_bytes(reader, message->strings[i], len))
+        return false;
+      message->strings[i][len] = '\0';
+      message->args[i].s = message->strings[i];
+    } else if (!read_uint(reader, 8, &message->args[i].u)) {
+      return false;
+    } else if (i < typed && types[i] == UNI_LOG_ARG_POINTER) {
+      message->args[i].p = (const void *)(uintptr_t)message->args[i].u;
+    }
+  }
+  return true;
+}
+
+bool uni_log_reader_next(uni_log_reader_t *reader,
+                         uni_log_message_t *message) {
+  for (;;) {
+    uint64_t ring, dropped;
+    switch (fgetc(reader->file)) {
+    case UNI_LOG_RECORD_FORMAT:
+      if (!read_format(reader))
+        return false;
+      break;
+    case UNI_LOG_RECORD_TASK:
+      if (!read_task(reader))
+        return false;
+      break;
+    case UNI_LOG_RECORD_DROPPED:
+      if (!read_uint(reader, 1, &ring) || !read_uint(reader, 4, &dropped))
+        return false;
+      reader->dropped += dropped;
+      break;
+    case UNI_LOG_RECORD_MESSAGE:
+      return read_message(reader, message);
+    default:
+      return false;
+    }
+  }
+}
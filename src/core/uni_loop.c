@@ -0,0 +1,325 @@
+#include "core/uni_loop.h"
+#include "hal/gpio_linux.h"
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#define UNI_LOOP_MAX_EVENTS 16
+
+static TickType_t uni_loop_clock_now(void *arg) {
+  (void)arg;
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  uint64_t ms = (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+  return (TickType_t)(ms * configTICK_RATE_HZ / 1000);
+}
+
+static void uni_loop_signal(uni_loop_t *loop) {
+  uint64_t one = 1;
+  ssize_t ret = write(loop->wake_fd, &one, sizeof(one));
+  (void)ret; // Only fails when the counter is already non-zero
+}
+
+// A timeout armed earlier than the loop sleeps; the loop thread itself
+// recomputes its wait after every dispatch
+static void uni_loop_clock_wake(void *arg) {
+  uni_loop_t *loop = arg;
+  if (!pthread_equal(pthread_self(), loop->thread))
+    uni_loop_signal(loop);
+}
+
+bool uni_loop_init(uni_loop_t *loop) {
+  if (!loop)
+    return false;
+
+  loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (loop->epoll_fd < 0)
+    return false;
+
+  loop->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  struct epoll_event event = {.events = EPOLLIN, .data.fd = loop->wake_fd};
+  if (loop->wake_fd < 0 ||
+      epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, loop->wake_fd, &event) < 0) {
+    if (loop->wake_fd >= 0)
+      close(loop->wake_fd);
+    close(loop->epoll_fd);
+    return false;
+  }
+
+  loop->thread = pthread_self();
+  atomic_init(&loop->running, false);
+  loop->sources = NULL;
+  loop->dispatch_seq = 0;
+  loop->stats = (uni_loop_stats_t){0};
+
+  // Another loop or the service task may already own the timer service
+  loop->clock = (timer_service_clock_t){
+      .now = uni_loop_clock_now,
+      .wake = uni_loop_clock_wake,
+      .arg = loop,
+  };
+  loop->drives_timers = timer_service_set_clock(&loop->clock);
+  return true;
+}
+
+void uni_loop_deinit(uni_loop_t *loop) {
+  if (!loop)
+    return;
+
+  while (loop->sources)
+    uni_loop_remove(loop->sources);
+
+  if (loop->drives_timers)
+    timer_service_set_clock(NULL);
+  close(loop->wake_fd);
+  close(loop->epoll_fd);
+}
+
+// Events wanted on fd by every source registered on it
+static uint32_t uni_loop_fd_events(uni_loop_t *loop, int fd) {
+  uint32_t events = 0;
+  for (uni_loop_source_t *it = loop->sources; it; it = it->next) {
+    if (it->fd == fd)
+      events |= it->events;
+  }
+  return events;
+}
+
+static bool uni_loop_add(uni_loop_t *loop, uni_loop_source_t *source,
+                         uni_loop_source_kind_t kind, int fd, uint32_t events,
+                         uni_loop_callback_t callback, void *arg) {
+  // Lines of one character device request share its descriptor
+  uint32_t shared = uni_loop_fd_events(loop, fd);
+  struct epoll_event event = {.events = shared | events, .data.fd = fd};
+  if (epoll_ctl(loop->epoll_fd, shared ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd,
+                &event) < 0)
+    return false;
+
+  source->loop = loop;
+  source->kind = kind;
+  source->fd = fd;
+  source->events = events;
+  source->callback = callback;
+  source->arg = arg;
+  source->dispatch_seq = loop->dispatch_seq;
+  source->next = loop->sources;
+  loop->sources = source;
+  return true;
+}
+
+bool uni_loop_add_gpio(uni_loop_t *loop, uni_loop_source_t *source,
+                       gpio_handle_t *gpio, uni_loop_callback_t callback,
+                       void *arg) {
+  if (!loop || !source || !gpio || !callback)
+    return false;
+
+  short events;
+  int fd = linux_gpio_edge_fd(gpio, &events);
+  if (fd < 0)
+    return false;
+
+  // poll(2) and epoll share the event bit values
+  source->gpio = gpio;
+  return uni_loop_add(loop, source, UNI_LOOP_SOURCE_GPIO, fd,
+                      (uint32_t)(uint16_t)events, callback, arg);
+}
+
+bool uni_loop_add_timer(uni_loop_t *loop, uni_loop_source_t *source,
+                        uint32_t first_ms, uint32_t period_ms,
+                        uni_loop_callback_t callback, void *arg) {
+  if (!loop || !source || !callback)
+    return false;
+
+  int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (fd < 0)
+    return false;
+
+  // A zero it_value disarms, so an immediate timer fires after 1 ns
+  struct itimerspec spec = {
+      .it_interval = {period_ms / 1000, (period_ms % 1000) * 1000000L},
+      .it_value = {first_ms / 1000, (first_ms % 1000) * 1000000L},
+  };
+  if (!first_ms)
+    spec.it_value.tv_nsec = 1;
+
+  source->gpio = NULL;
+  if (timerfd_settime(fd, 0, &spec, NULL) < 0 ||
+      !uni_loop_add(loop, source, UNI_LOOP_SOURCE_TIMER, fd, EPOLLIN, callback,
+                    arg)) {
+    close(fd);
+    return false;
+  }
+  return true;
+}
+
+bool uni_loop_add_wakeup(uni_loop_t *loop, uni_loop_source_t *source,
+                         uni_loop_callback_t callback, void *arg) {
+  if (!loop || !source || !callback)
+    return false;
+
+  int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (fd < 0)
+    return false;
+
+  source->gpio = NULL;
+  if (!uni_loop_add(loop, source, UNI_LOOP_SOURCE_WAKEUP, fd, EPOLLIN,
+                    callback, arg)) {
+    close(fd);
+    return false;
+  }
+  return true;
+}
+
+bool uni_loop_wake(uni_loop_source_t *source) {
+  if (!source || source->kind != UNI_LOOP_SOURCE_WAKEUP)
+    return false;
+
+  uint64_t one = 1;
+  return write(source->fd, &one, sizeof(one)) == sizeof(one);
+}
+
+bool uni_loop_add_fd(uni_loop_t *loop, uni_loop_source_t *source, int fd,
+                     uint32_t events, uni_loop_callback_t callback,
+                     void *arg) {
+  if (!loop || !source || fd < 0 || !events || !callback)
+    return false;
+
+  source->gpio = NULL;
+  return uni_loop_add(loop, source, UNI_LOOP_SOURCE_FD, fd, events, callback,
+                      arg);
+}
+
+void uni_loop_remove(uni_loop_source_t *source) {
+  if (!source || !source->loop)
+    return;
+
+  uni_loop_t *loop = source->loop;
+  for (uni_loop_source_t **it = &loop->sources; *it; it = &(*it)->next) {
+    if (*it == source) {
+      *it = source->next;
+      break;
+    }
+  }
+  source->loop = NULL;
+  source->next = NULL;
+
+  uint32_t events = uni_loop_fd_events(loop, source->fd);
+  struct epoll_event event = {.events = events, .data.fd = source->fd};
+  epoll_ctl(loop->epoll_fd, events ? EPOLL_CTL_MOD : EPOLL_CTL_DEL, source->fd,
+            &event);
+
+  // Timer and wakeup descriptors belong to the loop
+  if (source->kind == UNI_LOOP_SOURCE_TIMER ||
+      source->kind == UNI_LOOP_SOURCE_WAKEUP)
+    close(source->fd);
+}
+
+// Consume the event that woke the source; false if there was none
+static bool uni_loop_consume(uni_loop_source_t *source) {
+  uint64_t count;
+  switch (source->kind) {
+  case UNI_LOOP_SOURCE_TIMER:
+  case UNI_LOOP_SOURCE_WAKEUP:
+    return read(source->fd, &count, sizeof(count)) == sizeof(count);
+  case UNI_LOOP_SOURCE_GPIO:
+    linux_gpio_edge_ack(source->gpio);
+    return true;
+  default:
+    return true;
+  }
+}
+
+// Run the callback of every source registered on fd once. Callbacks may add
+// or remove sources, so the walk restarts after each one and the dispatch
+// sequence marks the sources already handled.
+static int uni_loop_dispatch(uni_loop_t *loop, int fd, uint32_t events) {
+  int dispatched = 0;
+  uint64_t seq = ++loop->dispatch_seq;
+
+  for (uni_loop_source_t *it = loop->sources; it;) {
+    bool wanted = it->events & events || events & (EPOLLERR | EPOLLHUP);
+    if (it->fd != fd || it->dispatch_seq == seq || !wanted) {
+      it = it->next;
+      continue;
+    }
+
+    it->dispatch_seq = seq;
+    if (uni_loop_consume(it)) {
+      it->callback(it, it->arg);
+      dispatched++;
+    }
+    it = loop->sources;
+  }
+  return dispatched;
+}
+
+// Milliseconds until the next timeout, rounded up, or -1
+static int uni_loop_timer_wait(uni_loop_t *loop) {
+  TickType_t ticks;
+  if (!loop->drives_timers || !timer_service_next(&ticks))
+    return -1;
+
+  uint64_t ms = ((uint64_t)ticks * 1000 + configTICK_RATE_HZ - 1) /
+                configTICK_RATE_HZ;
+  return ms > INT32_MAX ? INT32_MAX : (int)ms;
+}
+
+int uni_loop_run_once(uni_loop_t *loop, int timeout_ms) {
+  if (!loop)
+    return -1;
+
+  loop->thread = pthread_self();
+
+  int wait = uni_loop_timer_wait(loop);
+  if (wait < 0 || (timeout_ms >= 0 && timeout_ms < wait))
+    wait = timeout_ms;
+
+  struct epoll_event events[UNI_LOOP_MAX_EVENTS];
+  int ready = epoll_wait(loop->epoll_fd, events, UNI_LOOP_MAX_EVENTS, wait);
+  if (ready < 0)
+    return errno == EINTR ? 0 : -1;
+  loop->stats.wakeups++;
+
+  int dispatched = 0;
+  for (int i = 0; i < ready; i++) {
+    if (events[i].data.fd == loop->wake_fd) {
+      uint64_t count;
+      ssize_t ret = read(loop->wake_fd, &count, sizeof(count));
+      (void)ret;
+      continue;
+    }
+    dispatched += uni_loop_dispatch(loop, events[i].data.fd, events[i].events);
+  }
+  loop->stats.dispatched += dispatched;
+
+  // Timeouts run after the sources, so an edge and the debounce it arms
+  // are seen in order
+  if (loop->drives_timers)
+    timer_service_advance(uni_loop_clock_now(NULL));
+
+  return dispatched;
+}
+
+bool uni_loop_run(uni_loop_t *loop) {
+  if (!loop)
+    return false;
+
+  atomic_store(&loop->running, true);
+  while (atomic_load(&loop->running)) {
+    if (uni_loop_run_once(loop, -1) < 0)
+      return false;
+  }
+  return true;
+}
+
+// Safe from other threads and signal handlers
+void uni_loop_stop(uni_loop_t *loop) {
+  if (!loop)
+    return;
+
+  atomic_store(&loop->running, false);
+  uni_loop_signal(loop);
+}
@@ -0,0 +1,192 @@
+#include "hal/gpio_bank.h"
+#include <string.h>
+
+static uint32_t gpio_bank_all(const gpio_bank_t *bank) {
+  return bank->num_pins == 32 ? UINT32_MAX : (1u << bank->num_pins) - 1;
+}
+
+static uint64_t gpio_bank_pack(uint32_t high, uint32_t low) {
+  return (uint64_t)high << 32 | low;
+}
+
+// Write bits to the pins in mask, returns the pins actually written
+static uint32_t gpio_bank_hw_write(gpio_bank_t *bank, uint32_t mask,
+                                   uint32_t bits) {
+  if (bank->ops && bank->ops->write)
+    return bank->ops->write(bank, mask, bits & mask) ? mask : 0;
+
+  uint32_t written = 0;
+  for (uint8_t i = 0; i < bank->num_pins; i++) {
+    uint32_t bit = 1u << i;
+    if ((mask & bit) && gpio_write(bank->pins[i], bits & bit))
+      written |= bit;
+  }
+  return written;
+}
+
+// Bring the pins in mask to their shadow level. A writer that raced with us
+// may have pushed an older level after ours, so push again until the
+// shadow did not change during the write.
+static bool gpio_bank_push(gpio_bank_t *bank, uint32_t mask) {
+  for (;;) {
+    uint64_t shadow = atomic_load(&bank->shadow);
+    uint32_t written = gpio_bank_hw_write(bank, mask, (uint32_t)shadow);
+
+    atomic_fetch_or(&bank->known, written);
+    if (written != mask) {
+      atomic_fetch_and(&bank->known, ~(mask & ~written));
+      return false;
+    }
+    if (atomic_load(&bank->shadow) == shadow)
+      return true;
+  }
+}
+
+// Store bits (or flip mask with toggle) in the shadow and push the pins
+// whose level changed or is unknown
+static bool gpio_bank_flush(gpio_bank_t *bank, uint32_t mask, uint32_t bits,
+                            bool toggle) {
+  uint64_t shadow = atomic_load(&bank->shadow);
+  uint32_t dirty;
+  uint64_t next;
+  do {
+    uint32_t level = (uint32_t)shadow;
+    uint32_t target = toggle ? level ^ mask : (level & ~mask) | bits;
+    dirty = mask & ((level ^ target) | ~(uint32_t)atomic_load(&bank->known));
+    if (!dirty)
+      return true;
+    next = gpio_bank_pack((uint32_t)(shadow >> 32) + 1, target);
+  } while (!atomic_compare_exchange_weak(&bank->shadow, &shadow, next));
+
+  return gpio_bank_push(bank, dirty);
+}
+
+bool gpio_bank_init(gpio_bank_t *bank, gpio_handle_t *const *pins,
+                    uint8_t num_pins) {
+  if (!bank || !pins || num_pins == 0 || num_pins > GPIO_BANK_MAX_PINS)
+    return false;
+
+  memset(bank, 0, sizeof(*bank));
+  for (uint8_t i = 0; i < num_pins; i++) {
+    if (!pins[i])
+      return false;
+    bank->pins[i] = pins[i];
+  }
+  bank->num_pins = num_pins;
+  atomic_init(&bank->shadow, 0);
+  atomic_init(&bank->known, 0);
+  atomic_init(&bank->deferred, false);
+  atomic_init(&bank->pending, 0);
+
+  return true;
+}
+
+bool gpio_bank_write(gpio_bank_t *bank, uint32_t mask, uint32_t bits) {
+  if (!bank)
+    return false;
+
+  mask &= gpio_bank_all(bank);
+  bits &= mask;
+
+  if (atomic_load(&bank->deferred)) {
+    uint64_t pending = atomic_load(&bank->pending);
+    uint64_t next;
+    do {
+      next = gpio_bank_pack((uint32_t)(pending >> 32) | mask,
+                            ((uint32_t)pending & ~mask) | bits);
+    } while (!atomic_compare_exchange_weak(&bank->pending, &pending, next));
+    return true;
+  }
+
+  return gpio_bank_flush(bank, mask, bits, false);
+}
+
+bool gpio_bank_set(gpio_bank_t *bank, uint32_t mask) {
+  return gpio_bank_write(bank, mask, mask);
+}
+
+bool gpio_bank_clear(gpio_bank_t *bank, uint32_t mask) {
+  return gpio_bank_write(bank, mask, 0);
+}
+
+bool gpio_bank_toggle(gpio_bank_t *bank, uint32_t mask) {
+  if (!bank)
+    return false;
+
+  mask &= gpio_bank_all(bank);
+
+  // Only pins never written through the bank need a read-back
+  uint32_t unknown = mask & ~(uint32_t)atomic_load(&bank->known);
+  for (uint8_t i = 0; i < bank->num_pins && unknown; i++) {
+    uint32_t bit = 1u << i;
+    if (unknown & bit) {
+      uint32_t level = gpio_read(bank->pins[i]) ? bit : 0;
+      uint64_t shadow = atomic_load(&bank->shadow);
+      uint64_t next;
+      do {
+        next = gpio_bank_pack((uint32_t)(shadow >> 32) + 1,
+                              ((uint32_t)shadow & ~bit) | level);
+      } while (!atomic_compare_exchange_weak(&bank->shadow, &shadow, next));
+      atomic_fetch_or(&bank->known, bit);
+      unknown &= ~bit;
+    }
+  }
+
+  if (!atomic_load(&bank->deferred))
+    return gpio_bank_flush(bank, mask, 0, true);
+
+  // Toggle against the level the pins will have after the pending commit
+  uint64_t pending = atomic_load(&bank->pending);
+  uint64_t next;
+  do {
+    uint32_t pending_mask = (uint32_t)(pending >> 32);
+    uint32_t pending_bits = (uint32_t)pending;
+    uint32_t level = ((uint32_t)atomic_load(&bank->shadow) & ~pending_mask) |
+                     pending_bits;
+    next = gpio_bank_pack(pending_mask | mask,
+                          (pending_bits & ~mask) | (~level & mask));
+  } while (!atomic_compare_exchange_weak(&bank->pending, &pending, next));
+
+  return true;
+}
+
+bool gpio_bank_read(gpio_bank_t *bank, uint32_t *bits) {
+  if (!bank || !bits)
+    return false;
+
+  if (bank->ops && bank->ops->read)
+    return bank->ops->read(bank, bits);
+
+  uint32_t value = 0;
+  for (uint8_t i = 0; i < bank->num_pins; i++) {
+    if (gpio_read(bank->pins[i]))
+      value |= 1u << i;
+  }
+  *bits = value;
+
+  return true;
+}
+
+bool gpio_bank_set_deferred(gpio_bank_t *bank, bool deferred) {
+  if (!bank)
+    return false;
+
+  atomic_store(&bank->deferred, deferred);
+  return deferred ? true : gpio_bank_commit(bank);
+}
+
+bool gpio_bank_commit(gpio_bank_t *bank) {
+  if (!bank)
+    return false;
+
+  // Take the pending word, writes made from now on start a new one
+  uint64_t pending = atomic_exchange(&bank->pending, 0);
+
+  return gpio_bank_flush(bank, (uint32_t)(pending >> 32), (uint32_t)pending,
+                         false);
+}
+
+void gpio_bank_invalidate(gpio_bank_t *bank) {
+  if (bank)
+    atomic_store(&bank->known, 0);
+}
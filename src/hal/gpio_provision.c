@@ -0,0 +1,49 @@
+#include "hal/gpio_provision.h"
+#include <errno.h>
+#include <string.h>
+
+bool gpio_provision(const gpio_driver_t *driver, gpio_handle_t *handles,
+                    const gpio_config_t *configs, size_t count, int *errors) {
+  if (!driver || !handles || !configs)
+    return false;
+
+  memset(handles, 0, count * sizeof(*handles));
+  if (driver->provision)
+    return driver->provision(handles, configs, count, errors);
+
+  // Pin by pin fallback, the bool API carries no error detail
+  bool ok = true;
+  for (size_t i = 0; i < count; i++) {
+    int error = 0;
+    if (!driver->create(&handles[i])) {
+      error = ENOMEM;
+    } else if (!gpio_init(&handles[i], &configs[i])) {
+      driver->destroy(&handles[i]);
+      error = EIO;
+    }
+
+    if (errors)
+      errors[i] = error;
+    ok = ok && error == 0;
+  }
+
+  return ok;
+}
+
+void gpio_unprovision(const gpio_driver_t *driver, gpio_handle_t *handles,
+                      size_t count) {
+  if (!driver || !handles)
+    return;
+
+  if (driver->unprovision) {
+    driver->unprovision(handles, count);
+    return;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    if (!handles[i].hw_handle)
+      continue;
+    gpio_deinit(&handles[i]);
+    driver->destroy(&handles[i]);
+  }
+}
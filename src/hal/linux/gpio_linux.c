@@ -1,161 +1,740 @@
 #include "hal/gpio.h"
+#include "config/linux_config.h"
+#include "hal/gpio_filter.h"
+#include "hal/gpio_linux.h"
+#include "hal/hal_worker.h"
+#include <errno.h>
 #include <fcntl.h>
+#include <linux/gpio.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
 #include <unistd.h>
 
 #define GPIO_PATH "/sys/class/gpio"
+#define GPIO_CONSUMER "uni-lib"
 
+// Pin state word: generation << 2 | known << 1 | level
+#define LINUX_GPIO_LEVEL 1u
+#define LINUX_GPIO_KNOWN 2u
+
+// Character device line request, shared by the handles of its lines
 typedef struct {
   int fd;
-  int pin_number;
+  atomic_uint refs; // Lines of the request still initialized
+  pthread_mutex_t lock; // Serializes reconfiguration
+  struct gpio_v2_line_config config;
+} linux_gpio_request_t;
+
+typedef struct {
+  int fd; // Sysfs value file kept open for edge events, -1 if none
+  int pin_number; // Global sysfs number, -1 for character device lines
+  atomic_uint state; // Last level stored, see LINUX_GPIO_KNOWN
+  gpio_filter_t filter; // Debounce done by the driver, off if none or kernel
+  linux_gpio_request_t *request; // NULL for sysfs pins
+  uint8_t line;                  // Index of the line in the request
   void (*interrupt_callback)(void *);
   void *callback_arg;
 } linux_gpio_data_t;
 
-static bool linux_gpio_init(gpio_handle_t *self, const gpio_config_t *config) {
+// Arguments of a HAL call handed to the worker pool
+typedef struct {
+  gpio_handle_t *self;
+  const gpio_config_t *config;
+  bool state;
+} linux_gpio_call_t;
+
+// Arguments of a bulk call handed to the worker pool
+typedef struct {
+  gpio_handle_t *handles;
+  const gpio_config_t *configs;
+  size_t count;
+  int *status;
+} linux_gpio_table_t;
+
+// Forward declarations
+GPIO_BACKEND_API bool linux_gpio_read(gpio_handle_t *self);
+
+static const linux_gpio_line_t *linux_gpio_line(const gpio_config_t *config) {
+  return (const linux_gpio_line_t *)config->platform_specific;
+}
+
+// Write a value to a sysfs attribute, returns 0 or an errno value
+static int linux_gpio_sysfs_write(const char *path, const char *value) {
+  int fd = open(path, O_WRONLY | O_CLOEXEC);
+  if (fd < 0)
+    return errno;
+
+  int error = 0;
+  if (write(fd, value, strlen(value)) < 0)
+    error = errno;
+  close(fd);
+
+  return error;
+}
+
+static int linux_gpio_export(int pin, const char *attr) {
+  char value[16];
+  snprintf(value, sizeof(value), "%d", pin);
+
+  char path[64];
+  snprintf(path, sizeof(path), GPIO_PATH "/%s", attr);
+  return linux_gpio_sysfs_write(path, value);
+}
+
+// The node appears on export, but udev may still be fixing its permissions
+static bool linux_gpio_exported(int pin) {
+  char path[64];
+  snprintf(path, sizeof(path), GPIO_PATH "/gpio%d/direction", pin);
+  return access(path, W_OK) == 0;
+}
+
+static int linux_gpio_set_direction(int pin, bool is_output) {
+  char path[64];
+  snprintf(path, sizeof(path), GPIO_PATH "/gpio%d/direction", pin);
+  return linux_gpio_sysfs_write(path, is_output ? "out" : "in");
+}
+
+static uint32_t linux_gpio_elapsed_ms(const struct timespec *start) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)((now.tv_sec - start->tv_sec) * 1000 +
+                    (now.tv_nsec - start->tv_nsec) / 1000000);
+}
+
+static uint64_t linux_gpio_line_flags(const gpio_config_t *config) {
+  uint64_t flags =
+      config->is_output ? GPIO_V2_LINE_FLAG_OUTPUT : GPIO_V2_LINE_FLAG_INPUT;
+  if (config->is_output && config->open_drain)
+    flags |= GPIO_V2_LINE_FLAG_OPEN_DRAIN;
+  if (config->pull_up)
+    flags |= GPIO_V2_LINE_FLAG_BIAS_PULL_UP;
+  else if (config->pull_down)
+    flags |= GPIO_V2_LINE_FLAG_BIAS_PULL_DOWN;
+  return flags;
+}
+
+// Index of the attribute with this id and value, added if missing, or -1
+// once all GPIO_V2_LINE_NUM_ATTRS_MAX are taken
+static int linux_gpio_attr(struct gpio_v2_line_config *config, uint32_t id,
+                           uint64_t value) {
+  struct gpio_v2_line_attribute attr = {.id = id};
+  if (id == GPIO_V2_LINE_ATTR_ID_DEBOUNCE)
+    attr.debounce_period_us = (uint32_t)value;
+  else
+    attr.flags = value;
+
+  uint32_t a = 0;
+  while (a < config->num_attrs && (config->attrs[a].attr.id != id ||
+                                   config->attrs[a].attr.flags != attr.flags))
+    a++;
+  if (a == GPIO_V2_LINE_NUM_ATTRS_MAX)
+    return -1;
+  if (a == config->num_attrs) {
+    config->attrs[a].attr = attr;
+    config->attrs[a].mask = 0;
+    config->num_attrs++;
+  }
+  return (int)a;
+}
+
+// Drop the attributes no line uses any more, so their slots can be reused
+static void linux_gpio_compact_attrs(struct gpio_v2_line_config *config) {
+  uint32_t kept = 0;
+  for (uint32_t a = 0; a < config->num_attrs; a++) {
+    if (config->attrs[a].mask)
+      config->attrs[kept++] = config->attrs[a];
+  }
+  memset(&config->attrs[kept], 0,
+         (config->num_attrs - kept) * sizeof(config->attrs[0]));
+  config->num_attrs = kept;
+}
+
+// Drop the debounce attributes, leaving the filtering to the driver
+static void linux_gpio_drop_debounce(struct gpio_v2_line_config *config) {
+  for (uint32_t a = 0; a < config->num_attrs; a++) {
+    if (config->attrs[a].attr.id == GPIO_V2_LINE_ATTR_ID_DEBOUNCE)
+      config->attrs[a].mask = 0;
+  }
+  linux_gpio_compact_attrs(config);
+}
+
+static bool linux_gpio_debounced(const gpio_config_t *config) {
+  return !config->is_output && config->debounce_us;
+}
+
+// Request the pending lines on the chip of handles[first] with one ioctl,
+// up to GPIO_V2_LINES_MAX of them
+static void linux_gpio_request_chip(gpio_handle_t *handles,
+                                    const gpio_config_t *configs, size_t count,
+                                    size_t first, int *status) {
+  const char *chip = linux_gpio_line(&configs[first])->chip;
+  size_t members[GPIO_V2_LINES_MAX];
+  bool kernel_debounce[GPIO_V2_LINES_MAX] = {false};
+  struct gpio_v2_line_request req;
+  memset(&req, 0, sizeof(req));
+  strncpy(req.consumer, GPIO_CONSUMER, sizeof(req.consumer) - 1);
+  req.config.flags = linux_gpio_line_flags(&configs[first]);
+
+  for (size_t i = first; i < count && req.num_lines < GPIO_V2_LINES_MAX; i++) {
+    const linux_gpio_line_t *line = linux_gpio_line(&configs[i]);
+    linux_gpio_data_t *hw = handles[i].hw_handle;
+    if (!line || status[i] || hw->request || strcmp(line->chip, chip) != 0)
+      continue;
+
+    // Lines whose flags differ from the request default get an attribute.
+    // Once debounce periods have taken the last one, the remaining lines go
+    // into a request of their own.
+    uint64_t flags = linux_gpio_line_flags(&configs[i]);
+    if (flags != req.config.flags) {
+      int a = linux_gpio_attr(&req.config, GPIO_V2_LINE_ATTR_ID_FLAGS, flags);
+      if (a < 0)
+        break;
+      req.config.attrs[a].mask |= 1ull << req.num_lines;
+    }
+
+    // The kernel debounces in hardware where the chip can, else in its edge
+    // detector; periods beyond the attribute limit are left to the driver
+    if (linux_gpio_debounced(&configs[i])) {
+      int a = linux_gpio_attr(&req.config, GPIO_V2_LINE_ATTR_ID_DEBOUNCE,
+                              configs[i].debounce_us);
+      if (a >= 0) {
+        req.config.attrs[a].mask |= 1ull << req.num_lines;
+        kernel_debounce[req.num_lines] = true;
+      }
+    }
+
+    members[req.num_lines] = i;
+    req.offsets[req.num_lines++] = line->offset;
+  }
+
+  int error = 0;
+  int chip_fd = open(chip, O_RDWR | O_CLOEXEC);
+  if (chip_fd < 0) {
+    error = errno;
+  } else {
+    if (ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &req) < 0)
+      error = errno;
+
+    // Without an interrupt for a line the kernel cannot debounce it; try
+    // again with the driver debouncing every line
+    uint32_t num_attrs = req.config.num_attrs;
+    if (error)
+      linux_gpio_drop_debounce(&req.config);
+    if (error && req.config.num_attrs != num_attrs) {
+      memset(kernel_debounce, 0, sizeof(kernel_debounce));
+      error = ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &req) < 0 ? errno : 0;
+    }
+    close(chip_fd);
+  }
+
+  linux_gpio_request_t *request = NULL;
+  if (!error) {
+    request = malloc(sizeof(*request));
+    if (request) {
+      request->fd = req.fd;
+      atomic_init(&request->refs, req.num_lines);
+      pthread_mutex_init(&request->lock, NULL);
+      request->config = req.config;
+    } else {
+      close(req.fd);
+      error = ENOMEM;
+    }
+  }
+
+  for (uint32_t k = 0; k < req.num_lines; k++) {
+    size_t i = members[k];
+    linux_gpio_data_t *hw = handles[i].hw_handle;
+    if (error) {
+      status[i] = error;
+      continue;
+    }
+
+    hw->request = request;
+    hw->line = (uint8_t)k;
+    if (kernel_debounce[k]) {
+      gpio_filter_init(&hw->filter, 0);
+      handles[i].debounce_hw = true;
+    }
+    // Outputs start driven low
+    atomic_store(&hw->state, configs[i].is_output ? LINUX_GPIO_KNOWN : 0);
+  }
+}
+
+// Bring up handles[0..count), whose hardware data is already allocated or
+// NULL if that failed, and set status[i] to 0 or an errno value
+static void linux_gpio_bring_up(gpio_handle_t *handles,
+                                const gpio_config_t *configs, size_t count,
+                                int *status) {
+  for (size_t i = 0; i < count; i++) {
+    linux_gpio_data_t *hw = handles[i].hw_handle;
+    const linux_gpio_line_t *line = linux_gpio_line(&configs[i]);
+    status[i] = hw ? 0 : ENOMEM;
+    if (!hw)
+      continue;
+
+    hw->fd = -1;
+    hw->pin_number = line ? -1 : (int)configs[i].pin;
+    atomic_store(&hw->state, 0);
+    hw->request = NULL;
+    handles[i].active_high = configs[i].active_high;
+
+    // The driver debounces unless the line request hands it to the kernel
+    uint32_t debounce_us =
+        linux_gpio_debounced(&configs[i]) ? configs[i].debounce_us : 0;
+    handles[i].debounce_us = debounce_us;
+    handles[i].debounce_hw = false;
+    gpio_filter_init(&hw->filter, debounce_us);
+    if (line && !line->chip)
+      status[i] = EINVAL;
+
+    // Sysfs cannot drive open drain; the pin is never exported
+    if (!line && configs[i].is_output && configs[i].open_drain) {
+      hw->pin_number = -1;
+      status[i] = EOPNOTSUPP;
+    }
+  }
+
+  // One line request per chip
+  for (size_t i = 0; i < count; i++) {
+    linux_gpio_data_t *hw = handles[i].hw_handle;
+    if (linux_gpio_line(&configs[i]) && !status[i] && !hw->request)
+      linux_gpio_request_chip(handles, configs, count, i, status);
+  }
+
+  // Export every sysfs pin first, then wait for all of them together, so
+  // the udev latency is paid once per table rather than once per pin
+  size_t *pending = malloc(count * sizeof(*pending));
+  size_t waiting = 0;
+  for (size_t i = 0; i < count; i++) {
+    linux_gpio_data_t *hw = handles[i].hw_handle;
+    if (linux_gpio_line(&configs[i]) || status[i])
+      continue;
+
+    int error = linux_gpio_export(hw->pin_number, "export");
+    if (error && error != EBUSY) // EBUSY: already exported
+      status[i] = error;
+    else if (!pending)
+      status[i] = ENOMEM;
+    else
+      pending[waiting++] = i;
+  }
+
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  while (waiting) {
+    for (size_t k = 0; k < waiting;) {
+      size_t i = pending[k];
+      linux_gpio_data_t *hw = handles[i].hw_handle;
+      if (!linux_gpio_exported(hw->pin_number)) {
+        k++;
+        continue;
+      }
+
+      status[i] =
+          linux_gpio_set_direction(hw->pin_number, configs[i].is_output);
+      pending[k] = pending[--waiting];
+    }
+
+    if (waiting && linux_gpio_elapsed_ms(&start) >= GPIO_EXPORT_TIMEOUT_MS) {
+      for (size_t k = 0; k < waiting; k++)
+        status[pending[k]] = ETIMEDOUT;
+      waiting = 0;
+    }
+    if (waiting)
+      usleep(GPIO_EXPORT_POLL_US);
+  }
+  free(pending);
+
+  // Do not leave half configured sysfs pins behind, and keep deinit from
+  // unexporting them again
+  for (size_t i = 0; i < count; i++) {
+    linux_gpio_data_t *hw = handles[i].hw_handle;
+    if (status[i] && hw && hw->pin_number >= 0) {
+      linux_gpio_export(hw->pin_number, "unexport");
+      hw->pin_number = -1;
+    }
+  }
+}
+
+static bool linux_gpio_init_job(void *arg) {
+  linux_gpio_call_t *call = arg;
+  gpio_handle_t *self = call->self;
+  const gpio_config_t *config = call->config;
   if (!self || !self->hw_handle || !config)
     return false;
 
-  linux_gpio_data_t *hw = (linux_gpio_data_t *)self->hw_handle;
-  hw->pin_number = config->pin;
-  self->active_high = config->active_high; // Store active logic configuration
+  int status;
+  linux_gpio_bring_up(self, config, 1, &status);
+
+  return status == 0;
+}
 
-  // Export GPIO
-  char cmd[64];
-  snprintf(cmd, sizeof(cmd), "echo %d > /sys/class/gpio/export",
-           hw->pin_number);
-  system(cmd);
+GPIO_BACKEND_API bool linux_gpio_init(gpio_handle_t *self,
+                                      const gpio_config_t *config) {
+  linux_gpio_call_t call = {.self = self, .config = config};
+  return hal_worker_call(linux_gpio_init_job, &call);
+}
 
-  // Set direction
-  snprintf(cmd, sizeof(cmd), "echo %s > /sys/class/gpio/gpio%d/direction",
-           config->is_output ? "out" : "in", hw->pin_number);
-  system(cmd);
+// Give a character device line back, the last one closes the request
+static void linux_gpio_release(linux_gpio_data_t *hw) {
+  linux_gpio_request_t *request = hw->request;
+  hw->request = NULL;
 
-  return true;
+  if (atomic_fetch_sub(&request->refs, 1) == 1) {
+    close(request->fd);
+    pthread_mutex_destroy(&request->lock);
+    free(request);
+  }
+}
+
+// Level of a character device line, -1 on error
+static int linux_gpio_line_get(const linux_gpio_data_t *hw) {
+  struct gpio_v2_line_values values = {.mask = 1ull << hw->line};
+  if (ioctl(hw->request->fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &values) < 0)
+    return -1;
+
+  return (int)((values.bits >> hw->line) & 1);
+}
+
+static bool linux_gpio_line_set(const linux_gpio_data_t *hw, bool state) {
+  struct gpio_v2_line_values values = {
+      .bits = (uint64_t)state << hw->line,
+      .mask = 1ull << hw->line,
+  };
+  return ioctl(hw->request->fd, GPIO_V2_LINE_SET_VALUES_IOCTL, &values) == 0;
 }
 
-static bool linux_gpio_deinit(gpio_handle_t *self) {
+static bool linux_gpio_deinit_job(void *arg) {
+  linux_gpio_call_t *call = arg;
+  gpio_handle_t *self = call->self;
   if (!self || !self->hw_handle)
     return false;
 
   linux_gpio_data_t *hw = (linux_gpio_data_t *)self->hw_handle;
-  char cmd[64];
-  snprintf(cmd, sizeof(cmd), "echo %d > /sys/class/gpio/unexport",
-           hw->pin_number);
-  system(cmd);
+  if (hw->fd >= 0) {
+    close(hw->fd);
+    hw->fd = -1;
+  }
+  if (hw->request) {
+    linux_gpio_release(hw);
+    return true;
+  }
+  if (hw->pin_number < 0) // Released line or never exported
+    return true;
+
+  int pin = hw->pin_number;
+  hw->pin_number = -1;
+  return linux_gpio_export(pin, "unexport") == 0;
+}
 
-  return true;
+GPIO_BACKEND_API bool linux_gpio_deinit(gpio_handle_t *self) {
+  linux_gpio_call_t call = {.self = self};
+  return hal_worker_call(linux_gpio_deinit_job, &call);
+}
+
+// Level of the pin as it is now, -1 on error
+static int linux_gpio_raw(const linux_gpio_data_t *hw) {
+  if (hw->request)
+    return linux_gpio_line_get(hw);
+
+  char path[64];
+  char value;
+
+  snprintf(path, sizeof(path), GPIO_PATH "/gpio%d/value", hw->pin_number);
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return -1;
+
+  ssize_t n = read(fd, &value, 1);
+  close(fd);
+
+  return n == 1 ? value == '1' : -1;
 }
 
-static bool linux_gpio_activate(gpio_handle_t *self) {
+// Level seen by read() and is_active(), -1 on error
+static int linux_gpio_level(linux_gpio_data_t *hw) {
+  int level = linux_gpio_raw(hw);
+  if (level < 0 || !hw->filter.period_us)
+    return level;
+
+  // Only reads advance the driver's filter, edge events stay raw
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  uint64_t now_us = (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+  return gpio_filter_sample(&hw->filter, level, now_us);
+}
+
+static bool linux_gpio_is_active_job(void *arg) {
+  linux_gpio_call_t *call = arg;
+  gpio_handle_t *self = call->self;
   if (!self || !self->hw_handle)
     return false;
 
-  linux_gpio_data_t *hw = (linux_gpio_data_t *)self->hw_handle;
-  char cmd[64];
-  snprintf(cmd, sizeof(cmd), "echo %d > /sys/class/gpio/gpio%d/value",
-           self->active_high ? 1 : 0, hw->pin_number);
-  system(cmd);
+  int level = linux_gpio_level((linux_gpio_data_t *)self->hw_handle);
+  if (level < 0)
+    return false;
 
-  return true;
+  bool pin_high = level;
+  return self->active_high ? pin_high : !pin_high;
+}
+
+GPIO_BACKEND_API bool linux_gpio_is_active(gpio_handle_t *self) {
+  linux_gpio_call_t call = {.self = self};
+  return hal_worker_call(linux_gpio_is_active_job, &call);
 }
 
-static bool linux_gpio_deactivate(gpio_handle_t *self) {
+static bool linux_gpio_write_job(void *arg) {
+  linux_gpio_call_t *call = arg;
+  gpio_handle_t *self = call->self;
+  bool state = call->state;
   if (!self || !self->hw_handle)
     return false;
 
   linux_gpio_data_t *hw = (linux_gpio_data_t *)self->hw_handle;
-  char cmd[64];
-  snprintf(cmd, sizeof(cmd), "echo %d > /sys/class/gpio/gpio%d/value",
-           self->active_high ? 0 : 1, hw->pin_number);
-  system(cmd);
+  if (hw->request) {
+    if (!linux_gpio_line_set(hw, state))
+      return false;
+  } else {
+    char path[64];
+    snprintf(path, sizeof(path), GPIO_PATH "/gpio%d/value", hw->pin_number);
+    if (linux_gpio_sysfs_write(path, state ? "1" : "0") != 0)
+      return false;
+  }
 
   return true;
 }
 
-static bool linux_gpio_is_active(gpio_handle_t *self) {
+static uint32_t linux_gpio_next(uint32_t state, bool level) {
+  return ((state >> 2) + 1) << 2 | LINUX_GPIO_KNOWN | level;
+}
+
+// Store a level (or flip the stored one) with one compare-and-swap and push
+// it to the pin. A writer racing on the same pin may push an older level
+// after ours, so push again until the state did not change meanwhile.
+static bool linux_gpio_update(gpio_handle_t *self, bool level, bool toggle) {
+  linux_gpio_data_t *hw = (linux_gpio_data_t *)self->hw_handle;
+  uint32_t state = atomic_load(&hw->state);
+
+  // Only an unknown level is read back; a level stored meanwhile wins
+  if (toggle && !(state & LINUX_GPIO_KNOWN)) {
+    uint32_t read_back = linux_gpio_next(state, linux_gpio_read(self));
+    atomic_compare_exchange_strong(&hw->state, &state, read_back);
+    state = atomic_load(&hw->state);
+  }
+
+  uint32_t next;
+  do {
+    bool target = toggle ? !(state & LINUX_GPIO_LEVEL) : level;
+
+    // The pin already holds this level, skip the syscall
+    if ((state & LINUX_GPIO_KNOWN) && (state & LINUX_GPIO_LEVEL) == target)
+      return true;
+    next = linux_gpio_next(state, target);
+  } while (!atomic_compare_exchange_weak(&hw->state, &state, next));
+
+  linux_gpio_call_t call = {.self = self};
+  for (;;) {
+    uint32_t pushed = atomic_load(&hw->state);
+    call.state = pushed & LINUX_GPIO_LEVEL;
+    if (!hal_worker_call(linux_gpio_write_job, &call)) {
+      atomic_fetch_and(&hw->state, ~LINUX_GPIO_KNOWN);
+      return false;
+    }
+    if (atomic_load(&hw->state) == pushed)
+      return true;
+  }
+}
+
+GPIO_BACKEND_API bool linux_gpio_write(gpio_handle_t *self, bool state) {
   if (!self || !self->hw_handle)
     return false;
 
-  linux_gpio_data_t *hw = (linux_gpio_data_t *)self->hw_handle;
-  char path[64], value;
-  snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/value", hw->pin_number);
+  return linux_gpio_update(self, state, false);
+}
 
-  FILE *fp = fopen(path, "r");
-  if (!fp)
+GPIO_BACKEND_API bool linux_gpio_activate(gpio_handle_t *self) {
+  if (!self)
     return false;
 
-  value = fgetc(fp);
-  fclose(fp);
+  return linux_gpio_write(self, self->active_high);
+}
 
-  bool pin_high = (value == '1');
-  return self->active_high ? pin_high : !pin_high;
+GPIO_BACKEND_API bool linux_gpio_deactivate(gpio_handle_t *self) {
+  if (!self)
+    return false;
+
+  return linux_gpio_write(self, !self->active_high);
 }
 
-static bool linux_gpio_write(gpio_handle_t *self, bool state) {
+static bool linux_gpio_read_job(void *arg) {
+  linux_gpio_call_t *call = arg;
+  gpio_handle_t *self = call->self;
   if (!self || !self->hw_handle)
     return false;
 
-  linux_gpio_data_t *hw = (linux_gpio_data_t *)self->hw_handle;
-  char cmd[64];
-  snprintf(cmd, sizeof(cmd), "echo %d > /sys/class/gpio/gpio%d/value",
-           state ? 1 : 0, hw->pin_number);
-  system(cmd);
+  return linux_gpio_level((linux_gpio_data_t *)self->hw_handle) == 1;
+}
 
-  return true;
+GPIO_BACKEND_API bool linux_gpio_read(gpio_handle_t *self) {
+  linux_gpio_call_t call = {.self = self};
+  return hal_worker_call(linux_gpio_read_job, &call);
+}
+
+GPIO_BACKEND_API bool linux_gpio_toggle(gpio_handle_t *self) {
+  if (!self || !self->hw_handle)
+    return false;
+
+  return linux_gpio_update(self, false, true);
+}
+
+GPIO_BACKEND_API bool linux_gpio_set_interrupt(gpio_handle_t *self,
+                                               void (*callback)(void *),
+                                               void *arg) {
+  (void)self;
+  (void)callback;
+  (void)arg;
+
+  // Callbacks would have to run on a native thread, where FreeRTOS queues
+  // and timeouts must not be used; see linux_gpio_edge_fd() instead
+  errno = ENOTSUP;
+  return false;
 }
 
-static bool linux_gpio_read(gpio_handle_t *self) {
+// Add both edge flags to a character device line and apply the request's
+// configuration again
+static bool linux_gpio_line_edges(const linux_gpio_data_t *hw) {
+  linux_gpio_request_t *request = hw->request;
+  uint64_t bit = 1ull << hw->line;
+
+  pthread_mutex_lock(&request->lock);
+  // Work on a copy, so the request keeps its config if the kernel refuses
+  struct gpio_v2_line_config config = request->config;
+  uint64_t flags = config.flags;
+  for (uint32_t a = 0; a < config.num_attrs; a++) {
+    if ((config.attrs[a].mask & bit) &&
+        config.attrs[a].attr.id == GPIO_V2_LINE_ATTR_ID_FLAGS) {
+      flags = config.attrs[a].attr.flags;
+      config.attrs[a].mask &= ~bit;
+    }
+  }
+  flags |= GPIO_V2_LINE_FLAG_EDGE_RISING | GPIO_V2_LINE_FLAG_EDGE_FALLING;
+
+  // The flags this line leaves may have no other line, free their slot.
+  // A debounce attribute of the line stays, so edges are debounced too.
+  linux_gpio_compact_attrs(&config);
+  int a = linux_gpio_attr(&config, GPIO_V2_LINE_ATTR_ID_FLAGS, flags);
+  bool ok = a >= 0;
+  if (ok) {
+    config.attrs[a].mask |= bit;
+    ok = ioctl(request->fd, GPIO_V2_LINE_SET_CONFIG_IOCTL, &config) == 0;
+  }
+  if (ok)
+    request->config = config;
+  pthread_mutex_unlock(&request->lock);
+
+  // Events of all lines of the request arrive on its fd
+  return ok && fcntl(request->fd, F_SETFL,
+                     fcntl(request->fd, F_GETFL) | O_NONBLOCK) == 0;
+}
+
+static bool linux_gpio_edge_job(void *arg) {
+  linux_gpio_call_t *call = arg;
+  gpio_handle_t *self = call->self;
   if (!self || !self->hw_handle)
     return false;
 
   linux_gpio_data_t *hw = (linux_gpio_data_t *)self->hw_handle;
+  if (hw->request)
+    return linux_gpio_line_edges(hw);
+  if (hw->fd >= 0)
+    return true;
+
   char path[64];
-  char value;
+  snprintf(path, sizeof(path), GPIO_PATH "/gpio%d/edge", hw->pin_number);
+  if (linux_gpio_sysfs_write(path, "both") != 0)
+    return false;
 
-  snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/value", hw->pin_number);
-  int fd = open(path, O_RDONLY);
-  if (fd < 0)
+  snprintf(path, sizeof(path), GPIO_PATH "/gpio%d/value", hw->pin_number);
+  hw->fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+  if (hw->fd < 0)
     return false;
 
-  read(fd, &value, 1);
-  close(fd);
+  // Reading the value clears the initial POLLPRI
+  char value;
+  read(hw->fd, &value, 1);
+  return true;
+}
+
+int linux_gpio_edge_fd(gpio_handle_t *self, short *events) {
+  linux_gpio_call_t call = {.self = self};
+  if (!events || !hal_worker_call(linux_gpio_edge_job, &call))
+    return -1;
 
-  return value == '1';
+  linux_gpio_data_t *hw = (linux_gpio_data_t *)self->hw_handle;
+  if (hw->request) {
+    *events = POLLIN;
+    return hw->request->fd;
+  }
+  *events = POLLPRI | POLLERR;
+  return hw->fd;
+}
+
+static bool linux_gpio_edge_ack_job(void *arg) {
+  linux_gpio_call_t *call = arg;
+  linux_gpio_data_t *hw = (linux_gpio_data_t *)call->self->hw_handle;
+
+  if (hw->request) {
+    struct gpio_v2_line_event events[16];
+    while (read(hw->request->fd, events, sizeof(events)) == sizeof(events))
+      ;
+    return true;
+  }
+
+  char value;
+  return lseek(hw->fd, 0, SEEK_SET) == 0 && read(hw->fd, &value, 1) == 1;
 }
 
-static bool linux_gpio_toggle(gpio_handle_t *self) {
+bool linux_gpio_edge_ack(gpio_handle_t *self) {
   if (!self || !self->hw_handle)
     return false;
 
-  linux_gpio_data_t *hw = (linux_gpio_data_t *)self->hw_handle;
-  char cmd[64];
-  snprintf(cmd, sizeof(cmd), "echo toggle > /sys/class/gpio/gpio%d/edge",
-           hw->pin_number);
-  system(cmd);
-
-  return true;
+  linux_gpio_call_t call = {.self = self};
+  return hal_worker_call(linux_gpio_edge_ack_job, &call);
 }
 
+static const gpio_ops_t linux_gpio_ops = {
+    .init = linux_gpio_init,
+    .deinit = linux_gpio_deinit,
+    .write = linux_gpio_write,
+    .read = linux_gpio_read,
+    .activate = linux_gpio_activate,
+    .deactivate = linux_gpio_deactivate,
+    .is_active = linux_gpio_is_active,
+    .toggle = linux_gpio_toggle,
+    .set_interrupt = linux_gpio_set_interrupt,
+};
+
 static bool linux_gpio_create(gpio_handle_t *handle) {
   if (!handle)
     return false;
 
-  linux_gpio_data_t *hw = malloc(sizeof(linux_gpio_data_t));
+  linux_gpio_data_t *hw = calloc(1, sizeof(linux_gpio_data_t));
   if (!hw)
     return false;
 
+  // Nothing to close or unexport until init succeeds
+  hw->fd = -1;
+  hw->pin_number = -1;
+  hw->request = NULL;
+
   handle->hw_handle = hw;
-  handle->init = linux_gpio_init;
-  handle->deinit = linux_gpio_deinit;
-  handle->activate = linux_gpio_activate;
-  handle->deactivate = linux_gpio_deactivate;
-  handle->is_active = linux_gpio_is_active;
-  handle->toggle = linux_gpio_toggle;
-  handle->write = linux_gpio_write;
-  handle->read = linux_gpio_read;
+  gpio_bind_ops(handle, &linux_gpio_ops);
 
   return true;
 }
@@ -167,10 +746,8 @@ static bool linux_gpio_destroy(gpio_handle_t *handle) {
   linux_gpio_data_t *hw = (linux_gpio_data_t *)handle->hw_handle;
 
   // Unexport GPIO
-  char cmd[64];
-  snprintf(cmd, sizeof(cmd), "echo %d > /sys/class/gpio/unexport",
-           hw->pin_number);
-  system(cmd);
+  linux_gpio_call_t call = {.self = handle};
+  hal_worker_call(linux_gpio_deinit_job, &call);
 
   free(hw);
   handle->hw_handle = NULL;
@@ -178,5 +755,70 @@ static bool linux_gpio_destroy(gpio_handle_t *handle) {
   return true;
 }
 
+static bool linux_gpio_provision_job(void *arg) {
+  linux_gpio_table_t *table = arg;
+  linux_gpio_bring_up(table->handles, table->configs, table->count,
+                      table->status);
+  return true;
+}
+
+static bool linux_gpio_provision(gpio_handle_t *handles,
+                                 const gpio_config_t *configs, size_t count,
+                                 int *errors) {
+  int *status = errors ? errors : calloc(count ? count : 1, sizeof(int));
+  if (!status)
+    return false;
+
+  // Out of memory leaves the entry without data: bring-up reports ENOMEM
+  // for it and skips it
+  for (size_t i = 0; i < count; i++) {
+    if (!linux_gpio_create(&handles[i]))
+      handles[i].hw_handle = NULL;
+  }
+
+  // The whole table is one worker call
+  linux_gpio_table_t table = {.handles = handles,
+                              .configs = configs,
+                              .count = count,
+                              .status = status};
+  hal_worker_call(linux_gpio_provision_job, &table);
+
+  bool ok = true;
+  for (size_t i = 0; i < count; i++) {
+    if (!status[i])
+      continue;
+
+    free(handles[i].hw_handle);
+    handles[i].hw_handle = NULL;
+    ok = false;
+  }
+
+  if (status != errors)
+    free(status);
+  return ok;
+}
+
+static bool linux_gpio_unprovision_job(void *arg) {
+  linux_gpio_table_t *table = arg;
+  for (size_t i = 0; i < table->count; i++) {
+    linux_gpio_call_t call = {.self = &table->handles[i]};
+    if (table->handles[i].hw_handle)
+      linux_gpio_deinit_job(&call);
+  }
+  return true;
+}
+
+static void linux_gpio_unprovision(gpio_handle_t *handles, size_t count) {
+  linux_gpio_table_t table = {.handles = handles, .count = count};
+  hal_worker_call(linux_gpio_unprovision_job, &table);
+
+  for (size_t i = 0; i < count; i++) {
+    free(handles[i].hw_handle);
+    handles[i].hw_handle = NULL;
+  }
+}
+
 const gpio_driver_t linux_gpio_driver = {.create = linux_gpio_create,
-                                         .destroy = linux_gpio_destroy};
+                                         .destroy = linux_gpio_destroy,
+                                         .provision = linux_gpio_provision,
+                                         .unprovision = linux_gpio_unprovision};
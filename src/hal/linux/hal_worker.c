@@ -0,0 +1,207 @@
+#define _GNU_SOURCE // pthread_setaffinity_np()
+#include "hal/hal_worker.h"
+#include "FreeRTOS.h"
+#include "config/linux_config.h"
+#include "task.h"
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdatomic.h>
+
+typedef struct hal_worker_job {
+  hal_worker_fn_t fn;
+  void *arg;
+  bool result;
+  TaskHandle_t task; // Caller waiting on HAL_WORKER_NOTIFY_INDEX
+  struct hal_worker_job *next;
+} hal_worker_job_t;
+
+static struct {
+  pthread_t threads[HAL_WORKER_MAX_THREADS];
+  size_t num_threads;
+
+  // Pending jobs (FIFO), protected by lock
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  hal_worker_job_t *head;
+  hal_worker_job_t *tail;
+
+  // Completed jobs (LIFO), pushed by workers and drained by the tick hook.
+  // Lock-free because the tick hook runs in signal context.
+  _Atomic(hal_worker_job_t *) done;
+  atomic_bool running;
+
+  // Scheduling of the worker threads, see hal_worker_set_sched(); until
+  // it is called they keep what they inherit from the starting thread
+  bool sched_set;
+  int priority;
+  uint32_t cpus;
+} pool = {.lock = PTHREAD_MUTEX_INITIALIZER, .cond = PTHREAD_COND_INITIALIZER};
+
+static _Thread_local bool native_thread;
+
+static void hal_worker_complete(hal_worker_job_t *job) {
+  hal_worker_job_t *top = atomic_load(&pool.done);
+  do {
+    job->next = top;
+  } while (!atomic_compare_exchange_weak(&pool.done, &top, job));
+}
+
+static void *hal_worker_thread(void *unused) {
+  (void)unused;
+  native_thread = true;
+
+  pthread_mutex_lock(&pool.lock);
+  for (;;) {
+    while (atomic_load(&pool.running) && !pool.head)
+      pthread_cond_wait(&pool.cond, &pool.lock);
+
+    // Drain remaining jobs before exiting so no caller is left blocked
+    hal_worker_job_t *job = pool.head;
+    if (!job)
+      break;
+    pool.head = job->next;
+    if (!pool.head)
+      pool.tail = NULL;
+    pthread_mutex_unlock(&pool.lock);
+
+    job->result = job->fn(job->arg);
+    hal_worker_complete(job);
+
+    pthread_mutex_lock(&pool.lock);
+  }
+  pthread_mutex_unlock(&pool.lock);
+
+  return NULL;
+}
+
+bool hal_worker_sched_thread(pthread_t thread, int priority, uint32_t cpus) {
+  struct sched_param param = {.sched_priority = priority};
+  int err =
+      pthread_setschedparam(thread, priority ? SCHED_FIFO : SCHED_OTHER, &param);
+  if (err) {
+    errno = err;
+    return false;
+  }
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (!cpus || (cpu < 32 && cpus & (1u << cpu)))
+      CPU_SET(cpu, &set);
+  }
+  err = pthread_setaffinity_np(thread, sizeof(set), &set);
+  if (err) {
+    errno = err;
+    return false;
+  }
+  return true;
+}
+
+static bool hal_worker_apply_sched(pthread_t thread) {
+  return hal_worker_sched_thread(thread, pool.priority, pool.cpus);
+}
+
+bool hal_worker_start(size_t num_threads) {
+  if (atomic_load(&pool.running) || num_threads == 0 ||
+      num_threads > HAL_WORKER_MAX_THREADS)
+    return false;
+
+  // Workers must never take the scheduler's signals
+  sigset_t all, old;
+  sigfillset(&all);
+  pthread_sigmask(SIG_SETMASK, &all, &old);
+
+  atomic_store(&pool.running, true);
+  pool.num_threads = 0;
+  bool ok = true;
+  for (size_t i = 0; ok && i < num_threads; i++) {
+    ok = pthread_create(&pool.threads[i], NULL, hal_worker_thread, NULL) == 0;
+    if (ok) {
+      pool.num_threads++;
+      if (pool.sched_set)
+        ok = hal_worker_apply_sched(pool.threads[i]);
+    }
+  }
+
+  pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+  if (!ok) {
+    hal_worker_stop();
+    return false;
+  }
+
+  return true;
+}
+
+void hal_worker_stop(void) {
+  pthread_mutex_lock(&pool.lock);
+  atomic_store(&pool.running, false);
+  pthread_cond_broadcast(&pool.cond);
+  pthread_mutex_unlock(&pool.lock);
+
+  for (size_t i = 0; i < pool.num_threads; i++)
+    pthread_join(pool.threads[i], NULL);
+  pool.num_threads = 0;
+}
+
+bool hal_worker_set_sched(int priority, uint32_t cpus) {
+  if (priority < 0 || priority > sched_get_priority_max(SCHED_FIFO)) {
+    errno = EINVAL;
+    return false;
+  }
+
+  pool.sched_set = true;
+  pool.priority = priority;
+  pool.cpus = cpus;
+
+  bool ok = true;
+  for (size_t i = 0; i < pool.num_threads; i++)
+    ok &= hal_worker_apply_sched(pool.threads[i]);
+  return ok;
+}
+
+bool hal_worker_call(hal_worker_fn_t fn, void *arg) {
+  if (!fn)
+    return false;
+
+  if (native_thread || !atomic_load(&pool.running) ||
+      xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+    return fn(arg);
+
+  hal_worker_job_t job = {
+      .fn = fn, .arg = arg, .task = xTaskGetCurrentTaskHandle()};
+
+  // The critical section keeps this task from being switched out while it
+  // holds the native lock, which would deadlock the next task to submit.
+  taskENTER_CRITICAL();
+  pthread_mutex_lock(&pool.lock);
+  if (pool.tail)
+    pool.tail->next = &job;
+  else
+    pool.head = &job;
+  pool.tail = &job;
+  pthread_cond_signal(&pool.cond);
+  pthread_mutex_unlock(&pool.lock);
+  taskEXIT_CRITICAL();
+
+  ulTaskNotifyTakeIndexed(HAL_WORKER_NOTIFY_INDEX, pdTRUE, portMAX_DELAY);
+
+  return job.result;
+}
+
+void hal_worker_register_native_thread(void) { native_thread = true; }
+
+bool hal_worker_is_native_thread(void) { return native_thread; }
+
+void hal_worker_tick_hook(void) {
+  hal_worker_job_t *job = atomic_exchange(&pool.done, NULL);
+
+  while (job) {
+    // The job lives on the caller's stack; read next before waking it
+    hal_worker_job_t *next = job->next;
+    vTaskNotifyGiveIndexedFromISR(job->task, HAL_WORKER_NOTIFY_INDEX, NULL);
+    job = next;
+  }
+}
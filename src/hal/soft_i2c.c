@@ -0,0 +1,233 @@
+#include "hal/soft_i2c.h"
+
+// Write SDA while SCL is low
+static bool soft_i2c_sda(soft_i2c_t *bus, bool level) {
+  if (soft_bus_write(&bus->sda, level))
+    return true;
+  bus->error = SOFT_I2C_BUS_ERROR;
+  return false;
+}
+
+static bool soft_i2c_scl_low(soft_i2c_t *bus) {
+  if (soft_bus_write(&bus->scl, false))
+    return true;
+  bus->error = SOFT_I2C_BUS_ERROR;
+  return false;
+}
+
+// Release SCL and wait while a slave stretches the clock
+static bool soft_i2c_scl_release(soft_i2c_t *bus) {
+  if (!soft_bus_write(&bus->scl, true)) {
+    bus->error = SOFT_I2C_BUS_ERROR;
+    return false;
+  }
+  if (bus->ignore_stretch || soft_bus_read(&bus->scl))
+    return true;
+
+  uint64_t deadline =
+      soft_bus_now_ns() + (uint64_t)bus->stretch_timeout_us * 1000;
+  while (!soft_bus_read(&bus->scl)) {
+    if (soft_bus_now_ns() > deadline) {
+      bus->error = SOFT_I2C_TIMEOUT;
+      return false;
+    }
+  }
+
+  // The high phase starts when the slave lets go
+  soft_bus_clock_start(&bus->clock);
+  return true;
+}
+
+// Start, or repeated start, from SCL low or an idle bus
+static bool soft_i2c_start(soft_i2c_t *bus) {
+  if (!soft_i2c_sda(bus, true))
+    return false;
+  soft_bus_delay(&bus->clock);
+  if (!soft_i2c_scl_release(bus))
+    return false;
+  soft_bus_delay(&bus->clock);
+  if (!soft_i2c_sda(bus, false))
+    return false;
+  soft_bus_delay(&bus->clock);
+  return soft_i2c_scl_low(bus);
+}
+
+static bool soft_i2c_stop(soft_i2c_t *bus) {
+  if (!soft_i2c_sda(bus, false))
+    return false;
+  soft_bus_delay(&bus->clock);
+  if (!soft_i2c_scl_release(bus))
+    return false;
+  soft_bus_delay(&bus->clock);
+  if (!soft_i2c_sda(bus, true))
+    return false;
+  soft_bus_delay(&bus->clock);
+  return true;
+}
+
+static bool soft_i2c_write_bit(soft_i2c_t *bus, bool bit) {
+  if (!soft_i2c_sda(bus, bit))
+    return false;
+  soft_bus_delay(&bus->clock);
+  if (!soft_i2c_scl_release(bus))
+    return false;
+  soft_bus_delay(&bus->clock);
+  return soft_i2c_scl_low(bus);
+}
+
+// -1 on a bus error
+static int soft_i2c_read_bit(soft_i2c_t *bus) {
+  if (!soft_i2c_sda(bus, true))
+    return -1;
+  soft_bus_delay(&bus->clock);
+  if (!soft_i2c_scl_release(bus))
+    return -1;
+  soft_bus_delay(&bus->clock);
+  bool bit = soft_bus_read(&bus->sda);
+  return soft_i2c_scl_low(bus) ? bit : -1;
+}
+
+// 1 if the slave acknowledged, 0 if not, -1 on a bus error
+static int soft_i2c_write_byte(soft_i2c_t *bus, uint8_t byte) {
+  for (uint8_t mask = 0x80; mask; mask >>= 1) {
+    if (!soft_i2c_write_bit(bus, byte & mask))
+      return -1;
+  }
+  int nack = soft_i2c_read_bit(bus);
+  return nack < 0 ? -1 : !nack;
+}
+
+static bool soft_i2c_read_byte(soft_i2c_t *bus, uint8_t *byte, bool ack) {
+  uint8_t value = 0;
+  for (int i = 0; i < 8; i++) {
+    int bit = soft_i2c_read_bit(bus);
+    if (bit < 0)
+      return false;
+    value = (uint8_t)(value << 1 | bit);
+  }
+  *byte = value;
+  return soft_i2c_write_bit(bus, !ack);
+}
+
+static bool soft_i2c_address(soft_i2c_t *bus, uint8_t address, bool read) {
+  int ack = soft_i2c_write_byte(bus, (uint8_t)(address << 1 | read));
+  if (!ack)
+    bus->error = SOFT_I2C_NACK_ADDRESS;
+  return ack > 0;
+}
+
+static bool soft_i2c_send(soft_i2c_t *bus, const uint8_t *data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    int ack = soft_i2c_write_byte(bus, data[i]);
+    if (ack <= 0) {
+      if (!ack)
+        bus->error = SOFT_I2C_NACK_DATA;
+      return false;
+    }
+  }
+  return true;
+}
+
+// The last byte is not acknowledged, which ends the slave's reply
+static bool soft_i2c_receive(soft_i2c_t *bus, uint8_t *data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    if (!soft_i2c_read_byte(bus, &data[i], i + 1 < len))
+      return false;
+  }
+  return true;
+}
+
+// Send the stop after a NACK too, so the bus is released; a failing pin
+// leaves nothing to release
+static bool soft_i2c_finish(soft_i2c_t *bus, bool ok) {
+  bool stopped = bus->error == SOFT_I2C_BUS_ERROR || soft_i2c_stop(bus);
+  return ok && stopped;
+}
+
+bool soft_i2c_init(soft_i2c_t *bus, const soft_i2c_config_t *config) {
+  if (!bus || !config || !config->scl || !config->sda)
+    return false;
+
+  soft_bus_pin_init(&bus->scl, config->scl);
+  soft_bus_pin_init(&bus->sda, config->sda);
+  soft_bus_clock_init(&bus->clock, config->speed_hz);
+  bus->stretch_timeout_us = config->stretch_timeout_us
+                                ? config->stretch_timeout_us
+                                : SOFT_I2C_STRETCH_TIMEOUT_US;
+  bus->ignore_stretch = config->ignore_stretch;
+  bus->error = SOFT_I2C_OK;
+
+  soft_bus_clock_start(&bus->clock);
+  if (!soft_i2c_sda(bus, true) || !soft_i2c_scl_release(bus))
+    return false;
+
+  // A slave interrupted mid-byte may still hold SDA low: clock it through
+  // the rest of the byte, then take the bus back with a stop
+  for (int i = 0; i < 9 && !soft_bus_read(&bus->sda); i++) {
+    if (!soft_i2c_scl_low(bus))
+      return false;
+    soft_bus_delay(&bus->clock);
+    if (!soft_i2c_scl_release(bus))
+      return false;
+    soft_bus_delay(&bus->clock);
+  }
+  if (!soft_bus_read(&bus->sda)) {
+    bus->error = SOFT_I2C_BUS_ERROR;
+    return false;
+  }
+  return soft_i2c_scl_low(bus) && soft_i2c_stop(bus);
+}
+
+bool soft_i2c_transfer(soft_i2c_t *bus, uint8_t address, const uint8_t *tx,
+                       size_t tx_len, uint8_t *rx, size_t rx_len) {
+  if (!bus || address > 0x7f || (tx_len && !tx) || (rx_len && !rx))
+    return false;
+
+  bus->error = SOFT_I2C_OK;
+  soft_bus_clock_start(&bus->clock);
+
+  // An empty transfer is an address-only write, as used by probes
+  bool ok = soft_i2c_start(bus);
+  if (ok && (tx_len || !rx_len))
+    ok = soft_i2c_address(bus, address, false) &&
+         soft_i2c_send(bus, tx, tx_len);
+  if (ok && rx_len) {
+    if (tx_len)
+      ok = soft_i2c_start(bus);
+    ok = ok && soft_i2c_address(bus, address, true) &&
+         soft_i2c_receive(bus, rx, rx_len);
+  }
+  return soft_i2c_finish(bus, ok);
+}
+
+bool soft_i2c_write(soft_i2c_t *bus, uint8_t address, const uint8_t *data,
+                    size_t len) {
+  return soft_i2c_transfer(bus, address, data, len, NULL, 0);
+}
+
+bool soft_i2c_read(soft_i2c_t *bus, uint8_t address, uint8_t *data,
+                   size_t len) {
+  return soft_i2c_transfer(bus, address, NULL, 0, data, len);
+}
+
+bool soft_i2c_write_reg(soft_i2c_t *bus, uint8_t address, uint8_t reg,
+                        const uint8_t *data, size_t len) {
+  if (!bus || address > 0x7f || (len && !data))
+    return false;
+
+  // Register and data go out in one write, no buffer needed
+  bus->error = SOFT_I2C_OK;
+  soft_bus_clock_start(&bus->clock);
+  bool ok = soft_i2c_start(bus) && soft_i2c_address(bus, address, false) &&
+            soft_i2c_send(bus, &reg, 1) && soft_i2c_send(bus, data, len);
+  return soft_i2c_finish(bus, ok);
+}
+
+bool soft_i2c_read_reg(soft_i2c_t *bus, uint8_t address, uint8_t reg,
+                       uint8_t *data, size_t len) {
+  return soft_i2c_transfer(bus, address, &reg, 1, data, len);
+}
+
+bool soft_i2c_probe(soft_i2c_t *bus, uint8_t address) {
+  return soft_i2c_transfer(bus, address, NULL, 0, NULL, 0);
+}
@@ -0,0 +1,150 @@
+#include "hal/soft_spi.h"
+
+// Bit of pin in the bank, 0 if the bank does not hold it
+static uint32_t soft_spi_bank_bit(const gpio_bank_t *bank,
+                                  const gpio_handle_t *pin) {
+  for (uint8_t i = 0; pin && i < bank->num_pins; i++) {
+    if (bank->pins[i] == pin)
+      return 1u << i;
+  }
+  return 0;
+}
+
+// Set SCK, and MOSI if it changes, in one bank write when possible
+static bool soft_spi_drive(soft_spi_t *bus, bool sck, bool mosi) {
+  bool mosi_changed = bus->mosi.gpio && mosi != bus->mosi_level;
+
+  if (bus->bank) {
+    uint32_t mask = bus->sck_bit | (mosi_changed ? bus->mosi_bit : 0);
+    uint32_t bits = (sck ? bus->sck_bit : 0) | (mosi ? bus->mosi_bit : 0);
+    if (!gpio_bank_write(bus->bank, mask, bits))
+      return false;
+  } else {
+    if (!soft_bus_write(&bus->sck, sck))
+      return false;
+    if (mosi_changed && !soft_bus_write(&bus->mosi, mosi))
+      return false;
+  }
+
+  bus->mosi_level = mosi;
+  return true;
+}
+
+static bool soft_spi_miso(soft_spi_t *bus) {
+  return bus->miso.gpio && soft_bus_read(&bus->miso);
+}
+
+static bool soft_spi_byte(soft_spi_t *bus, uint8_t out, uint8_t *in) {
+  bool idle = bus->cpol;
+  uint8_t value = 0;
+
+  for (int i = 0; i < 8; i++) {
+    int shift = bus->lsb_first ? i : 7 - i;
+    bool bit = (out >> shift) & 1;
+
+    if (!bus->cpha) {
+      // Set up while the clock idles (ending the previous bit), sample on
+      // the leading edge
+      if (!soft_spi_drive(bus, idle, bit))
+        return false;
+      soft_bus_delay(&bus->clock);
+      if (!soft_spi_drive(bus, !idle, bit))
+        return false;
+      value |= (uint8_t)(soft_spi_miso(bus) << shift);
+      soft_bus_delay(&bus->clock);
+    } else {
+      // Set up on the leading edge, sample on the trailing one
+      if (!soft_spi_drive(bus, !idle, bit))
+        return false;
+      soft_bus_delay(&bus->clock);
+      if (!soft_spi_drive(bus, idle, bit))
+        return false;
+      value |= (uint8_t)(soft_spi_miso(bus) << shift);
+      soft_bus_delay(&bus->clock);
+    }
+  }
+
+  if (in)
+    *in = value;
+  return true;
+}
+
+static bool soft_spi_exchange(soft_spi_t *bus, const uint8_t *tx, uint8_t *rx,
+                              size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    if (!soft_spi_byte(bus, tx ? tx[i] : 0, rx ? &rx[i] : NULL))
+      return false;
+  }
+  return true;
+}
+
+static bool soft_spi_select(soft_spi_t *bus, uint8_t device) {
+  soft_bus_clock_start(&bus->clock);
+  if (bus->cs[device].gpio && !soft_bus_write(&bus->cs[device], false))
+    return false;
+  soft_bus_delay(&bus->clock);
+  return true;
+}
+
+// Return the clock to idle (mode 0 and 2 end on the leading edge), then
+// release the chip select even after a failed transfer
+static bool soft_spi_deselect(soft_spi_t *bus, uint8_t device, bool ok) {
+  ok = ok && soft_spi_drive(bus, bus->cpol, bus->mosi_level);
+  soft_bus_delay(&bus->clock);
+  if (bus->cs[device].gpio && !soft_bus_write(&bus->cs[device], true))
+    return false;
+  return ok;
+}
+
+bool soft_spi_init(soft_spi_t *bus, const soft_spi_config_t *config) {
+  if (!bus || !config || !config->sck || config->mode > 3)
+    return false;
+
+  soft_bus_pin_init(&bus->sck, config->sck);
+  soft_bus_pin_init(&bus->mosi, config->mosi);
+  soft_bus_pin_init(&bus->miso, config->miso);
+  for (int i = 0; i < SOFT_SPI_MAX_DEVICES; i++)
+    soft_bus_pin_init(&bus->cs[i], config->cs[i]);
+  soft_bus_clock_init(&bus->clock, config->speed_hz);
+  bus->cpol = config->mode & 2;
+  bus->cpha = config->mode & 1;
+  bus->lsb_first = config->lsb_first;
+
+  // The bank is only used if it holds every pin the edges write
+  bus->bank = NULL;
+  if (config->bank) {
+    bus->sck_bit = soft_spi_bank_bit(config->bank, config->sck);
+    bus->mosi_bit = soft_spi_bank_bit(config->bank, config->mosi);
+    if (bus->sck_bit && (bus->mosi_bit || !config->mosi))
+      bus->bank = config->bank;
+  }
+
+  // Idle clock, MOSI low, every slave deselected
+  bus->mosi_level = true;
+  if (!soft_spi_drive(bus, bus->cpol, false))
+    return false;
+  for (int i = 0; i < SOFT_SPI_MAX_DEVICES; i++) {
+    if (bus->cs[i].gpio && !soft_bus_write(&bus->cs[i], true))
+      return false;
+  }
+  return true;
+}
+
+bool soft_spi_transfer(soft_spi_t *bus, uint8_t device, const uint8_t *tx,
+                       uint8_t *rx, size_t len) {
+  if (!bus || device >= SOFT_SPI_MAX_DEVICES || !soft_spi_select(bus, device))
+    return false;
+
+  return soft_spi_deselect(bus, device, soft_spi_exchange(bus, tx, rx, len));
+}
+
+bool soft_spi_write_then_read(soft_spi_t *bus, uint8_t device,
+                              const uint8_t *tx, size_t tx_len, uint8_t *rx,
+                              size_t rx_len) {
+  if (!bus || device >= SOFT_SPI_MAX_DEVICES || !soft_spi_select(bus, device))
+    return false;
+
+  bool ok = soft_spi_exchange(bus, tx, NULL, tx_len) &&
+            soft_spi_exchange(bus, NULL, rx, rx_len);
+  return soft_spi_deselect(bus, device, ok);
+}
@@ -0,0 +1,169 @@
+#include "bus_slave_mock.h"
+#include "gpio_mock.h"
+
+static void i2c_slave_output(uint32_t pin, bool level, void *arg) {
+    i2c_slave_mock_t *slave = arg;
+
+    // SDA only changes while SCL is high for a start or a stop
+    if (pin == slave->sda_pin) {
+        if (!gpio_mock_get_pin_state(slave->scl_pin)) return;
+        slave->pull_sda = false;
+        if (level) {
+            slave->state = I2C_SLAVE_IDLE;
+            slave->stops++;
+        } else {
+            slave->state = I2C_SLAVE_ADDRESS;
+            slave->clocks = 0;
+            slave->shift = 0;
+            slave->starts++;
+        }
+        return;
+    }
+    if (pin != slave->scl_pin || slave->state == I2C_SLAVE_IDLE) return;
+
+    bool sda = gpio_mock_get_pin_state(slave->sda_pin) && !slave->pull_sda;
+    if (level) {
+        if (slave->clocks < 8 && slave->state != I2C_SLAVE_TRANSMIT) {
+            slave->shift = (uint8_t)(slave->shift << 1 | sda);
+        } else if (slave->clocks == 8 && slave->state == I2C_SLAVE_TRANSMIT && sda) {
+            slave->state = I2C_SLAVE_IDLE; // NACK from the master ends the read
+        }
+        slave->clocks++;
+        return;
+    }
+
+    // Falling edge: the slave changes SDA while SCL is low. The one ending
+    // a start condition comes before any clock and finds clocks at 0.
+    if (slave->clocks == 8) {
+        switch (slave->state) {
+        case I2C_SLAVE_ADDRESS:
+            if (slave->shift >> 1 != slave->address) {
+                slave->state = I2C_SLAVE_IDLE;
+                break;
+            }
+            slave->pull_sda = true;
+            if (slave->shift & 1) {
+                slave->state = I2C_SLAVE_TRANSMIT;
+            } else {
+                slave->state = I2C_SLAVE_RECEIVE;
+                slave->pointer_set = false;
+            }
+            break;
+        case I2C_SLAVE_RECEIVE:
+            if (slave->pointer_set) {
+                slave->regs[slave->pointer++] = slave->shift;
+            } else {
+                slave->pointer = slave->shift;
+                slave->pointer_set = true;
+            }
+            slave->pull_sda = true;
+            break;
+        default:
+            slave->pull_sda = false; // The master acknowledges
+            break;
+        }
+    } else if (slave->clocks == 9) {
+        slave->clocks = 0;
+        slave->stretch_left = slave->stretch_reads;
+        slave->pull_sda = false;
+        if (slave->state == I2C_SLAVE_TRANSMIT) {
+            slave->shift = slave->regs[slave->pointer++];
+            slave->pull_sda = !(slave->shift & 0x80);
+        } else {
+            slave->shift = 0;
+        }
+    } else if (slave->state == I2C_SLAVE_TRANSMIT) {
+        slave->pull_sda = !((slave->shift << slave->clocks) & 0x80);
+    }
+}
+
+static bool i2c_slave_input(uint32_t pin, bool level, void *arg) {
+    i2c_slave_mock_t *slave = arg;
+    if (pin == slave->sda_pin) return level && !slave->pull_sda;
+    if (pin == slave->scl_pin && level && slave->stretch_left) {
+        slave->stretch_left--;
+        return false;
+    }
+    return level;
+}
+
+void i2c_slave_mock_attach(i2c_slave_mock_t *slave) {
+    slave->state = I2C_SLAVE_IDLE;
+    slave->pull_sda = false;
+    slave->stretch_left = 0;
+    gpio_mock_set_input_hook(i2c_slave_input, slave);
+    gpio_mock_set_output_hook(i2c_slave_output, slave);
+}
+
+// Put the next bit of out on MISO, reloading it after a whole byte
+static void spi_slave_present(spi_slave_mock_t *slave) {
+    if (slave->out_bits == 8) {
+        slave->out = slave->reply;
+        slave->out_bits = 0;
+    }
+    if (slave->lsb_first) {
+        slave->miso = slave->out & 1;
+        slave->out >>= 1;
+    } else {
+        slave->miso = slave->out & 0x80;
+        slave->out <<= 1;
+    }
+    slave->out_bits++;
+}
+
+static void spi_slave_sample(spi_slave_mock_t *slave) {
+    bool bit = gpio_mock_get_pin_state(slave->mosi_pin);
+    if (slave->lsb_first) {
+        slave->in = (uint8_t)(slave->in >> 1 | bit << 7);
+    } else {
+        slave->in = (uint8_t)(slave->in << 1 | bit);
+    }
+    if (++slave->bits == 8) {
+        if (slave->count < sizeof(slave->received)) slave->received[slave->count++] = slave->in;
+        slave->reply = slave->in;
+        slave->bits = 0;
+    }
+}
+
+static void spi_slave_output(uint32_t pin, bool level, void *arg) {
+    spi_slave_mock_t *slave = arg;
+    bool cpol = slave->mode & 2;
+    bool cpha = slave->mode & 1;
+
+    if (pin == slave->cs_pin) {
+        slave->selected = !level;
+        if (slave->selected) {
+            slave->bits = 0;
+            slave->out = slave->reply;
+            slave->out_bits = 0;
+            if (!cpha) spi_slave_present(slave); // First bit before the first edge
+        }
+        return;
+    }
+    if (pin != slave->sck_pin || !slave->selected) return;
+
+    // Mode 0 and 2 sample on the leading edge, 1 and 3 on the trailing one
+    bool leading = level != cpol;
+    if (leading != cpha) {
+        spi_slave_sample(slave);
+    } else {
+        spi_slave_present(slave);
+    }
+}
+
+static bool spi_slave_input(uint32_t pin, bool level, void *arg) {
+    spi_slave_mock_t *slave = arg;
+    return pin == slave->miso_pin ? slave->miso : level;
+}
+
+void spi_slave_mock_attach(spi_slave_mock_t *slave) {
+    slave->selected = false;
+    slave->count = 0;
+    gpio_mock_set_input_hook(spi_slave_input, slave);
+    gpio_mock_set_output_hook(spi_slave_output, slave);
+}
+
+void bus_slave_mock_detach(void) {
+    gpio_mock_set_input_hook(NULL, NULL);
+    gpio_mock_set_output_hook(NULL, NULL);
+}
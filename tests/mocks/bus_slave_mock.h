@@ -0,0 +1,67 @@
+#ifndef UNI_LIB_BUS_SLAVE_MOCK_H
+#define UNI_LIB_BUS_SLAVE_MOCK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Simulated I2C slave on two mock pins
+ *
+ * A register file behind an auto-incrementing pointer: the first byte of a
+ * write sets the pointer, further bytes are stored from it, and reads
+ * return registers from it. The slave pulls SDA low through the mock's
+ * input hook and follows the master through its output hook.
+ */
+typedef struct {
+    uint32_t scl_pin;
+    uint32_t sda_pin;
+    uint8_t address;
+    uint8_t regs[256];
+    uint32_t stretch_reads; // SCL reads held low after each byte (stretching)
+
+    // Bus state
+    enum { I2C_SLAVE_IDLE, I2C_SLAVE_ADDRESS, I2C_SLAVE_RECEIVE, I2C_SLAVE_TRANSMIT } state;
+    uint8_t clocks; // SCL pulses of the current byte, 9 with the ACK
+    uint8_t shift;
+    bool pointer_set;
+    uint8_t pointer;
+    bool pull_sda;
+    uint32_t stretch_left;
+    uint32_t starts; // Start conditions seen, repeated starts included
+    uint32_t stops;
+} i2c_slave_mock_t;
+
+/**
+ * Simulated SPI slave: an 8-bit shift register on four mock pins
+ *
+ * Each byte shifted out is the byte received before it (reply at first),
+ * the way a chain of shift registers answers.
+ */
+typedef struct {
+    uint32_t sck_pin;
+    uint32_t mosi_pin;
+    uint32_t miso_pin;
+    uint32_t cs_pin;
+    uint8_t mode; // CPOL << 1 | CPHA
+    bool lsb_first;
+    uint8_t reply;
+
+    uint8_t received[64];
+    size_t count;
+
+    // Bus state
+    bool selected;
+    uint8_t bits;     // Sampled in the current byte
+    uint8_t out_bits; // Shifted out of out
+    uint8_t in;
+    uint8_t out;
+    bool miso;
+} spi_slave_mock_t;
+
+// Wire the slave to the GPIO mock, replacing its input and output hooks
+void i2c_slave_mock_attach(i2c_slave_mock_t *slave);
+void spi_slave_mock_attach(spi_slave_mock_t *slave);
+void bus_slave_mock_detach(void);
+
+#endif // UNI_LIB_BUS_SLAVE_MOCK_H
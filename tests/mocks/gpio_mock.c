@@ -1,56 +1,183 @@
 #include "gpio_mock.h"
+#include "hal/gpio_filter.h"
+#include <stdatomic.h>
+#include <stdlib.h>
 #include <string.h>
 
-#define MAX_PINS 64
+typedef struct {
+    uint32_t pin;
+} gpio_mock_pin_t;
 
+// Pin levels and counters may be hit from several threads at once
 static struct {
-    bool pin_states[MAX_PINS];
-    bool initialized[MAX_PINS];
+    atomic_bool pin_states[GPIO_MOCK_MAX_PINS];
+    bool initialized[GPIO_MOCK_MAX_PINS];
+    void (*callbacks[GPIO_MOCK_MAX_PINS])(void *);
+    void *callback_args[GPIO_MOCK_MAX_PINS];
+    atomic_uint write_counts[GPIO_MOCK_MAX_PINS];
+    atomic_uint bank_write_count;
+    atomic_uint bank_read_count;
+    gpio_mock_input_hook_t input_hook;
+    void *input_hook_arg;
+    gpio_mock_output_hook_t output_hook;
+    void *output_hook_arg;
+    gpio_filter_t filters[GPIO_MOCK_MAX_PINS];
+    bool filter_in_hw[GPIO_MOCK_MAX_PINS];
+    bool debounce_in_hw;
+    uint64_t now_us;
 } mock_data;
 
-static bool gpio_mock_init(gpio_handle_t *self, const gpio_config_t *config) {
-    if (!self || !config || config->pin >= MAX_PINS) return false;
+static uint32_t gpio_mock_pin(gpio_handle_t *self) {
+    return ((gpio_mock_pin_t *)self->hw_handle)->pin;
+}
+
+// Level at the pin, after the simulated wiring
+static bool gpio_mock_raw(uint32_t pin) {
+    bool level = atomic_load(&mock_data.pin_states[pin]);
+    if (mock_data.input_hook) {
+        level = mock_data.input_hook(pin, level, mock_data.input_hook_arg);
+    }
+    return level;
+}
+
+// Level seen by the driver, after the debounce filter
+static bool gpio_mock_level(uint32_t pin) {
+    bool level = gpio_mock_raw(pin);
+    if (mock_data.filters[pin].period_us) {
+        level = gpio_filter_sample(&mock_data.filters[pin], level, mock_data.now_us);
+    }
+    return level;
+}
+
+// Runs a hardware filter; true if its settled level changed
+static bool gpio_mock_filter_step(uint32_t pin) {
+    bool before = gpio_filter_level(&mock_data.filters[pin]);
+    return gpio_mock_level(pin) != before;
+}
+
+GPIO_BACKEND_API bool gpio_mock_init(gpio_handle_t *self, const gpio_config_t *config) {
+    if (!self || !self->hw_handle || !config || config->pin >= GPIO_MOCK_MAX_PINS) return false;
+    ((gpio_mock_pin_t *)self->hw_handle)->pin = config->pin;
+    self->active_high = config->active_high;
+    self->debounce_us = config->is_output ? 0 : config->debounce_us;
+    self->debounce_hw = mock_data.debounce_in_hw;
+    gpio_filter_init(&mock_data.filters[config->pin], self->debounce_us);
+    mock_data.filter_in_hw[config->pin] = mock_data.debounce_in_hw;
+    if (self->debounce_us) {
+        gpio_mock_level(config->pin); // Primes the filter
+    }
     mock_data.initialized[config->pin] = true;
     return true;
 }
 
-static bool gpio_mock_deinit(gpio_handle_t *self) {
+GPIO_BACKEND_API bool gpio_mock_deinit(gpio_handle_t *self) {
+    if (!self || !self->hw_handle) return false;
+    uint32_t pin = gpio_mock_pin(self);
+    mock_data.initialized[pin] = false;
+    mock_data.callbacks[pin] = NULL;
+    gpio_filter_init(&mock_data.filters[pin], 0);
     return true;
 }
 
-static bool gpio_mock_write(gpio_handle_t *self, bool state) {
+GPIO_BACKEND_API bool gpio_mock_write(gpio_handle_t *self, bool state) {
     if (!self || !self->hw_handle) return false;
-    uint32_t pin = *(uint32_t*)self->hw_handle;
-    if (pin >= MAX_PINS) return false;
-    mock_data.pin_states[pin] = state;
+    uint32_t pin = gpio_mock_pin(self);
+    atomic_fetch_add(&mock_data.write_counts[pin], 1);
+    gpio_mock_set_pin_state(pin, state);
     return true;
 }
 
-static bool gpio_mock_read(gpio_handle_t *self) {
+GPIO_BACKEND_API bool gpio_mock_read(gpio_handle_t *self) {
+    if (!self || !self->hw_handle) return false;
+    return gpio_mock_level(gpio_mock_pin(self));
+}
+
+GPIO_BACKEND_API bool gpio_mock_activate(gpio_handle_t *self) {
+    return gpio_mock_write(self, self->active_high);
+}
+
+GPIO_BACKEND_API bool gpio_mock_deactivate(gpio_handle_t *self) {
+    return gpio_mock_write(self, !self->active_high);
+}
+
+GPIO_BACKEND_API bool gpio_mock_is_active(gpio_handle_t *self) {
     if (!self || !self->hw_handle) return false;
-    uint32_t pin = *(uint32_t*)self->hw_handle;
-    if (pin >= MAX_PINS) return false;
-    return mock_data.pin_states[pin];
+    bool pin_high = gpio_mock_read(self);
+    return self->active_high ? pin_high : !pin_high;
 }
 
+GPIO_BACKEND_API bool gpio_mock_toggle(gpio_handle_t *self) {
+    if (!self || !self->hw_handle) return false;
+    return gpio_mock_write(self, !gpio_mock_read(self));
+}
+
+GPIO_BACKEND_API bool gpio_mock_set_interrupt(gpio_handle_t *self, void (*callback)(void *),
+                                              void *arg) {
+    if (!self || !self->hw_handle) return false;
+    uint32_t pin = gpio_mock_pin(self);
+    mock_data.callbacks[pin] = callback;
+    mock_data.callback_args[pin] = arg;
+    return true;
+}
+
+static const gpio_ops_t gpio_mock_ops = {
+    .init = gpio_mock_init,
+    .deinit = gpio_mock_deinit,
+    .write = gpio_mock_write,
+    .read = gpio_mock_read,
+    .activate = gpio_mock_activate,
+    .deactivate = gpio_mock_deactivate,
+    .is_active = gpio_mock_is_active,
+    .toggle = gpio_mock_toggle,
+    .set_interrupt = gpio_mock_set_interrupt,
+};
+
 static bool gpio_mock_create(gpio_handle_t *handle) {
     if (!handle) return false;
-    
-    static uint32_t pin_number;
-    handle->hw_handle = &pin_number;
-    
-    handle->init = gpio_mock_init;
-    handle->deinit = gpio_mock_deinit;
-    handle->write = gpio_mock_write;
-    handle->read = gpio_mock_read;
-    
+
+    gpio_mock_pin_t *hw = calloc(1, sizeof(gpio_mock_pin_t));
+    if (!hw) return false;
+
+    handle->hw_handle = hw;
+    gpio_bind_ops(handle, &gpio_mock_ops);
+
+    return true;
+}
+
+static bool gpio_mock_destroy(gpio_handle_t *handle) {
+    if (!handle || !handle->hw_handle) return false;
+    free(handle->hw_handle);
+    handle->hw_handle = NULL;
     return true;
 }
 
-static void gpio_mock_destroy(gpio_handle_t *handle) {
-    // Nothing to clean up
+static bool gpio_mock_bank_write(gpio_bank_t *self, uint32_t mask, uint32_t bits) {
+    atomic_fetch_add(&mock_data.bank_write_count, 1);
+    for (uint8_t i = 0; i < self->num_pins; i++) {
+        if (mask & (1u << i)) {
+            gpio_mock_set_pin_state(gpio_mock_pin(self->pins[i]), bits & (1u << i));
+        }
+    }
+    return true;
 }
 
+static bool gpio_mock_bank_read(gpio_bank_t *self, uint32_t *bits) {
+    atomic_fetch_add(&mock_data.bank_read_count, 1);
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < self->num_pins; i++) {
+        if (gpio_mock_level(gpio_mock_pin(self->pins[i]))) {
+            value |= 1u << i;
+        }
+    }
+    *bits = value;
+    return true;
+}
+
+static const gpio_bank_ops_t gpio_mock_bank_ops = {
+    .write = gpio_mock_bank_write,
+    .read = gpio_mock_bank_read,
+};
+
 const gpio_driver_t gpio_mock_driver = {
     .create = gpio_mock_create,
     .destroy = gpio_mock_destroy
@@ -58,14 +185,25 @@ const gpio_driver_t gpio_mock_driver = {
 
 // Mock control functions
 void gpio_mock_set_pin_state(uint32_t pin, bool state) {
-    if (pin < MAX_PINS) {
-        mock_data.pin_states[pin] = state;
+    if (pin < GPIO_MOCK_MAX_PINS) {
+        bool changed = atomic_exchange(&mock_data.pin_states[pin], state) != state;
+        if (changed && mock_data.output_hook) {
+            mock_data.output_hook(pin, state, mock_data.output_hook_arg);
+        }
+        // A hardware filter holds the edge back until the level settles
+        if (changed && mock_data.filters[pin].period_us && mock_data.filter_in_hw[pin]) {
+            changed = gpio_mock_filter_step(pin);
+        }
+        // Edge interrupt, delivered synchronously
+        if (changed && mock_data.callbacks[pin]) {
+            mock_data.callbacks[pin](mock_data.callback_args[pin]);
+        }
     }
 }
 
 bool gpio_mock_get_pin_state(uint32_t pin) {
-    if (pin < MAX_PINS) {
-        return mock_data.pin_states[pin];
+    if (pin < GPIO_MOCK_MAX_PINS) {
+        return atomic_load(&mock_data.pin_states[pin]);
     }
     return false;
 }
@@ -73,3 +211,45 @@ bool gpio_mock_get_pin_state(uint32_t pin) {
 void gpio_mock_reset(void) {
     memset(&mock_data, 0, sizeof(mock_data));
 }
+
+uint32_t gpio_mock_get_write_count(uint32_t pin) {
+    return pin < GPIO_MOCK_MAX_PINS ? atomic_load(&mock_data.write_counts[pin]) : 0;
+}
+
+bool gpio_mock_bank_attach(gpio_bank_t *bank) {
+    if (!bank) return false;
+    bank->ops = &gpio_mock_bank_ops;
+    return true;
+}
+
+uint32_t gpio_mock_get_bank_write_count(void) {
+    return atomic_load(&mock_data.bank_write_count);
+}
+
+uint32_t gpio_mock_get_bank_read_count(void) {
+    return atomic_load(&mock_data.bank_read_count);
+}
+
+void gpio_mock_set_input_hook(gpio_mock_input_hook_t hook, void *arg) {
+    mock_data.input_hook = hook;
+    mock_data.input_hook_arg = arg;
+}
+
+void gpio_mock_set_output_hook(gpio_mock_output_hook_t hook, void *arg) {
+    mock_data.output_hook = hook;
+    mock_data.output_hook_arg = arg;
+}
+
+void gpio_mock_set_debounce_in_hw(bool in_hw) {
+    mock_data.debounce_in_hw = in_hw;
+}
+
+void gpio_mock_advance_us(uint64_t us) {
+    mock_data.now_us += us;
+    for (uint32_t pin = 0; pin < GPIO_MOCK_MAX_PINS; pin++) {
+        if (!mock_data.filters[pin].period_us || !mock_data.filter_in_hw[pin]) continue;
+        if (gpio_mock_filter_step(pin) && mock_data.callbacks[pin]) {
+            mock_data.callbacks[pin](mock_data.callback_args[pin]);
+        }
+    }
+}
@@ -2,6 +2,9 @@
 #define UNI_LIB_GPIO_MOCK_H
 
 #include "hal/gpio.h"
+#include "hal/gpio_bank.h"
+
+#define GPIO_MOCK_MAX_PINS 512
 
 // Mock GPIO driver for testing
 extern const gpio_driver_t gpio_mock_driver;
@@ -11,4 +14,30 @@ void gpio_mock_set_pin_state(uint32_t pin, bool state);
 bool gpio_mock_get_pin_state(uint32_t pin);
 void gpio_mock_reset(void);
 
+// Number of pin writes that reached the mock since the last reset
+uint32_t gpio_mock_get_write_count(uint32_t pin);
+
+// Native bank access: one mock call per bank read/write
+bool gpio_mock_bank_attach(gpio_bank_t *bank);
+uint32_t gpio_mock_get_bank_write_count(void);
+uint32_t gpio_mock_get_bank_read_count(void);
+
+// Simulated wiring: the hook returns the level seen when a pin is read
+typedef bool (*gpio_mock_input_hook_t)(uint32_t pin, bool level, void *arg);
+void gpio_mock_set_input_hook(gpio_mock_input_hook_t hook, void *arg);
+
+// Simulated devices: the hook sees every level change of a pin, before the
+// pin's edge interrupt
+typedef void (*gpio_mock_output_hook_t)(uint32_t pin, bool level, void *arg);
+void gpio_mock_set_output_hook(gpio_mock_output_hook_t hook, void *arg);
+
+// Input debounce: pins initialized with debounce_us run a gpio_filter_t on
+// the mock's clock, which only moves with gpio_mock_advance_us(). In
+// hardware mode the filter runs on every level change and clock step, and
+// edge interrupts only report settled levels; otherwise (the default) it
+// stands for a driver filter: reads sample it, interrupts see every bounce.
+// The mode applies to pins initialized after the call.
+void gpio_mock_set_debounce_in_hw(bool in_hw);
+void gpio_mock_advance_us(uint64_t us);
+
 #endif // UNI_LIB_GPIO_MOCK_H
@@ -0,0 +1,187 @@
+#include "gpio_trace.h"
+#include "gpio_mock.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRACE_MAGIC "UTRC"
+#define TRACE_VERSION 1
+
+static volatile uint64_t replay_now_us;
+
+void gpio_trace_init(gpio_trace_t *trace) {
+    memset(trace, 0, sizeof(*trace));
+}
+
+void gpio_trace_free(gpio_trace_t *trace) {
+    free(trace->transitions);
+    gpio_trace_init(trace);
+}
+
+bool gpio_trace_append(gpio_trace_t *trace, uint64_t time_us, uint8_t pin, bool level) {
+    if (!trace || pin >= 128) return false;
+
+    // Transitions must be in time order
+    if (trace->count && time_us < trace->transitions[trace->count - 1].time_us) return false;
+
+    if (trace->count == trace->capacity) {
+        size_t capacity = trace->capacity ? trace->capacity * 2 : 64;
+        gpio_trace_transition_t *grown =
+            realloc(trace->transitions, capacity * sizeof(*grown));
+        if (!grown) return false;
+        trace->transitions = grown;
+        trace->capacity = capacity;
+    }
+
+    trace->transitions[trace->count++] = (gpio_trace_transition_t){
+        .time_us = time_us, .pin = pin, .level = level};
+    return true;
+}
+
+static bool gpio_trace_load_csv(gpio_trace_t *trace, FILE *fp) {
+    char line[128];
+    while (fgets(line, sizeof(line), fp)) {
+        char *start = line + strspn(line, " \t");
+        if (*start == '#' || *start == '\n' || *start == '\0') continue;
+
+        uint64_t time_us;
+        unsigned pin, level;
+        if (sscanf(start, "%" SCNu64 ",%u,%u", &time_us, &pin, &level) != 3) {
+            // Tolerate a column header line
+            if (trace->count == 0 && strncmp(start, "time", 4) == 0) continue;
+            return false;
+        }
+        // Check the full value, the narrowing cast would wrap 256 to pin 0
+        if (pin >= 128) return false;
+        if (!gpio_trace_append(trace, time_us, (uint8_t)pin, level != 0)) return false;
+    }
+    return true;
+}
+
+static bool gpio_trace_load_binary(gpio_trace_t *trace, FILE *fp) {
+    uint8_t header[8];
+    if (fread(header, 1, sizeof(header), fp) != sizeof(header) || header[4] != TRACE_VERSION) {
+        return false;
+    }
+
+    uint64_t time_us = 0;
+    for (;;) {
+        uint64_t delta = 0;
+        int c, shift = 0;
+        while ((c = fgetc(fp)) != EOF) {
+            delta |= (uint64_t)(c & 0x7f) << shift;
+            shift += 7;
+            if (!(c & 0x80) || shift > 63) break;
+        }
+        if (c == EOF) return shift == 0; // Clean end between records
+        if (c & 0x80) return false;
+
+        int packed = fgetc(fp);
+        if (packed == EOF) return false;
+
+        time_us += delta;
+        if (!gpio_trace_append(trace, time_us, (uint8_t)(packed >> 1), packed & 1)) return false;
+    }
+}
+
+bool gpio_trace_load(gpio_trace_t *trace, const char *path) {
+    if (!trace || !path) return false;
+
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return false;
+
+    char magic[4] = {0};
+    size_t n = fread(magic, 1, sizeof(magic), fp);
+    rewind(fp);
+
+    gpio_trace_init(trace);
+    bool ok = (n == sizeof(magic) && memcmp(magic, TRACE_MAGIC, 4) == 0)
+                  ? gpio_trace_load_binary(trace, fp)
+                  : gpio_trace_load_csv(trace, fp);
+    fclose(fp);
+
+    if (!ok) gpio_trace_free(trace);
+    return ok;
+}
+
+bool gpio_trace_save_csv(const gpio_trace_t *trace, const char *path) {
+    if (!trace || !path) return false;
+
+    FILE *fp = fopen(path, "w");
+    if (!fp) return false;
+
+    fprintf(fp, "time_us,pin,level\n");
+    for (size_t i = 0; i < trace->count; i++) {
+        const gpio_trace_transition_t *t = &trace->transitions[i];
+        fprintf(fp, "%" PRIu64 ",%u,%u\n", t->time_us, t->pin, t->level ? 1u : 0u);
+    }
+
+    return fclose(fp) == 0;
+}
+
+bool gpio_trace_save_binary(const gpio_trace_t *trace, const char *path) {
+    if (!trace || !path) return false;
+
+    FILE *fp = fopen(path, "wb");
+    if (!fp) return false;
+
+    const uint8_t header[8] = {'U', 'T', 'R', 'C', TRACE_VERSION, 0, 0, 0};
+    bool ok = fwrite(header, 1, sizeof(header), fp) == sizeof(header);
+
+    uint64_t previous = 0;
+    for (size_t i = 0; ok && i < trace->count; i++) {
+        const gpio_trace_transition_t *t = &trace->transitions[i];
+        uint64_t delta = t->time_us - previous;
+        previous = t->time_us;
+
+        do {
+            uint8_t byte = delta & 0x7f;
+            delta >>= 7;
+            ok = fputc(delta ? byte | 0x80 : byte, fp) != EOF;
+        } while (ok && delta);
+        ok = ok && fputc((t->pin << 1) | (t->level ? 1 : 0), fp) != EOF;
+    }
+
+    // fclose flushes the buffer, so it reports late write errors too
+    return fclose(fp) == 0 && ok;
+}
+
+bool gpio_trace_replay(const gpio_trace_t *trace, const gpio_trace_replay_config_t *config) {
+    if (!trace || !config) return false;
+
+    TickType_t start = xTaskGetTickCount();
+    replay_now_us = 0;
+
+    for (size_t i = 0; i < trace->count; i++) {
+        const gpio_trace_transition_t *t = &trace->transitions[i];
+
+        if (config->speed) {
+            // Sleep until the scaled trace time, rounded down to a tick
+            uint64_t due_ms = t->time_us / 1000 / config->speed;
+            TickType_t due = start + pdMS_TO_TICKS(due_ms);
+            TickType_t now = xTaskGetTickCount();
+            if ((int32_t)(due - now) > 0) {
+                vTaskDelay(due - now);
+            }
+        }
+
+        if (config->on_advance) {
+            config->on_advance(t->time_us, config->arg);
+        }
+
+        replay_now_us = t->time_us;
+        gpio_mock_set_pin_state(t->pin, t->level);
+    }
+
+    return true;
+}
+
+uint64_t gpio_trace_now_us(void) {
+    return replay_now_us;
+}
+
+void gpio_trace_log_event(FILE *out, uint64_t time_us, const char *source, const char *event) {
+    fprintf(out, "%" PRIu64 ",%s,%s\n", time_us, source, event);
+}
@@ -0,0 +1,67 @@
+#ifndef UNI_LIB_GPIO_TRACE_H
+#define UNI_LIB_GPIO_TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * Pin transition captured from real hardware
+ */
+typedef struct {
+    uint64_t time_us; // Since the start of the trace
+    uint8_t pin;      // Mock pin the transition is replayed on (< 128)
+    bool level;
+} gpio_trace_transition_t;
+
+/**
+ * Timestamped pin-transition trace
+ *
+ * Traces are stored either as CSV ("time_us,pin,level" per line, '#'
+ * starts a comment) or in a compact binary form: the magic "UTRC", a
+ * version byte and 3 reserved bytes, then per transition the time since
+ * the previous one as an unsigned LEB128 varint followed by one byte
+ * (pin << 1 | level).
+ */
+typedef struct {
+    gpio_trace_transition_t *transitions;
+    size_t count;
+    size_t capacity;
+} gpio_trace_t;
+
+void gpio_trace_init(gpio_trace_t *trace);
+void gpio_trace_free(gpio_trace_t *trace);
+bool gpio_trace_append(gpio_trace_t *trace, uint64_t time_us, uint8_t pin, bool level);
+
+// Load detects the format from the magic
+bool gpio_trace_load(gpio_trace_t *trace, const char *path);
+bool gpio_trace_save_csv(const gpio_trace_t *trace, const char *path);
+bool gpio_trace_save_binary(const gpio_trace_t *trace, const char *path);
+
+/**
+ * Replay configuration
+ */
+typedef struct {
+    uint32_t speed; // 1: real time, N: N times faster, 0: as fast as possible
+    // Called with the trace time before each transition, e.g. to advance a
+    // virtual clock when replaying as fast as possible (optional)
+    void (*on_advance)(uint64_t time_us, void *arg);
+    void *arg;
+} gpio_trace_replay_config_t;
+
+/**
+ * Play the trace into the GPIO mock against the RTOS tick clock.
+ * Transitions closer together than a tick are applied back to back.
+ * Must be called from a task.
+ */
+bool gpio_trace_replay(const gpio_trace_t *trace, const gpio_trace_replay_config_t *config);
+
+// Trace time of the last transition applied by the replay
+uint64_t gpio_trace_now_us(void);
+
+// Append "time_us,source,event" for an event produced during the replay,
+// time_us being trace time when the event fired (e.g. a virtual clock)
+void gpio_trace_log_event(FILE *out, uint64_t time_us, const char *source, const char *event);
+
+#endif // UNI_LIB_GPIO_TRACE_H
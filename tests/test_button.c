@@ -17,6 +17,7 @@ void setUp(void) {
 
     // Create and configure button
     TEST_ASSERT_TRUE(button_driver.create(&button));
+    TEST_ASSERT_TRUE(gpio_mock_driver.create(&button.gpio));
     
     button_config_t config = {
         .gpio_config = {
@@ -38,6 +39,7 @@ void setUp(void) {
 void tearDown(void) {
     button.deinit(&button);
     button_driver.destroy(&button);
+    gpio_mock_driver.destroy(&button.gpio);
     vQueueDelete(event_queue);
 }
 
@@ -98,6 +100,122 @@ void test_button_debounce(void) {
     TEST_ASSERT_EQUAL(BUTTON_EVENT_PRESSED, received_event);
 }
 
+// Filtered pin on its own clock: the mock's and the timer service's move
+// together, one tick at a time
+static TickType_t virtual_tick;
+static uint32_t edge_wakeups;
+
+static TickType_t virtual_now(void *arg) {
+    (void)arg;
+    return virtual_tick;
+}
+
+static const timer_service_clock_t virtual_clock = {.now = virtual_now};
+
+static void advance_ticks(TickType_t ticks) {
+    while (ticks--) {
+        gpio_mock_advance_us(portTICK_PERIOD_MS * 1000u);
+        timer_service_advance(++virtual_tick);
+    }
+}
+
+// Edge driven application: every interrupt wakes it to call process()
+static void on_edge(void *arg) {
+    button_event_t event;
+    edge_wakeups++;
+    ((button_handle_t *)arg)->process(arg, &event);
+}
+
+// Ten bounces 0.5 ms apart, then the level holds
+static void bounce_to(uint32_t pin, bool level) {
+    for (int i = 0; i < 10; i++) {
+        gpio_mock_set_pin_state(pin, i % 2 ? !level : level);
+        gpio_mock_advance_us(500);
+    }
+    gpio_mock_set_pin_state(pin, level);
+}
+
+static void filtered_button_init(button_handle_t *self, QueueHandle_t events) {
+    timer_service_stop();
+    virtual_tick = timer_service_now();
+    TEST_ASSERT_TRUE(timer_service_set_clock(&virtual_clock));
+    edge_wakeups = 0;
+
+    button_config_t config = {
+        .gpio_config = {.pin = 1, .is_output = false, .active_high = true,
+                        .debounce_us = 20000},
+        .debounce_ms = 20,
+        .long_press_ms = 1000,
+        .event_queue = events,
+    };
+    TEST_ASSERT_TRUE(button_driver.create(self));
+    TEST_ASSERT_TRUE(gpio_mock_driver.create(&self->gpio));
+    TEST_ASSERT_TRUE(self->init(self, &config));
+    TEST_ASSERT_TRUE(gpio_set_interrupt(&self->gpio, on_edge, self));
+    TEST_ASSERT_EQUAL(20000, gpio_debounce_us(&self->gpio));
+}
+
+static void filtered_button_deinit(button_handle_t *self, QueueHandle_t events) {
+    button_driver.destroy(self);
+    gpio_mock_driver.destroy(&self->gpio);
+    vQueueDelete(events);
+    TEST_ASSERT_TRUE(timer_service_set_clock(NULL));
+}
+
+void test_button_debounce_in_hw(void) {
+    QueueHandle_t events = xQueueCreate(8, sizeof(button_event_t));
+    button_handle_t filtered;
+    gpio_mock_set_debounce_in_hw(true);
+    filtered_button_init(&filtered, events);
+    TEST_ASSERT_TRUE(gpio_debounce_in_hw(&filtered.gpio));
+
+    // Bounces never reach the application: one wakeup per settled edge,
+    // and the change is taken without a debounce timeout
+    bounce_to(1, true);
+    TEST_ASSERT_EQUAL(0, edge_wakeups);
+    advance_ticks(pdMS_TO_TICKS(30));
+    TEST_ASSERT_EQUAL(1, edge_wakeups);
+    TEST_ASSERT_FALSE(timeout_is_armed(&filtered.debounce));
+    TEST_ASSERT_FALSE(timeout_is_armed(&filtered.settle));
+    TEST_ASSERT_TRUE(xQueueReceive(events, &received_event, 0));
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_PRESSED, received_event);
+
+    bounce_to(1, false);
+    advance_ticks(pdMS_TO_TICKS(30));
+    TEST_ASSERT_EQUAL(2, edge_wakeups);
+    TEST_ASSERT_TRUE(xQueueReceive(events, &received_event, 0));
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_CLICKED, received_event);
+    TEST_ASSERT_FALSE(xQueueReceive(events, &received_event, 0));
+
+    filtered_button_deinit(&filtered, events);
+}
+
+void test_button_debounce_in_driver(void) {
+    QueueHandle_t events = xQueueCreate(8, sizeof(button_event_t));
+    button_handle_t filtered;
+    filtered_button_init(&filtered, events);
+    TEST_ASSERT_FALSE(gpio_debounce_in_hw(&filtered.gpio));
+
+    // Every bounce wakes the application, and the reads it makes all come
+    // too early for the filter; the settle timeout reads again later
+    bounce_to(1, true);
+    TEST_ASSERT_EQUAL(11, edge_wakeups);
+    TEST_ASSERT_FALSE(xQueueReceive(events, &received_event, 0));
+    TEST_ASSERT_TRUE(timeout_is_armed(&filtered.settle));
+    advance_ticks(pdMS_TO_TICKS(60));
+    TEST_ASSERT_EQUAL(11, edge_wakeups);
+    TEST_ASSERT_TRUE(xQueueReceive(events, &received_event, 0));
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_PRESSED, received_event);
+
+    bounce_to(1, false);
+    advance_ticks(pdMS_TO_TICKS(60));
+    TEST_ASSERT_TRUE(xQueueReceive(events, &received_event, 0));
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_CLICKED, received_event);
+    TEST_ASSERT_FALSE(xQueueReceive(events, &received_event, 0));
+
+    filtered_button_deinit(&filtered, events);
+}
+
 // Unity main
 int main(void) {
     UNITY_BEGIN();
@@ -106,6 +224,8 @@ int main(void) {
     RUN_TEST(test_button_press_release);
     RUN_TEST(test_button_long_press);
     RUN_TEST(test_button_debounce);
+    RUN_TEST(test_button_debounce_in_hw);
+    RUN_TEST(test_button_debounce_in_driver);
     
     return UNITY_END();
 }
@@ -0,0 +1,211 @@
+#include "components/encoder.h"
+#include "hal/gpio_bank.h"
+#include "mocks/gpio_mock.h"
+#include "unity.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+#define PIN_A 10
+#define PIN_B 11
+#define THROUGHPUT_STEPS 200000
+#define VELOCITY_READERS 3
+
+// Test fixtures
+static encoder_handle_t encoder;
+static QueueHandle_t event_queue;
+static encoder_event_t received_event;
+
+// Quadrature sequence for clockwise rotation, AB with A in bit 1
+static const uint8_t gray[4] = {0x0, 0x2, 0x3, 0x1};
+static int phase;
+
+static void rotate(int steps) {
+    int dir = steps > 0 ? 1 : -1;
+    for (int i = 0; i != steps; i += dir) {
+        phase = (phase + dir) & 3;
+        gpio_mock_set_pin_state(PIN_A, gray[phase] & 2);
+        gpio_mock_set_pin_state(PIN_B, gray[phase] & 1);
+    }
+}
+
+static void encoder_setup(bool use_interrupts, QueueHandle_t queue) {
+    TEST_ASSERT_TRUE(encoder_driver.create(&encoder));
+    TEST_ASSERT_TRUE(gpio_mock_driver.create(&encoder.gpio_a));
+    TEST_ASSERT_TRUE(gpio_mock_driver.create(&encoder.gpio_b));
+
+    encoder_config_t config = {
+        .gpio_a = {.pin = PIN_A, .is_output = false, .active_high = true},
+        .gpio_b = {.pin = PIN_B, .is_output = false, .active_high = true},
+        .steps_per_detent = 4,
+        .velocity_window_ms = 50,
+        .use_interrupts = use_interrupts,
+        .event_queue = queue,
+    };
+    TEST_ASSERT_TRUE(encoder.init(&encoder, &config));
+}
+
+void setUp(void) {
+    gpio_mock_reset();
+    phase = 0;
+
+    event_queue = xQueueCreate(10, sizeof(encoder_event_t));
+    TEST_ASSERT_NOT_NULL(event_queue);
+}
+
+void tearDown(void) {
+    encoder_driver.destroy(&encoder);
+    gpio_mock_driver.destroy(&encoder.gpio_a);
+    gpio_mock_driver.destroy(&encoder.gpio_b);
+    vQueueDelete(event_queue);
+}
+
+// Test cases
+void test_encoder_counts_detents(void) {
+    encoder_setup(true, event_queue);
+
+    rotate(8);
+    TEST_ASSERT_EQUAL(8, encoder.get_position(&encoder));
+    for (int i = 0; i < 2; i++) {
+        TEST_ASSERT_TRUE(xQueueReceive(event_queue, &received_event, 0));
+        TEST_ASSERT_EQUAL(ENCODER_EVENT_CW, received_event);
+    }
+
+    rotate(-6);
+    TEST_ASSERT_EQUAL(2, encoder.get_position(&encoder));
+    TEST_ASSERT_TRUE(xQueueReceive(event_queue, &received_event, 0));
+    TEST_ASSERT_EQUAL(ENCODER_EVENT_CCW, received_event);
+
+    // Half a detent is not reported yet
+    TEST_ASSERT_FALSE(xQueueReceive(event_queue, &received_event, 0));
+}
+
+void test_encoder_decodes_bank_samples(void) {
+    encoder_setup(false, NULL);
+
+    gpio_handle_t *pins[] = {&encoder.gpio_a, &encoder.gpio_b};
+    gpio_bank_t bank;
+    TEST_ASSERT_TRUE(gpio_bank_init(&bank, pins, 2));
+
+    for (int i = 0; i < 12; i++) {
+        rotate(-1);
+        uint32_t bits;
+        TEST_ASSERT_TRUE(gpio_bank_read(&bank, &bits));
+        encoder.update(&encoder, bits & 1, bits & 2);
+    }
+
+    TEST_ASSERT_EQUAL(-12, encoder.get_position(&encoder));
+    TEST_ASSERT_EQUAL(0, atomic_load(&encoder.errors));
+}
+
+void test_encoder_counts_skipped_states(void) {
+    encoder_setup(false, NULL);
+
+    // Both inputs changed between samples: direction is unknown
+    encoder.update(&encoder, true, true);
+    TEST_ASSERT_EQUAL(0, encoder.get_position(&encoder));
+    TEST_ASSERT_EQUAL(1, atomic_load(&encoder.errors));
+}
+
+void test_encoder_throughput(void) {
+    encoder_setup(true, NULL);
+
+    TickType_t start = xTaskGetTickCount();
+    rotate(THROUGHPUT_STEPS);
+    TickType_t elapsed = xTaskGetTickCount() - start;
+
+    // No lost steps, at no less than 50k transitions per second
+    TEST_ASSERT_EQUAL(THROUGHPUT_STEPS, encoder.get_position(&encoder));
+    TEST_ASSERT_EQUAL(0, atomic_load(&encoder.errors));
+    TEST_ASSERT_LESS_OR_EQUAL(pdMS_TO_TICKS(THROUGHPUT_STEPS / 50), elapsed);
+}
+
+void test_encoder_velocity(void) {
+    encoder_setup(true, NULL);
+
+    encoder.get_velocity(&encoder);
+    for (int i = 0; i < 10; i++) {
+        rotate(10);
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    // 100 steps in ~100 ms
+    int32_t velocity = encoder.get_velocity(&encoder);
+    TEST_ASSERT_GREATER_THAN(500, velocity);
+    TEST_ASSERT_LESS_THAN(2000, velocity);
+}
+
+static atomic_bool reading;
+static atomic_int readers_left;
+static atomic_int_fast32_t velocity_min, velocity_max;
+
+// Reads as fast as it can while the runner turns the shaft
+static void velocity_reader(void *pvParameters) {
+    (void)pvParameters;
+    while (atomic_load(&reading)) {
+        int32_t velocity = encoder.get_velocity(&encoder);
+        int_fast32_t seen = atomic_load(&velocity_min);
+        while (velocity < seen && !atomic_compare_exchange_weak(&velocity_min, &seen, velocity)) {
+        }
+        seen = atomic_load(&velocity_max);
+        while (velocity > seen && !atomic_compare_exchange_weak(&velocity_max, &seen, velocity)) {
+        }
+        taskYIELD();
+    }
+    atomic_fetch_sub(&readers_left, 1);
+    vTaskDelete(NULL);
+}
+
+void test_encoder_velocity_shared_readers(void) {
+    encoder_setup(true, NULL);
+
+    // A steady 1000 steps per second, one full window before reading
+    for (int i = 0; i < 60; i++) {
+        rotate(10);
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    atomic_store(&velocity_min, INT32_MAX);
+    atomic_store(&velocity_max, INT32_MIN);
+    atomic_store(&reading, true);
+    atomic_store(&readers_left, VELOCITY_READERS);
+    for (int i = 0; i < VELOCITY_READERS; i++) {
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(velocity_reader, "velocity", configMINIMAL_STACK_SIZE,
+                                              NULL, tskIDLE_PRIORITY + 1, NULL));
+    }
+    for (int i = 0; i < 30; i++) {
+        rotate(10);
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    atomic_store(&reading, false);
+    while (atomic_load(&readers_left)) {
+        vTaskDelay(1);
+    }
+
+    // Every window closed once, from consistent fields
+    TEST_ASSERT_GREATER_THAN(500, atomic_load(&velocity_min));
+    TEST_ASSERT_LESS_THAN(2000, atomic_load(&velocity_max));
+}
+
+static void test_runner(void *pvParameters) {
+    (void)pvParameters;
+    UNITY_BEGIN();
+
+    RUN_TEST(test_encoder_counts_detents);
+    RUN_TEST(test_encoder_decodes_bank_samples);
+    RUN_TEST(test_encoder_counts_skipped_states);
+    RUN_TEST(test_encoder_throughput);
+    RUN_TEST(test_encoder_velocity);
+    RUN_TEST(test_encoder_velocity_shared_readers);
+
+    exit(UNITY_END());
+}
+
+// Unity main
+int main(void) {
+    xTaskCreate(test_runner, "runner", configMINIMAL_STACK_SIZE, NULL,
+                tskIDLE_PRIORITY + 1, NULL);
+    vTaskStartScheduler();
+    return 1;
+}
@@ -0,0 +1,143 @@
+#include "core/event_ring.h"
+#include "unity.h"
+#include <stdio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define CAPACITY 16
+#define FORK_RECORDS 10000
+
+// Test fixtures
+static char name[64];
+static event_ring_writer_t writer;
+static event_ring_reader_t reader;
+
+void setUp(void) {
+    snprintf(name, sizeof(name), "/uni-lib-test-%d", (int)getpid());
+    TEST_ASSERT_TRUE(event_ring_writer_create(&writer, name, CAPACITY));
+    TEST_ASSERT_TRUE(event_ring_reader_open(&reader, name, false));
+}
+
+void tearDown(void) {
+    event_ring_reader_close(&reader);
+    event_ring_writer_destroy(&writer);
+}
+
+// Test cases
+void test_event_ring_rejects_bad_capacity(void) {
+    event_ring_writer_t other;
+    TEST_ASSERT_FALSE(event_ring_writer_create(&other, "/uni-lib-test-bad", 12));
+    TEST_ASSERT_FALSE(event_ring_writer_create(&other, "/uni-lib-test-bad", 0));
+}
+
+void test_event_ring_reads_in_order(void) {
+    event_record_t record;
+    TEST_ASSERT_FALSE(event_ring_read(&reader, &record));
+
+    for (uint32_t i = 0; i < 5; i++) {
+        event_ring_publish(&writer, EVENT_KIND_BUTTON, 7, i);
+    }
+
+    uint64_t last_time = 0;
+    for (uint32_t i = 0; i < 5; i++) {
+        TEST_ASSERT_TRUE(event_ring_read(&reader, &record));
+        TEST_ASSERT_EQUAL(i, record.seq);
+        TEST_ASSERT_EQUAL(EVENT_KIND_BUTTON, record.kind);
+        TEST_ASSERT_EQUAL(7, record.source);
+        TEST_ASSERT_EQUAL(i, record.code);
+        TEST_ASSERT_TRUE(record.time_ns >= last_time);
+        last_time = record.time_ns;
+    }
+    TEST_ASSERT_FALSE(event_ring_read(&reader, &record));
+    TEST_ASSERT_EQUAL(0, reader.lost);
+}
+
+void test_event_ring_counts_overrun(void) {
+    for (uint32_t i = 0; i < 3 * CAPACITY; i++) {
+        event_ring_publish(&writer, EVENT_KIND_GPIO_EDGE, 1, i);
+    }
+
+    // The reader resumes at the oldest record still in the ring
+    event_record_t record;
+    TEST_ASSERT_TRUE(event_ring_read(&reader, &record));
+    TEST_ASSERT_EQUAL(2 * CAPACITY, record.seq);
+    TEST_ASSERT_EQUAL(2 * CAPACITY, record.code);
+    TEST_ASSERT_EQUAL(2 * CAPACITY, reader.lost);
+}
+
+void test_event_ring_independent_readers(void) {
+    event_ring_publish(&writer, EVENT_KIND_ENCODER, 3, 1);
+
+    event_ring_reader_t late;
+    TEST_ASSERT_TRUE(event_ring_reader_open(&late, name, true));
+    event_ring_publish(&writer, EVENT_KIND_ENCODER, 3, 2);
+
+    event_record_t record;
+    TEST_ASSERT_TRUE(event_ring_read(&reader, &record));
+    TEST_ASSERT_EQUAL(1, record.code);
+    TEST_ASSERT_TRUE(event_ring_read(&late, &record));
+    TEST_ASSERT_EQUAL(2, record.code);
+    TEST_ASSERT_TRUE(event_ring_read(&reader, &record));
+    TEST_ASSERT_EQUAL(2, record.code);
+
+    event_ring_reader_close(&late);
+}
+
+void test_event_ring_wait_times_out(void) {
+    TEST_ASSERT_FALSE(event_ring_wait(&reader, 10));
+
+    event_ring_publish(&writer, EVENT_KIND_BUTTON, 0, 0);
+    TEST_ASSERT_TRUE(event_ring_wait(&reader, 10));
+}
+
+void test_event_ring_cross_process(void) {
+    pid_t child = fork();
+    TEST_ASSERT_TRUE(child >= 0);
+
+    if (child == 0) {
+        // Consumer process: follow every record, sleeping when idle
+        event_ring_reader_t consumer;
+        if (!event_ring_reader_open(&consumer, name, false)) _exit(2);
+
+        uint64_t received = 0;
+        event_record_t record;
+        while (consumer.next < FORK_RECORDS) {
+            if (!event_ring_read(&consumer, &record)) {
+                if (!event_ring_wait(&consumer, 5000)) _exit(3);
+                continue;
+            }
+            if (record.code != record.seq) _exit(4);
+            received++;
+        }
+
+        // Every record was either received or counted as lost
+        _exit(received + consumer.lost == FORK_RECORDS ? 0 : 5);
+    }
+
+    // Bursts with pauses, so the consumer both keeps up and goes idle
+    for (uint32_t i = 0; i < FORK_RECORDS; i++) {
+        event_ring_publish(&writer, EVENT_KIND_GPIO_EDGE, 0, i);
+        if (i % CAPACITY == 0) {
+            usleep(200);
+        }
+    }
+
+    int status;
+    TEST_ASSERT_EQUAL(child, waitpid(child, &status, 0));
+    TEST_ASSERT_TRUE(WIFEXITED(status));
+    TEST_ASSERT_EQUAL(0, WEXITSTATUS(status));
+}
+
+// Unity main
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_event_ring_rejects_bad_capacity);
+    RUN_TEST(test_event_ring_reads_in_order);
+    RUN_TEST(test_event_ring_counts_overrun);
+    RUN_TEST(test_event_ring_independent_readers);
+    RUN_TEST(test_event_ring_wait_times_out);
+    RUN_TEST(test_event_ring_cross_process);
+
+    return UNITY_END();
+}
@@ -0,0 +1,436 @@
+#include "components/button.h"
+#include "components/event_export.h"
+#include "components/event_sink.h"
+#include "hal/hal_worker.h"
+#include "mocks/gpio_mock.h"
+#include "unity.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define QUEUE_LENGTH 4
+#define STRESS_BUTTONS 256
+#define STRESS_QUEUE_LENGTH 16
+#define EXPORT_THREADS 3
+#define EXPORT_TASKS 2
+#define EXPORT_RECORDS 5000
+
+// Test fixtures
+static QueueHandle_t queue;
+static event_sink_t sink;
+static button_handle_t buttons[STRESS_BUTTONS];
+static volatile uint32_t consumed;
+static volatile uint32_t clicks;
+
+static void post_all(const int *events, int count, bool guaranteed) {
+    for (int i = 0; i < count; i++) {
+        event_sink_post(&sink, &events[i], (uint32_t)events[i], guaranteed);
+    }
+}
+
+static void assert_queue(const int *expected, int count) {
+    int event;
+    for (int i = 0; i < count; i++) {
+        TEST_ASSERT_TRUE(xQueueReceive(queue, &event, 0));
+        TEST_ASSERT_EQUAL(expected[i], event);
+    }
+    TEST_ASSERT_FALSE(xQueueReceive(queue, &event, 0));
+}
+
+static void assert_stats(uint32_t sent, uint32_t dropped, uint32_t overwritten,
+                         uint32_t coalesced) {
+    event_sink_stats_t stats;
+    event_sink_get_stats(&sink, &stats);
+    TEST_ASSERT_EQUAL(sent, stats.sent);
+    TEST_ASSERT_EQUAL(dropped, stats.dropped);
+    TEST_ASSERT_EQUAL(overwritten, stats.overwritten);
+    TEST_ASSERT_EQUAL(coalesced, stats.coalesced);
+}
+
+// Drains the button queue slowly enough to fall behind
+static void consumer_task(void *pvParameters) {
+    QueueHandle_t events = pvParameters;
+    button_event_t event;
+    for (;;) {
+        if (xQueueReceive(events, &event, portMAX_DELAY)) {
+            consumed++;
+            if (event == BUTTON_EVENT_CLICKED) {
+                clicks++;
+            }
+            if (consumed % 4 == 0) {
+                vTaskDelay(1);
+            }
+        }
+    }
+}
+
+static void stress_setup(QueueHandle_t events, event_policy_t policy) {
+    for (uint32_t i = 0; i < STRESS_BUTTONS; i++) {
+        TEST_ASSERT_TRUE(button_driver.create(&buttons[i]));
+        TEST_ASSERT_TRUE(gpio_mock_driver.create(&buttons[i].gpio));
+        button_config_t config = {
+            .gpio_config = {.pin = i, .is_output = false, .active_high = true},
+            .debounce_ms = 20,
+            .long_press_ms = 1000,
+            .event_queue = events,
+            .overflow_policy = policy,
+        };
+        TEST_ASSERT_TRUE(buttons[i].init(&buttons[i], &config));
+    }
+}
+
+static void stress_teardown(void) {
+    for (int i = 0; i < STRESS_BUTTONS; i++) {
+        button_driver.destroy(&buttons[i]);
+        gpio_mock_driver.destroy(&buttons[i].gpio);
+    }
+}
+
+static bool stress_settled(bool level) {
+    for (int i = 0; i < STRESS_BUTTONS; i++) {
+        if (buttons[i].is_pressed != level) return false;
+    }
+    return true;
+}
+
+// Drive every pin to level and poll all buttons until they settle; releases
+// that wait for the consumer can take longer than the debounce
+static void stress_flip_all(bool level) {
+    button_event_t ignored;
+    for (uint32_t i = 0; i < STRESS_BUTTONS; i++) {
+        gpio_mock_set_pin_state(i, level);
+    }
+    for (int tick = 0; tick < 1000 && !stress_settled(level); tick++) {
+        for (int i = 0; i < STRESS_BUTTONS; i++) {
+            buttons[i].process(&buttons[i], &ignored);
+        }
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+    TEST_ASSERT_TRUE(stress_settled(level));
+}
+
+static void stress_totals(event_sink_stats_t *total) {
+    *total = (event_sink_stats_t){0};
+    for (int i = 0; i < STRESS_BUTTONS; i++) {
+        event_sink_stats_t stats;
+        event_sink_get_stats(&buttons[i].events, &stats);
+        total->sent += stats.sent;
+        total->dropped += stats.dropped;
+        total->overwritten += stats.overwritten;
+        total->coalesced += stats.coalesced;
+        total->lost += stats.lost;
+    }
+}
+
+void setUp(void) {
+    gpio_mock_reset();
+    queue = xQueueCreate(QUEUE_LENGTH, sizeof(int));
+    TEST_ASSERT_NOT_NULL(queue);
+}
+
+void tearDown(void) {
+    vQueueDelete(queue);
+}
+
+// Test cases
+void test_event_sink_drop_newest(void) {
+    static const int events[] = {0, 1, 2, 3, 4, 5};
+    TEST_ASSERT_TRUE(event_sink_init(&sink, queue, sizeof(int), EVENT_POLICY_DROP_NEWEST));
+
+    post_all(events, 6, false);
+
+    assert_stats(4, 2, 0, 0);
+    assert_queue((const int[]){0, 1, 2, 3}, 4);
+}
+
+void test_event_sink_overwrite_oldest(void) {
+    static const int events[] = {0, 1, 2, 3, 4, 5};
+    TEST_ASSERT_TRUE(event_sink_init(&sink, queue, sizeof(int), EVENT_POLICY_OVERWRITE_OLDEST));
+
+    post_all(events, 6, false);
+
+    assert_stats(6, 0, 2, 0);
+    assert_queue((const int[]){2, 3, 4, 5}, 4);
+}
+
+void test_event_sink_coalesce(void) {
+    static const int repeats[] = {7, 7, 7, 7, 7, 7};
+    TEST_ASSERT_TRUE(event_sink_init(&sink, queue, sizeof(int), EVENT_POLICY_COALESCE));
+
+    post_all(repeats, 6, false);
+    assert_stats(4, 0, 0, 2);
+
+    // A change of event type still gets through
+    post_all((const int[]){8}, 1, false);
+    assert_stats(5, 0, 1, 2);
+    assert_queue((const int[]){7, 7, 7, 8}, 4);
+}
+
+// Frees one queue slot while the runner waits to post
+static void take_one_task(void *pvParameters) {
+    (void)pvParameters;
+    int event;
+    vTaskDelay(pdMS_TO_TICKS(2));
+    xQueueReceive(queue, &event, 0);
+    vTaskDelete(NULL);
+}
+
+void test_event_sink_guaranteed(void) {
+    static const int presses[] = {0, 0, 0, 0, 0};
+    TEST_ASSERT_TRUE(event_sink_init(&sink, queue, sizeof(int), EVENT_POLICY_DROP_NEWEST));
+
+    post_all(presses, 5, false);
+
+    // Nobody drains the queue: the release waits, then is lost rather than
+    // pushing out a queued event
+    TEST_ASSERT_FALSE(event_sink_post(&sink, &(int){1}, 1, true));
+    assert_stats(4, 1, 0, 0);
+    event_sink_stats_t stats;
+    event_sink_get_stats(&sink, &stats);
+    TEST_ASSERT_EQUAL(1, stats.lost);
+
+    // The consumer makes room while the release waits
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(take_one_task, "take", configMINIMAL_STACK_SIZE,
+                                          NULL, tskIDLE_PRIORITY + 1, NULL));
+    TEST_ASSERT_TRUE(event_sink_post(&sink, &(int){1}, 1, true));
+    assert_stats(5, 1, 0, 0);
+    event_sink_get_stats(&sink, &stats);
+    TEST_ASSERT_EQUAL(1, stats.lost);
+    assert_queue((const int[]){0, 0, 0, 1}, 4);
+}
+
+void test_event_sink_rejects_large_items(void) {
+    TEST_ASSERT_FALSE(event_sink_init(&sink, queue, EVENT_SINK_MAX_ITEM_SIZE + 1,
+                                      EVENT_POLICY_DROP_NEWEST));
+}
+
+void test_event_sink_exports_every_post(void) {
+    static const int events[] = {0, 1, 2, 3, 4, 5};
+    char name[64];
+    snprintf(name, sizeof(name), "/uni-lib-test-sink-%d", (int)getpid());
+    TEST_ASSERT_TRUE(event_export_start(name, 64));
+    event_ring_reader_t reader;
+    TEST_ASSERT_TRUE(event_ring_reader_open(&reader, name, false));
+
+    TEST_ASSERT_TRUE(event_sink_init(&sink, queue, sizeof(int), EVENT_POLICY_DROP_NEWEST));
+    event_sink_set_export(&sink, EVENT_KIND_BUTTON, 9);
+    post_all(events, 6, false);
+
+    // Dropped from the queue, but not from the export
+    assert_stats(4, 2, 0, 0);
+    event_record_t record;
+    for (uint32_t i = 0; i < 6; i++) {
+        TEST_ASSERT_TRUE(event_ring_read(&reader, &record));
+        TEST_ASSERT_EQUAL(EVENT_KIND_BUTTON, record.kind);
+        TEST_ASSERT_EQUAL(9, record.source);
+        TEST_ASSERT_EQUAL(i, record.code);
+    }
+    TEST_ASSERT_FALSE(event_ring_read(&reader, &record));
+
+    event_ring_reader_close(&reader);
+    event_export_stop();
+}
+
+static uint32_t edge_callbacks;
+
+static void count_edge(void *arg) {
+    (void)arg;
+    edge_callbacks++;
+}
+
+void test_event_export_gpio_edges(void) {
+    char name[64];
+    snprintf(name, sizeof(name), "/uni-lib-test-edges-%d", (int)getpid());
+    TEST_ASSERT_TRUE(event_export_start(name, 64));
+    event_ring_reader_t reader;
+    TEST_ASSERT_TRUE(event_ring_reader_open(&reader, name, false));
+
+    gpio_handle_t pin;
+    gpio_config_t config = {.pin = 5, .is_output = false, .active_high = true};
+    TEST_ASSERT_TRUE(gpio_mock_driver.create(&pin));
+    TEST_ASSERT_TRUE(gpio_init(&pin, &config));
+    event_export_edge_t tap;
+    edge_callbacks = 0;
+    TEST_ASSERT_TRUE(event_export_edges(&tap, &pin, 5, count_edge, NULL));
+
+    // Every edge is published with its level, and still reaches the callback
+    gpio_mock_set_pin_state(5, true);
+    gpio_mock_set_pin_state(5, false);
+    gpio_mock_set_pin_state(5, true);
+    TEST_ASSERT_EQUAL(3, edge_callbacks);
+    event_record_t record;
+    for (uint32_t i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(event_ring_read(&reader, &record));
+        TEST_ASSERT_EQUAL(EVENT_KIND_GPIO_EDGE, record.kind);
+        TEST_ASSERT_EQUAL(5, record.source);
+        TEST_ASSERT_EQUAL(i % 2 == 0, record.code);
+    }
+    TEST_ASSERT_FALSE(event_ring_read(&reader, &record));
+
+    gpio_deinit(&pin);
+    gpio_mock_driver.destroy(&pin);
+    event_ring_reader_close(&reader);
+    event_export_stop();
+}
+
+static atomic_uint export_producers_done;
+
+// Source: the producer, code: its record count so far
+static void publish_records(uint16_t source) {
+    for (uint32_t i = 0; i < EXPORT_RECORDS; i++) {
+        event_export_publish(EVENT_KIND_KEYPAD, source, i);
+    }
+    atomic_fetch_add(&export_producers_done, 1);
+}
+
+static void *export_thread(void *arg) {
+    // Native threads must not take the scheduler's signals
+    sigset_t all;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, NULL);
+    hal_worker_register_native_thread();
+
+    publish_records((uint16_t)(uintptr_t)arg);
+    return NULL;
+}
+
+static void export_task(void *arg) {
+    publish_records((uint16_t)(uintptr_t)arg);
+    vTaskDelete(NULL);
+}
+
+void test_event_export_tasks_and_threads(void) {
+    enum { PRODUCERS = EXPORT_THREADS + EXPORT_TASKS };
+    char name[64];
+    snprintf(name, sizeof(name), "/uni-lib-test-producers-%d", (int)getpid());
+    TEST_ASSERT_TRUE(event_export_start(name, 32768));
+    event_ring_reader_t reader;
+    TEST_ASSERT_TRUE(event_ring_reader_open(&reader, name, false));
+
+    atomic_store(&export_producers_done, 0);
+    pthread_t threads[EXPORT_THREADS];
+    for (uintptr_t i = 0; i < EXPORT_THREADS; i++) {
+        TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL, export_thread, (void *)i));
+    }
+    for (uintptr_t i = EXPORT_THREADS; i < PRODUCERS; i++) {
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(export_task, "exporter", configMINIMAL_STACK_SIZE,
+                                              (void *)i, tskIDLE_PRIORITY + 1, NULL));
+    }
+    while (atomic_load(&export_producers_done) < PRODUCERS) {
+        vTaskDelay(1);
+    }
+    for (int i = 0; i < EXPORT_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // Every record lands whole, each producer's in its own order
+    uint32_t next[PRODUCERS] = {0};
+    event_record_t record;
+    for (uint32_t i = 0; i < PRODUCERS * EXPORT_RECORDS; i++) {
+        TEST_ASSERT_TRUE(event_ring_read(&reader, &record));
+        TEST_ASSERT_EQUAL(i, record.seq);
+        TEST_ASSERT_EQUAL(EVENT_KIND_KEYPAD, record.kind);
+        TEST_ASSERT_TRUE(record.source < PRODUCERS);
+        TEST_ASSERT_EQUAL(next[record.source]++, record.code);
+    }
+    TEST_ASSERT_FALSE(event_ring_read(&reader, &record));
+    TEST_ASSERT_EQUAL(0, reader.lost);
+
+    event_ring_reader_close(&reader);
+    event_export_stop();
+}
+
+void test_button_stress_stalled_consumer(void) {
+    QueueHandle_t events = xQueueCreate(STRESS_QUEUE_LENGTH, sizeof(button_event_t));
+    stress_setup(events, EVENT_POLICY_DROP_NEWEST);
+
+    // The consumer stalls while every button is pressed: presses beyond
+    // the queue are dropped
+    stress_flip_all(true);
+
+    // It resumes while they are released: every release waits for a slot
+    // instead of pushing out an earlier one, so none is lost
+    consumed = 0;
+    clicks = 0;
+    TaskHandle_t consumer;
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(consumer_task, "consumer", configMINIMAL_STACK_SIZE,
+                                          events, tskIDLE_PRIORITY + 2, &consumer));
+    stress_flip_all(false);
+    vTaskDelay(pdMS_TO_TICKS(50)); // Let the consumer catch up
+    vTaskDelete(consumer);
+
+    event_sink_stats_t total;
+    stress_totals(&total);
+    TEST_ASSERT_EQUAL(STRESS_QUEUE_LENGTH + STRESS_BUTTONS, total.sent);
+    TEST_ASSERT_EQUAL(STRESS_BUTTONS - STRESS_QUEUE_LENGTH, total.dropped);
+    TEST_ASSERT_EQUAL(0, total.overwritten);
+    TEST_ASSERT_EQUAL(0, total.coalesced);
+    TEST_ASSERT_EQUAL(0, total.lost);
+    TEST_ASSERT_EQUAL(STRESS_QUEUE_LENGTH + STRESS_BUTTONS, consumed);
+    TEST_ASSERT_EQUAL(STRESS_BUTTONS, clicks);
+
+    stress_teardown();
+    vQueueDelete(events);
+}
+
+void test_button_stress_slow_consumer(void) {
+    QueueHandle_t events = xQueueCreate(STRESS_QUEUE_LENGTH, sizeof(button_event_t));
+    stress_setup(events, EVENT_POLICY_OVERWRITE_OLDEST);
+
+    consumed = 0;
+    TaskHandle_t consumer;
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(consumer_task, "consumer", configMINIMAL_STACK_SIZE,
+                                          events, tskIDLE_PRIORITY + 2, &consumer));
+
+    for (int round = 0; round < 3; round++) {
+        stress_flip_all(true);
+        stress_flip_all(false);
+    }
+    vTaskDelay(pdMS_TO_TICKS(50)); // Let the consumer catch up
+    vTaskDelete(consumer);
+
+    // Every event produced is accounted for, and everything sent and not
+    // overwritten was consumed
+    event_sink_stats_t total;
+    stress_totals(&total);
+    TEST_ASSERT_EQUAL(3 * 2 * STRESS_BUTTONS,
+                      total.sent + total.dropped + total.coalesced + total.lost);
+    TEST_ASSERT_EQUAL(total.sent - total.overwritten, consumed);
+    TEST_ASSERT_EQUAL(0, total.dropped);
+    TEST_ASSERT_EQUAL(0, total.lost);
+    TEST_ASSERT_TRUE(total.overwritten > 0);
+
+    stress_teardown();
+    vQueueDelete(events);
+}
+
+static void test_runner(void *pvParameters) {
+    (void)pvParameters;
+    UNITY_BEGIN();
+
+    RUN_TEST(test_event_sink_drop_newest);
+    RUN_TEST(test_event_sink_overwrite_oldest);
+    RUN_TEST(test_event_sink_coalesce);
+    RUN_TEST(test_event_sink_guaranteed);
+    RUN_TEST(test_event_sink_rejects_large_items);
+    RUN_TEST(test_event_sink_exports_every_post);
+    RUN_TEST(test_event_export_gpio_edges);
+    RUN_TEST(test_event_export_tasks_and_threads);
+    RUN_TEST(test_button_stress_stalled_consumer);
+    RUN_TEST(test_button_stress_slow_consumer);
+
+    exit(UNITY_END());
+}
+
+// Unity main
+int main(void) {
+    xTaskCreate(test_runner, "runner", configMINIMAL_STACK_SIZE, NULL,
+                tskIDLE_PRIORITY + 1, NULL);
+    vTaskStartScheduler();
+    return 1;
+}
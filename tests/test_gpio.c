@@ -1,20 +1,45 @@
 #include "hal/gpio.h"
+#include "hal/gpio_linux.h"
+#include "hal/gpio_provision.h"
 #include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
 
 void test_gpio_create() {
   gpio_handle_t gpio;
   assert(linux_gpio_driver.create(&gpio) == true);
   assert(gpio.hw_handle != NULL);
-  assert(gpio.init != NULL);
-  assert(gpio.write != NULL);
-  assert(gpio.read != NULL);
+  assert(gpio.ops != NULL);
+  assert(gpio.ops->init != NULL);
+  assert(gpio.ops->write != NULL);
+  assert(gpio.ops->read != NULL);
+#ifndef UNI_LIB_STATIC_DISPATCH
+  // Handle method calls keep working next to the gpio_*() calls
+  assert(gpio.write == gpio.ops->write);
+  assert(gpio.toggle == gpio.ops->toggle);
+#endif
 
+  // Edges are delivered through linux_gpio_edge_fd() only
+  errno = 0;
+  assert(gpio_set_interrupt(&gpio, NULL, NULL) == false);
+  assert(errno == ENOTSUP);
+
+  // Destroying a handle that was never initialized leaves stdin alone
   linux_gpio_driver.destroy(&gpio);
+  assert(fcntl(STDIN_FILENO, F_GETFD) != -1);
   printf("GPIO creation test passed\n");
 }
 
 void test_gpio_init() {
+  // Init now reports export failures, which needs sysfs GPIO to pass
+  if (access("/sys/class/gpio/export", W_OK) != 0) {
+    printf("GPIO initialization test skipped, no sysfs GPIO\n");
+    return;
+  }
+
   gpio_handle_t gpio;
   linux_gpio_driver.create(&gpio);
 
@@ -24,16 +49,117 @@ void test_gpio_init() {
                           .pull_down = false,
                           .platform_specific = NULL};
 
-  assert(gpio.init(&gpio, &config) == true);
+  assert(gpio_init(&gpio, &config) == true);
   linux_gpio_driver.destroy(&gpio);
   printf("GPIO initialization test passed\n");
 }
 
+void test_gpio_provision_errors() {
+  static const linux_gpio_line_t missing_chip = {.chip = "/dev/gpiochip-none",
+                                                 .offset = 3};
+  static const linux_gpio_line_t no_chip = {.chip = NULL, .offset = 4};
+  const gpio_config_t configs[] = {
+      {.is_output = true, .platform_specific = (void *)&missing_chip},
+      {.is_output = false, .platform_specific = (void *)&no_chip},
+      {.is_output = false, .pull_up = true,
+       .platform_specific = (void *)&missing_chip},
+  };
+  gpio_handle_t gpios[3];
+  int errors[3];
+
+  assert(gpio_provision(&linux_gpio_driver, gpios, configs, 3, errors) ==
+         false);
+  assert(errors[0] == ENOENT);
+  assert(errors[1] == EINVAL);
+  assert(errors[2] == ENOENT);
+  for (int i = 0; i < 3; i++)
+    assert(gpios[i].hw_handle == NULL);
+
+  gpio_unprovision(&linux_gpio_driver, gpios, 3);
+  printf("GPIO provisioning error test passed\n");
+}
+
+void test_gpio_debounce() {
+  // Sysfs has no debounce, so the driver filters reads
+  if (access("/sys/class/gpio/export", W_OK) == 0) {
+    gpio_handle_t gpio;
+    linux_gpio_driver.create(&gpio);
+    gpio_config_t config = {.pin = 18, .is_output = false, .debounce_us = 5000};
+    assert(gpio_init(&gpio, &config) == true);
+    assert(gpio_debounce_us(&gpio) == 5000);
+    assert(gpio_debounce_in_hw(&gpio) == false);
+    linux_gpio_driver.destroy(&gpio);
+  }
+
+  // A character device line the kernel debounces, e.g. on gpio-sim
+  const char *chip = getenv("UNI_LIB_TEST_GPIOCHIP");
+  if (!chip) {
+    printf("GPIO debounce test skipped for lines, UNI_LIB_TEST_GPIOCHIP unset\n");
+    return;
+  }
+  linux_gpio_line_t line = {.chip = chip, .offset = 0};
+  gpio_config_t config = {
+      .is_output = false, .debounce_us = 5000, .platform_specific = &line};
+  gpio_handle_t gpio;
+  linux_gpio_driver.create(&gpio);
+  assert(gpio_init(&gpio, &config) == true);
+  assert(gpio_debounce_us(&gpio) == 5000);
+  assert(gpio_debounce_in_hw(&gpio) == true);
+  linux_gpio_driver.destroy(&gpio);
+  printf("GPIO debounce test passed\n");
+}
+
+void test_gpio_edge_attrs() {
+  const char *chip = getenv("UNI_LIB_TEST_GPIOCHIP");
+  if (!chip) {
+    printf("GPIO edge attribute test skipped, UNI_LIB_TEST_GPIOCHIP unset\n");
+    return;
+  }
+
+  // One request with 8 of its 10 attributes taken: the first line sets the
+  // default flags, the others need pulls, output modes or debounce periods.
+  // Each input that enables edges moves to flags of its own, which only
+  // fits if the slots the inputs leave are reused.
+  enum { LINES = 9 };
+  gpio_config_t configs[LINES] = {
+      {.is_output = false},
+      {.is_output = false, .pull_up = true},
+      {.is_output = false, .pull_down = true},
+      {.is_output = true},
+      {.is_output = true, .open_drain = true},
+      {.is_output = true, .pull_up = true},
+      {.is_output = false, .debounce_us = 1000},
+      {.is_output = false, .debounce_us = 2000},
+      {.is_output = false, .debounce_us = 3000},
+  };
+  linux_gpio_line_t lines[LINES];
+  for (int i = 0; i < LINES; i++) {
+    lines[i] = (linux_gpio_line_t){.chip = chip, .offset = i};
+    configs[i].platform_specific = &lines[i];
+  }
+  gpio_handle_t gpios[LINES];
+  int errors[LINES];
+  assert(gpio_provision(&linux_gpio_driver, gpios, configs, LINES, errors));
+
+  short events;
+  for (int round = 0; round < 2; round++) {
+    assert(linux_gpio_edge_fd(&gpios[1], &events) >= 0);
+    assert(linux_gpio_edge_fd(&gpios[2], &events) >= 0);
+    assert(linux_gpio_edge_fd(&gpios[0], &events) >= 0);
+  }
+
+  gpio_unprovision(&linux_gpio_driver, gpios, LINES);
+  printf("GPIO edge attribute test passed\n");
+}
+
 int main() {
   printf("Running GPIO tests...\n");
 
   test_gpio_create();
   test_gpio_init();
+  test_gpio_provision_errors();
+  test_gpio_debounce();
+  test_gpio_edge_attrs();
 
   printf("All GPIO tests passed!\n");
   return 0;
@@ -0,0 +1,117 @@
+#include "hal/gpio_bank.h"
+#include "mocks/gpio_mock.h"
+#include "unity.h"
+
+#define NUM_PINS 4
+
+// Test fixtures
+static gpio_handle_t pins[NUM_PINS];
+static gpio_handle_t *pin_ptrs[NUM_PINS];
+static gpio_bank_t bank;
+
+void setUp(void) {
+    gpio_mock_reset();
+
+    for (uint32_t i = 0; i < NUM_PINS; i++) {
+        gpio_config_t config = {
+            .pin = i,
+            .is_output = true,
+            .active_high = true,
+        };
+        TEST_ASSERT_TRUE(gpio_mock_driver.create(&pins[i]));
+        TEST_ASSERT_TRUE(gpio_init(&pins[i], &config));
+        pin_ptrs[i] = &pins[i];
+    }
+
+    TEST_ASSERT_TRUE(gpio_bank_init(&bank, pin_ptrs, NUM_PINS));
+}
+
+void tearDown(void) {
+    for (uint32_t i = 0; i < NUM_PINS; i++) {
+        gpio_deinit(&pins[i]);
+        gpio_mock_driver.destroy(&pins[i]);
+    }
+}
+
+// Test cases
+void test_gpio_bank_elides_redundant_writes(void) {
+    TEST_ASSERT_TRUE(gpio_bank_write(&bank, 0xF, 0x5));
+    TEST_ASSERT_TRUE(gpio_bank_write(&bank, 0xF, 0x5));
+    TEST_ASSERT_TRUE(gpio_bank_set(&bank, 0x1));
+
+    for (uint32_t i = 0; i < NUM_PINS; i++) {
+        TEST_ASSERT_EQUAL(1, gpio_mock_get_write_count(i));
+    }
+    TEST_ASSERT_TRUE(gpio_mock_get_pin_state(0));
+    TEST_ASSERT_FALSE(gpio_mock_get_pin_state(1));
+    TEST_ASSERT_TRUE(gpio_mock_get_pin_state(2));
+
+    // Only the pin that changes is written
+    TEST_ASSERT_TRUE(gpio_bank_clear(&bank, 0x3));
+    TEST_ASSERT_EQUAL(2, gpio_mock_get_write_count(0));
+    TEST_ASSERT_EQUAL(1, gpio_mock_get_write_count(1));
+}
+
+void test_gpio_bank_toggle(void) {
+    gpio_mock_set_pin_state(1, true);
+
+    // Unknown levels are read back once, then toggled on the shadow
+    TEST_ASSERT_TRUE(gpio_bank_toggle(&bank, 0x3));
+    TEST_ASSERT_TRUE(gpio_mock_get_pin_state(0));
+    TEST_ASSERT_FALSE(gpio_mock_get_pin_state(1));
+
+    TEST_ASSERT_TRUE(gpio_bank_toggle(&bank, 0x1));
+    TEST_ASSERT_FALSE(gpio_mock_get_pin_state(0));
+    TEST_ASSERT_FALSE(gpio_mock_get_pin_state(1));
+    TEST_ASSERT_EQUAL(2, gpio_mock_get_write_count(0));
+    TEST_ASSERT_EQUAL(1, gpio_mock_get_write_count(1));
+}
+
+void test_gpio_bank_deferred_commit(void) {
+    TEST_ASSERT_TRUE(gpio_mock_bank_attach(&bank));
+    TEST_ASSERT_TRUE(gpio_bank_set_deferred(&bank, true));
+
+    TEST_ASSERT_TRUE(gpio_bank_set(&bank, 0x1));
+    TEST_ASSERT_TRUE(gpio_bank_set(&bank, 0x4));
+    TEST_ASSERT_TRUE(gpio_bank_toggle(&bank, 0x3));
+
+    // Nothing reaches the pins before the commit point
+    TEST_ASSERT_EQUAL(0, gpio_mock_get_bank_write_count());
+    TEST_ASSERT_FALSE(gpio_mock_get_pin_state(1));
+
+    TEST_ASSERT_TRUE(gpio_bank_commit(&bank));
+    TEST_ASSERT_EQUAL(1, gpio_mock_get_bank_write_count());
+    TEST_ASSERT_FALSE(gpio_mock_get_pin_state(0));
+    TEST_ASSERT_TRUE(gpio_mock_get_pin_state(1));
+    TEST_ASSERT_TRUE(gpio_mock_get_pin_state(2));
+
+    // A tick that rewrites the same outputs commits nothing
+    TEST_ASSERT_TRUE(gpio_bank_write(&bank, 0x7, 0x6));
+    TEST_ASSERT_TRUE(gpio_bank_commit(&bank));
+    TEST_ASSERT_EQUAL(1, gpio_mock_get_bank_write_count());
+}
+
+void test_gpio_bank_read(void) {
+    gpio_mock_set_pin_state(0, true);
+    gpio_mock_set_pin_state(3, true);
+
+    uint32_t bits = 0;
+    TEST_ASSERT_TRUE(gpio_bank_read(&bank, &bits));
+    TEST_ASSERT_EQUAL_HEX32(0x9, bits);
+
+    TEST_ASSERT_TRUE(gpio_mock_bank_attach(&bank));
+    TEST_ASSERT_TRUE(gpio_bank_read(&bank, &bits));
+    TEST_ASSERT_EQUAL_HEX32(0x9, bits);
+}
+
+// Unity main
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_gpio_bank_elides_redundant_writes);
+    RUN_TEST(test_gpio_bank_toggle);
+    RUN_TEST(test_gpio_bank_deferred_commit);
+    RUN_TEST(test_gpio_bank_read);
+
+    return UNITY_END();
+}
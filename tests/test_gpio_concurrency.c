@@ -0,0 +1,250 @@
+#include "components/button.h"
+#include "hal/gpio_bank.h"
+#include "mocks/gpio_mock.h"
+#include "unity.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#define NUM_PINS 32
+#define NUM_THREADS 4
+#define PINS_PER_THREAD (NUM_PINS / NUM_THREADS)
+#define ITERATIONS 20000
+#define TOGGLES 1000
+
+#define BUTTON_PIN 100
+#define BUTTON_TASKS 4
+#define PRESSES 10
+
+// Test fixtures
+static gpio_handle_t pins[NUM_PINS];
+static gpio_bank_t bank;
+
+typedef struct {
+    pthread_t thread;
+    uint32_t index;
+    uint32_t expected; // Level this thread leaves its pins at
+} worker_t;
+
+static worker_t workers[NUM_THREADS];
+
+void setUp(void) {
+    gpio_mock_reset();
+
+    gpio_handle_t *ptrs[NUM_PINS];
+    for (uint32_t i = 0; i < NUM_PINS; i++) {
+        gpio_config_t config = {.pin = i, .is_output = true, .active_high = true};
+        TEST_ASSERT_TRUE(gpio_mock_driver.create(&pins[i]));
+        TEST_ASSERT_TRUE(gpio_init(&pins[i], &config));
+        ptrs[i] = &pins[i];
+    }
+    TEST_ASSERT_TRUE(gpio_bank_init(&bank, ptrs, NUM_PINS));
+}
+
+void tearDown(void) {
+    for (int i = 0; i < NUM_PINS; i++) {
+        gpio_deinit(&pins[i]);
+        gpio_mock_driver.destroy(&pins[i]);
+    }
+}
+
+// Native threads must not take the scheduler's signals
+static void block_signals(void) {
+    sigset_t all;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, NULL);
+}
+
+static uint32_t mock_levels(void) {
+    uint32_t levels = 0;
+    for (uint32_t i = 0; i < NUM_PINS; i++) {
+        if (gpio_mock_get_pin_state(i)) levels |= 1u << i;
+    }
+    return levels;
+}
+
+static uint32_t shadow_levels(void) {
+    return (uint32_t)atomic_load(&bank.shadow);
+}
+
+static void run_workers(void *(*fn)(void *)) {
+    for (uint32_t i = 0; i < NUM_THREADS; i++) {
+        workers[i].index = i;
+        workers[i].expected = 0;
+        TEST_ASSERT_EQUAL(0, pthread_create(&workers[i].thread, NULL, fn, &workers[i]));
+    }
+    for (int i = 0; i < NUM_THREADS; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+}
+
+// Each thread owns a byte of the bank and sets/clears its pins one by one
+static void *disjoint_worker(void *arg) {
+    worker_t *worker = arg;
+    block_signals();
+
+    uint32_t shift = worker->index * PINS_PER_THREAD;
+    uint32_t state = 0;
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        uint32_t bit = 1u << (shift + i % PINS_PER_THREAD);
+        if ((i / PINS_PER_THREAD + worker->index) & 1) {
+            gpio_bank_set(&bank, bit);
+            state |= bit;
+        } else {
+            gpio_bank_clear(&bank, bit);
+            state &= ~bit;
+        }
+    }
+    worker->expected = state;
+    return NULL;
+}
+
+// The first thread toggles once more, so the total is odd
+static void *toggle_worker(void *arg) {
+    worker_t *worker = arg;
+    block_signals();
+
+    uint32_t toggles = TOGGLES + (worker->index == 0);
+    for (uint32_t i = 0; i < toggles; i++) {
+        gpio_bank_toggle(&bank, 0xffu);
+    }
+    return NULL;
+}
+
+static uint32_t expected_levels(void) {
+    uint32_t levels = 0;
+    for (int i = 0; i < NUM_THREADS; i++) {
+        levels |= workers[i].expected;
+    }
+    return levels;
+}
+
+void test_bank_disjoint_writers(void) {
+    run_workers(disjoint_worker);
+
+    uint32_t expected = expected_levels();
+    TEST_ASSERT_TRUE(expected != 0);
+    TEST_ASSERT_EQUAL_HEX32(expected, mock_levels());
+    TEST_ASSERT_EQUAL_HEX32(expected, shadow_levels());
+}
+
+void test_bank_disjoint_writers_native(void) {
+    TEST_ASSERT_TRUE(gpio_mock_bank_attach(&bank));
+    run_workers(disjoint_worker);
+
+    uint32_t expected = expected_levels();
+    TEST_ASSERT_EQUAL_HEX32(expected, mock_levels());
+    TEST_ASSERT_EQUAL_HEX32(expected, shadow_levels());
+}
+
+void test_bank_concurrent_toggles(void) {
+    TEST_ASSERT_TRUE(gpio_mock_bank_attach(&bank));
+    TEST_ASSERT_TRUE(gpio_bank_write(&bank, 0xffu, 0));
+    run_workers(toggle_worker);
+
+    // An odd total leaves every pin high; a lost toggle or toggles that do
+    // nothing leave them low
+    TEST_ASSERT_EQUAL_HEX32(0xffu, mock_levels());
+    TEST_ASSERT_EQUAL_HEX32(0xffu, shadow_levels());
+}
+
+void test_bank_deferred_concurrent_writes(void) {
+    TEST_ASSERT_TRUE(gpio_mock_bank_attach(&bank));
+    TEST_ASSERT_TRUE(gpio_bank_set_deferred(&bank, true));
+    run_workers(disjoint_worker);
+
+    // Nothing reached the pins until the commit
+    TEST_ASSERT_EQUAL_HEX32(0, mock_levels());
+    TEST_ASSERT_TRUE(gpio_bank_commit(&bank));
+    TEST_ASSERT_EQUAL_HEX32(expected_levels(), mock_levels());
+}
+
+// Button polled by several tasks at once
+static button_handle_t button;
+static QueueHandle_t button_queue;
+static atomic_bool polling;
+static atomic_int pollers;
+
+static void button_poller(void *arg) {
+    (void)arg;
+    button_event_t ignored;
+    while (atomic_load(&polling)) {
+        button.process(&button, &ignored);
+        taskYIELD();
+    }
+    atomic_fetch_sub(&pollers, 1);
+    vTaskDelete(NULL);
+}
+
+void test_button_shared_process(void) {
+    button_queue = xQueueCreate(4 * PRESSES, sizeof(button_event_t));
+    TEST_ASSERT_NOT_NULL(button_queue);
+    TEST_ASSERT_TRUE(button_driver.create(&button));
+    TEST_ASSERT_TRUE(gpio_mock_driver.create(&button.gpio));
+    button_config_t config = {
+        .gpio_config = {.pin = BUTTON_PIN, .is_output = false, .active_high = true},
+        .debounce_ms = 10,
+        .long_press_ms = 1000,
+        .event_queue = button_queue,
+    };
+    TEST_ASSERT_TRUE(button.init(&button, &config));
+
+    atomic_store(&polling, true);
+    atomic_store(&pollers, BUTTON_TASKS);
+    for (int i = 0; i < BUTTON_TASKS; i++) {
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(button_poller, "poller", configMINIMAL_STACK_SIZE,
+                                              NULL, tskIDLE_PRIORITY + 1, NULL));
+    }
+
+    for (int i = 0; i < PRESSES; i++) {
+        gpio_mock_set_pin_state(BUTTON_PIN, true);
+        vTaskDelay(pdMS_TO_TICKS(40));
+        gpio_mock_set_pin_state(BUTTON_PIN, false);
+        vTaskDelay(pdMS_TO_TICKS(40));
+    }
+
+    atomic_store(&polling, false);
+    while (atomic_load(&pollers)) {
+        vTaskDelay(1);
+    }
+
+    // Exactly one PRESSED and one CLICKED per press, in order
+    button_event_t event;
+    for (int i = 0; i < PRESSES; i++) {
+        TEST_ASSERT_TRUE(xQueueReceive(button_queue, &event, 0));
+        TEST_ASSERT_EQUAL(BUTTON_EVENT_PRESSED, event);
+        TEST_ASSERT_TRUE(xQueueReceive(button_queue, &event, 0));
+        TEST_ASSERT_EQUAL(BUTTON_EVENT_CLICKED, event);
+    }
+    TEST_ASSERT_FALSE(xQueueReceive(button_queue, &event, 0));
+    TEST_ASSERT_FALSE(button.is_pressed);
+
+    button_driver.destroy(&button);
+    gpio_mock_driver.destroy(&button.gpio);
+    vQueueDelete(button_queue);
+}
+
+static void test_runner(void *pvParameters) {
+    (void)pvParameters;
+    UNITY_BEGIN();
+
+    RUN_TEST(test_bank_disjoint_writers);
+    RUN_TEST(test_bank_disjoint_writers_native);
+    RUN_TEST(test_bank_concurrent_toggles);
+    RUN_TEST(test_bank_deferred_concurrent_writes);
+    RUN_TEST(test_button_shared_process);
+
+    exit(UNITY_END());
+}
+
+// Unity main
+int main(void) {
+    xTaskCreate(test_runner, "runner", configMINIMAL_STACK_SIZE, NULL,
+                tskIDLE_PRIORITY + 1, NULL);
+    vTaskStartScheduler();
+    return 1;
+}
@@ -0,0 +1,115 @@
+#include "hal/gpio_filter.h"
+#include "unity.h"
+#include <pthread.h>
+
+#define PERIOD_US 1000
+#define THREADS 4
+#define SAMPLES 100000
+
+// Test fixtures
+static gpio_filter_t filter;
+
+void setUp(void) {
+    gpio_filter_init(&filter, PERIOD_US);
+}
+
+void tearDown(void) {
+}
+
+// Test cases
+void test_gpio_filter_first_sample_primes(void) {
+    TEST_ASSERT_FALSE(gpio_filter_level(&filter));
+    TEST_ASSERT_TRUE(gpio_filter_sample(&filter, true, 5000));
+    TEST_ASSERT_TRUE(gpio_filter_level(&filter));
+}
+
+void test_gpio_filter_bounce_keeps_level(void) {
+    gpio_filter_sample(&filter, false, 0);
+
+    // Levels shorter than the period never get through
+    for (uint64_t t = 100; t < 5000; t += 100) {
+        TEST_ASSERT_FALSE(gpio_filter_sample(&filter, (t / 100) % 2, t));
+    }
+}
+
+void test_gpio_filter_settles_after_period(void) {
+    gpio_filter_sample(&filter, false, 0);
+
+    TEST_ASSERT_FALSE(gpio_filter_sample(&filter, true, 100));
+    TEST_ASSERT_FALSE(gpio_filter_sample(&filter, true, 100 + PERIOD_US - 1));
+    TEST_ASSERT_TRUE(gpio_filter_sample(&filter, true, 100 + PERIOD_US));
+
+    // A bounce back restarts the count
+    TEST_ASSERT_TRUE(gpio_filter_sample(&filter, false, 2000));
+    TEST_ASSERT_TRUE(gpio_filter_sample(&filter, true, 2100));
+    TEST_ASSERT_TRUE(gpio_filter_sample(&filter, false, 2200));
+    TEST_ASSERT_TRUE(gpio_filter_sample(&filter, false, 2200 + PERIOD_US - 1));
+    TEST_ASSERT_FALSE(gpio_filter_sample(&filter, false, 2200 + PERIOD_US));
+}
+
+void test_gpio_filter_only_moves_when_sampled(void) {
+    gpio_filter_sample(&filter, false, 0);
+
+    // The only sample of the new level comes during the bounce: the level
+    // stays old however long nobody reads, then the next read settles it
+    TEST_ASSERT_FALSE(gpio_filter_sample(&filter, true, 100));
+    TEST_ASSERT_FALSE(gpio_filter_level(&filter));
+    TEST_ASSERT_TRUE(gpio_filter_sample(&filter, true, 1000000));
+}
+
+void test_gpio_filter_out_of_order(void) {
+    gpio_filter_sample(&filter, false, 0);
+
+    // Another thread read the clock before this one but samples after it
+    TEST_ASSERT_FALSE(gpio_filter_sample(&filter, true, 2000));
+    TEST_ASSERT_FALSE(gpio_filter_sample(&filter, true, 1500));
+    TEST_ASSERT_TRUE(gpio_filter_sample(&filter, true, 2000 + PERIOD_US));
+}
+
+void test_gpio_filter_off(void) {
+    gpio_filter_init(&filter, 0);
+    TEST_ASSERT_FALSE(gpio_filter_sample(&filter, false, 0));
+    TEST_ASSERT_TRUE(gpio_filter_sample(&filter, true, 0));
+    TEST_ASSERT_FALSE(gpio_filter_sample(&filter, false, 0));
+}
+
+// Every thread samples the new level at its own times, all within one
+// period of each other, so they reach the filter out of order
+static void *sample_worker(void *arg) {
+    uint64_t offset = (uintptr_t)arg * 7919;
+    for (uint64_t i = 0; i < SAMPLES; i++) {
+        gpio_filter_sample(&filter, true, PERIOD_US - 1 - (offset + i * 31) % (PERIOD_US - 1));
+    }
+    return NULL;
+}
+
+void test_gpio_filter_shared_by_threads(void) {
+    gpio_filter_sample(&filter, false, 0);
+
+    pthread_t threads[THREADS];
+    for (uintptr_t i = 0; i < THREADS; i++) {
+        TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL, sample_worker, (void *)i));
+    }
+    for (int i = 0; i < THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // No sample came a full period after the first one of the new level
+    TEST_ASSERT_FALSE(gpio_filter_level(&filter));
+    TEST_ASSERT_TRUE(gpio_filter_sample(&filter, true, PERIOD_US * 2));
+}
+
+// Unity main
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_gpio_filter_first_sample_primes);
+    RUN_TEST(test_gpio_filter_bounce_keeps_level);
+    RUN_TEST(test_gpio_filter_settles_after_period);
+    RUN_TEST(test_gpio_filter_only_moves_when_sampled);
+    RUN_TEST(test_gpio_filter_out_of_order);
+    RUN_TEST(test_gpio_filter_off);
+    RUN_TEST(test_gpio_filter_shared_by_threads);
+
+    return UNITY_END();
+}
@@ -0,0 +1,67 @@
+#include "hal/gpio_provision.h"
+#include "mocks/gpio_mock.h"
+#include "unity.h"
+#include <errno.h>
+
+#define NUM_PINS 4
+
+// Test fixtures
+static const gpio_config_t configs[NUM_PINS] = {
+    {.pin = 0, .is_output = true, .active_high = true},
+    {.pin = 1, .is_output = true, .active_high = false},
+    {.pin = GPIO_MOCK_MAX_PINS, .is_output = false}, // Out of range
+    {.pin = 3, .is_output = false, .active_high = true},
+};
+static gpio_handle_t pins[NUM_PINS];
+static int errors[NUM_PINS];
+
+void setUp(void) {
+    gpio_mock_reset();
+}
+
+void tearDown(void) {
+    gpio_unprovision(&gpio_mock_driver, pins, NUM_PINS);
+}
+
+// Test cases
+void test_gpio_provision_reports_per_pin_errors(void) {
+    TEST_ASSERT_FALSE(gpio_provision(&gpio_mock_driver, pins, configs, NUM_PINS, errors));
+
+    TEST_ASSERT_EQUAL(0, errors[0]);
+    TEST_ASSERT_EQUAL(0, errors[1]);
+    TEST_ASSERT_EQUAL(EIO, errors[2]);
+    TEST_ASSERT_EQUAL(0, errors[3]);
+    TEST_ASSERT_NULL(pins[2].hw_handle);
+}
+
+void test_gpio_provision_handles_are_ready(void) {
+    gpio_provision(&gpio_mock_driver, pins, configs, NUM_PINS, NULL);
+
+    TEST_ASSERT_TRUE(gpio_activate(&pins[0]));
+    TEST_ASSERT_TRUE(gpio_mock_get_pin_state(0));
+    TEST_ASSERT_TRUE(gpio_activate(&pins[1]));
+    TEST_ASSERT_FALSE(gpio_mock_get_pin_state(1));
+
+    gpio_mock_set_pin_state(3, true);
+    TEST_ASSERT_TRUE(gpio_is_active(&pins[3]));
+}
+
+void test_gpio_unprovision_tears_down_all(void) {
+    gpio_provision(&gpio_mock_driver, pins, configs, NUM_PINS, NULL);
+    gpio_unprovision(&gpio_mock_driver, pins, NUM_PINS);
+
+    for (int i = 0; i < NUM_PINS; i++) {
+        TEST_ASSERT_NULL(pins[i].hw_handle);
+    }
+}
+
+// Unity main
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_gpio_provision_reports_per_pin_errors);
+    RUN_TEST(test_gpio_provision_handles_are_ready);
+    RUN_TEST(test_gpio_unprovision_tears_down_all);
+
+    return UNITY_END();
+}
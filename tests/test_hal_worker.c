@@ -0,0 +1,167 @@
+#define _GNU_SOURCE // sched_getaffinity()
+#include "hal/hal_worker.h"
+#include "unity.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <errno.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define JOB_MS 100
+
+static volatile uint32_t ticker_count;
+static TaskHandle_t runner_task;
+
+static bool sleep_job(void *arg) {
+    usleep(JOB_MS * 1000); // Blocking syscall, stalls the scheduler if inline
+    (*(volatile int *)arg)++;
+    return true;
+}
+
+static bool affinity_job(void *arg) {
+    return sched_getaffinity(0, sizeof(cpu_set_t), arg) == 0;
+}
+
+static void ticker_task(void *pvParameters) {
+    (void)pvParameters;
+    for (;;) {
+        ticker_count++;
+        vTaskDelay(1);
+    }
+}
+
+static void io_task(void *pvParameters) {
+    hal_worker_call(sleep_job, pvParameters);
+    xTaskNotifyGive(runner_task);
+    vTaskDelete(NULL);
+}
+
+void setUp(void) {
+    TEST_ASSERT_TRUE(hal_worker_start(2));
+}
+
+void tearDown(void) {
+    hal_worker_stop();
+}
+
+// Test cases
+void test_hal_worker_returns_result(void) {
+    volatile int done = 0;
+    TEST_ASSERT_TRUE(hal_worker_call(sleep_job, (void *)&done));
+    TEST_ASSERT_EQUAL(1, done);
+}
+
+void test_hal_worker_inline_when_stopped(void) {
+    volatile int done = 0;
+    hal_worker_stop();
+    TEST_ASSERT_TRUE(hal_worker_call(sleep_job, (void *)&done));
+    TEST_ASSERT_EQUAL(1, done);
+    TEST_ASSERT_TRUE(hal_worker_start(2));
+}
+
+void test_hal_worker_does_not_stall_scheduler(void) {
+    volatile int done = 0;
+    TaskHandle_t ticker;
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(ticker_task, "ticker", configMINIMAL_STACK_SIZE,
+                                          NULL, tskIDLE_PRIORITY + 1, &ticker));
+
+    ticker_count = 0;
+    hal_worker_call(sleep_job, (void *)&done);
+    uint32_t ticks_during_call = ticker_count;
+    vTaskDelete(ticker);
+
+    // The ticker keeps running while the caller is blocked in the syscall
+    TEST_ASSERT_EQUAL(1, done);
+    TEST_ASSERT_GREATER_THAN(JOB_MS / 2, ticks_during_call);
+}
+
+void test_hal_worker_calls_run_in_parallel(void) {
+    volatile int done = 0;
+    TickType_t start = xTaskGetTickCount();
+
+    for (int i = 0; i < 2; i++) {
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(io_task, "io", configMINIMAL_STACK_SIZE,
+                                              (void *)&done, tskIDLE_PRIORITY + 1, NULL));
+    }
+    for (int i = 0; i < 2; i++) {
+        TEST_ASSERT_EQUAL(1, ulTaskNotifyTake(pdFALSE, pdMS_TO_TICKS(10 * JOB_MS)));
+    }
+
+    TEST_ASSERT_EQUAL(2, done);
+    TEST_ASSERT_LESS_THAN(pdMS_TO_TICKS(2 * JOB_MS), xTaskGetTickCount() - start);
+}
+
+// Must run before anything calls hal_worker_set_sched()
+void test_hal_worker_inherits_sched(void) {
+    cpu_set_t initial, cpus;
+    TEST_ASSERT_EQUAL(0, sched_getaffinity(0, sizeof(initial), &initial));
+    int cpu = 0;
+    while (cpu < 31 && !CPU_ISSET(cpu, &initial))
+        cpu++;
+
+    // Workers keep the starting thread's affinity, as set by taskset
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    TEST_ASSERT_EQUAL(0, sched_setaffinity(0, sizeof(cpus), &cpus));
+    hal_worker_stop();
+    TEST_ASSERT_TRUE(hal_worker_start(2));
+    TEST_ASSERT_EQUAL(0, sched_setaffinity(0, sizeof(initial), &initial));
+
+    TEST_ASSERT_TRUE(hal_worker_call(affinity_job, &cpus));
+    TEST_ASSERT_EQUAL(1, CPU_COUNT(&cpus));
+    TEST_ASSERT_TRUE(CPU_ISSET(cpu, &cpus));
+}
+
+void test_hal_worker_set_sched_pins_workers(void) {
+    cpu_set_t cpus;
+    TEST_ASSERT_EQUAL(0, sched_getaffinity(0, sizeof(cpus), &cpus));
+    int cpu = 0;
+    while (cpu < 31 && !CPU_ISSET(cpu, &cpus))
+        cpu++;
+
+    // Running workers move at once
+    TEST_ASSERT_TRUE(hal_worker_set_sched(0, 1u << cpu));
+    TEST_ASSERT_TRUE(hal_worker_call(affinity_job, &cpus));
+    TEST_ASSERT_EQUAL(1, CPU_COUNT(&cpus));
+    TEST_ASSERT_TRUE(CPU_ISSET(cpu, &cpus));
+
+    // Workers started later too
+    hal_worker_stop();
+    TEST_ASSERT_TRUE(hal_worker_start(2));
+    TEST_ASSERT_TRUE(hal_worker_call(affinity_job, &cpus));
+    TEST_ASSERT_EQUAL(1, CPU_COUNT(&cpus));
+
+    TEST_ASSERT_TRUE(hal_worker_set_sched(0, 0));
+    TEST_ASSERT_TRUE(hal_worker_call(affinity_job, &cpus));
+    TEST_ASSERT_GREATER_OR_EQUAL(1, CPU_COUNT(&cpus));
+}
+
+void test_hal_worker_set_sched_rejects_bad_priority(void) {
+    TEST_ASSERT_FALSE(hal_worker_set_sched(-1, 0));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    TEST_ASSERT_FALSE(hal_worker_set_sched(1000, 0));
+}
+
+static void test_runner(void *pvParameters) {
+    (void)pvParameters;
+    UNITY_BEGIN();
+
+    RUN_TEST(test_hal_worker_returns_result);
+    RUN_TEST(test_hal_worker_inline_when_stopped);
+    RUN_TEST(test_hal_worker_does_not_stall_scheduler);
+    RUN_TEST(test_hal_worker_calls_run_in_parallel);
+    RUN_TEST(test_hal_worker_inherits_sched);
+    RUN_TEST(test_hal_worker_set_sched_pins_workers);
+    RUN_TEST(test_hal_worker_set_sched_rejects_bad_priority);
+
+    exit(UNITY_END());
+}
+
+// Unity main
+int main(void) {
+    xTaskCreate(test_runner, "runner", configMINIMAL_STACK_SIZE, NULL,
+                tskIDLE_PRIORITY + 2, &runner_task);
+    vTaskStartScheduler();
+    return 1;
+}
@@ -0,0 +1,202 @@
+#include "components/keypad.h"
+#include "mocks/gpio_mock.h"
+#include "unity.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include <stdlib.h>
+
+#define NUM_ROWS 8
+#define NUM_COLS 16
+#define ROW_PIN(r) (r)
+#define COL_PIN(c) (NUM_ROWS + (c))
+#define KEY(r, c) ((r) * NUM_COLS + (c))
+#define DEBOUNCE_SCANS 4
+
+// Test fixtures
+static keypad_handle_t keypad;
+static QueueHandle_t event_queue;
+static keypad_event_t received_event;
+static gpio_handle_t row_pins[NUM_ROWS];
+static gpio_handle_t col_pins[NUM_COLS];
+static gpio_bank_t rows;
+static gpio_bank_t cols;
+
+// Simulated key matrix without diodes, one bit per column for each row
+static uint32_t matrix[NUM_ROWS];
+
+// Columns are pulled up and read low when connected to a driven row through
+// pressed keys, including paths through other rows (ghosting)
+static bool matrix_input_hook(uint32_t pin, bool level, void *arg) {
+    (void)arg;
+    if (pin < COL_PIN(0) || pin >= COL_PIN(NUM_COLS)) return level;
+
+    uint32_t reached_rows = 0;
+    for (uint32_t r = 0; r < NUM_ROWS; r++) {
+        if (!gpio_mock_get_pin_state(ROW_PIN(r))) reached_rows |= 1u << r;
+    }
+
+    uint32_t reached_cols = 0, previous;
+    do {
+        previous = reached_cols;
+        for (uint32_t r = 0; r < NUM_ROWS; r++) {
+            if (reached_rows & (1u << r)) reached_cols |= matrix[r];
+        }
+        for (uint32_t r = 0; r < NUM_ROWS; r++) {
+            if (matrix[r] & reached_cols) reached_rows |= 1u << r;
+        }
+    } while (reached_cols != previous);
+
+    return !(reached_cols & (1u << (pin - COL_PIN(0))));
+}
+
+static void scan(int times) {
+    for (int i = 0; i < times; i++) {
+        TEST_ASSERT_TRUE(keypad.scan(&keypad));
+    }
+}
+
+static void expect_event(keypad_event_type_t type, uint16_t key) {
+    TEST_ASSERT_TRUE(xQueueReceive(event_queue, &received_event, 0));
+    TEST_ASSERT_EQUAL(type, received_event.type);
+    TEST_ASSERT_EQUAL(key, received_event.key);
+}
+
+void setUp(void) {
+    gpio_mock_reset();
+    gpio_mock_set_input_hook(matrix_input_hook, NULL);
+    for (int r = 0; r < NUM_ROWS; r++) matrix[r] = 0;
+
+    event_queue = xQueueCreate(32, sizeof(keypad_event_t));
+    TEST_ASSERT_NOT_NULL(event_queue);
+
+    gpio_handle_t *row_ptrs[NUM_ROWS];
+    gpio_handle_t *col_ptrs[NUM_COLS];
+    for (uint32_t r = 0; r < NUM_ROWS; r++) {
+        gpio_config_t config = {.pin = ROW_PIN(r), .is_output = true, .active_high = false};
+        TEST_ASSERT_TRUE(gpio_mock_driver.create(&row_pins[r]));
+        TEST_ASSERT_TRUE(gpio_init(&row_pins[r], &config));
+        row_ptrs[r] = &row_pins[r];
+    }
+    for (uint32_t c = 0; c < NUM_COLS; c++) {
+        gpio_config_t config = {.pin = COL_PIN(c), .is_output = false, .pull_up = true};
+        TEST_ASSERT_TRUE(gpio_mock_driver.create(&col_pins[c]));
+        TEST_ASSERT_TRUE(gpio_init(&col_pins[c], &config));
+        col_ptrs[c] = &col_pins[c];
+    }
+    TEST_ASSERT_TRUE(gpio_bank_init(&rows, row_ptrs, NUM_ROWS));
+    TEST_ASSERT_TRUE(gpio_bank_init(&cols, col_ptrs, NUM_COLS));
+    TEST_ASSERT_TRUE(gpio_mock_bank_attach(&rows));
+    TEST_ASSERT_TRUE(gpio_mock_bank_attach(&cols));
+
+    TEST_ASSERT_TRUE(keypad_driver.create(&keypad));
+    keypad_config_t config = {
+        .rows = &rows,
+        .cols = &cols,
+        .active_low = true,
+        .scan_interval_ms = 0,
+        .event_queue = event_queue,
+    };
+    TEST_ASSERT_TRUE(keypad.init(&keypad, &config));
+}
+
+void tearDown(void) {
+    keypad_driver.destroy(&keypad);
+    for (int r = 0; r < NUM_ROWS; r++) gpio_mock_driver.destroy(&row_pins[r]);
+    for (int c = 0; c < NUM_COLS; c++) gpio_mock_driver.destroy(&col_pins[c]);
+    vQueueDelete(event_queue);
+}
+
+// Test cases
+void test_keypad_press_release(void) {
+    matrix[2] = 1u << 5;
+    scan(DEBOUNCE_SCANS);
+    expect_event(KEYPAD_EVENT_PRESSED, KEY(2, 5));
+    TEST_ASSERT_TRUE(keypad.is_pressed(&keypad, KEY(2, 5)));
+
+    matrix[2] = 0;
+    scan(DEBOUNCE_SCANS);
+    expect_event(KEYPAD_EVENT_RELEASED, KEY(2, 5));
+    TEST_ASSERT_FALSE(keypad.is_pressed(&keypad, KEY(2, 5)));
+    TEST_ASSERT_FALSE(xQueueReceive(event_queue, &received_event, 0));
+}
+
+void test_keypad_debounce(void) {
+    // Bounce shorter than the debounce window
+    for (int i = 0; i < 5; i++) {
+        matrix[7] = 1u << 15;
+        scan(DEBOUNCE_SCANS - 1);
+        matrix[7] = 0;
+        scan(1);
+    }
+    TEST_ASSERT_FALSE(xQueueReceive(event_queue, &received_event, 0));
+
+    matrix[7] = 1u << 15;
+    scan(DEBOUNCE_SCANS);
+    expect_event(KEYPAD_EVENT_PRESSED, KEY(7, 15));
+}
+
+void test_keypad_rollover(void) {
+    for (int r = 0; r < 6; r++) matrix[r] = 1u << (2 * r);
+    scan(DEBOUNCE_SCANS);
+
+    for (int r = 0; r < 6; r++) {
+        expect_event(KEYPAD_EVENT_PRESSED, KEY(r, 2 * r));
+    }
+    TEST_ASSERT_EQUAL(0, keypad.ghost_scans);
+}
+
+void test_keypad_ghost_detection(void) {
+    matrix[0] = 0x3;
+    scan(DEBOUNCE_SCANS);
+    expect_event(KEYPAD_EVENT_PRESSED, KEY(0, 0));
+    expect_event(KEYPAD_EVENT_PRESSED, KEY(0, 1));
+
+    // Third corner of a rectangle: (1,1) would read pressed as well
+    matrix[1] = 0x1;
+    scan(DEBOUNCE_SCANS);
+    TEST_ASSERT_FALSE(xQueueReceive(event_queue, &received_event, 0));
+    TEST_ASSERT_FALSE(keypad.is_pressed(&keypad, KEY(1, 1)));
+    TEST_ASSERT_EQUAL(DEBOUNCE_SCANS, keypad.ghost_scans);
+
+    // Resolves once the pattern is no longer ambiguous
+    matrix[0] = 0x2;
+    scan(DEBOUNCE_SCANS);
+    expect_event(KEYPAD_EVENT_RELEASED, KEY(0, 0));
+    expect_event(KEYPAD_EVENT_PRESSED, KEY(1, 0));
+}
+
+void test_keypad_scan_cost(void) {
+    uint32_t writes = gpio_mock_get_bank_write_count();
+    uint32_t reads = gpio_mock_get_bank_read_count();
+    scan(1);
+
+    // One bank write and one bank read per row
+    TEST_ASSERT_LESS_OR_EQUAL(NUM_ROWS, gpio_mock_get_bank_write_count() - writes);
+    TEST_ASSERT_EQUAL(NUM_ROWS, gpio_mock_get_bank_read_count() - reads);
+
+    TickType_t start = xTaskGetTickCount();
+    scan(10000);
+    TEST_ASSERT_LESS_THAN(pdMS_TO_TICKS(1000), xTaskGetTickCount() - start);
+}
+
+static void test_runner(void *pvParameters) {
+    (void)pvParameters;
+    UNITY_BEGIN();
+
+    RUN_TEST(test_keypad_press_release);
+    RUN_TEST(test_keypad_debounce);
+    RUN_TEST(test_keypad_rollover);
+    RUN_TEST(test_keypad_ghost_detection);
+    RUN_TEST(test_keypad_scan_cost);
+
+    exit(UNITY_END());
+}
+
+// Unity main
+int main(void) {
+    xTaskCreate(test_runner, "runner", configMINIMAL_STACK_SIZE, NULL,
+                tskIDLE_PRIORITY + 1, NULL);
+    vTaskStartScheduler();
+    return 1;
+}
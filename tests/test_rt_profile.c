@@ -0,0 +1,123 @@
+#define _GNU_SOURCE // sched_getaffinity()
+#include "core/rt_profile.h"
+#include "unity.h"
+#include <errno.h>
+#include <sched.h>
+#include <stdio.h>
+#include <sys/mman.h>
+
+// Default policy on every CPU, without locking
+static const rt_profile_config_t plain_config = {
+    .lock_memory = false,
+    .heap_reserve = 256 * 1024,
+    .stack_prefault = 16 * 1024,
+};
+
+static cpu_set_t initial_cpus;
+
+void setUp(void) {
+    TEST_ASSERT_EQUAL(0, sched_getaffinity(0, sizeof(initial_cpus), &initial_cpus));
+}
+
+void tearDown(void) {
+    sched_setaffinity(0, sizeof(initial_cpus), &initial_cpus);
+    munlockall();
+}
+
+static int first_cpu(void) {
+    for (int cpu = 0; cpu < 32; cpu++) {
+        if (CPU_ISSET(cpu, &initial_cpus))
+            return cpu;
+    }
+    return -1;
+}
+
+// Locked memory of the process in kB, from /proc
+static long locked_kb(void) {
+    FILE *status = fopen("/proc/self/status", "r");
+    char line[128];
+    long kb = -1;
+    while (status && fgets(line, sizeof(line), status)) {
+        if (sscanf(line, "VmLck: %ld kB", &kb) == 1)
+            break;
+    }
+    if (status)
+        fclose(status);
+    return kb;
+}
+
+// Test cases
+void test_rt_thread_pinned_to_cpus(void) {
+    int cpu = first_cpu();
+    if (cpu < 0)
+        TEST_IGNORE_MESSAGE("No CPU below 32 available");
+
+    rt_thread_config_t pinned = {.priority = 0, .cpus = 1u << cpu};
+    TEST_ASSERT_TRUE(rt_profile_apply_thread(pthread_self(), &pinned));
+
+    cpu_set_t cpus;
+    TEST_ASSERT_EQUAL(0, sched_getaffinity(0, sizeof(cpus), &cpus));
+    TEST_ASSERT_EQUAL(1, CPU_COUNT(&cpus));
+    TEST_ASSERT_TRUE(CPU_ISSET(cpu, &cpus));
+
+    // An empty mask allows every CPU again
+    rt_thread_config_t any = {0};
+    TEST_ASSERT_TRUE(rt_profile_apply_thread(pthread_self(), &any));
+    TEST_ASSERT_EQUAL(0, sched_getaffinity(0, sizeof(cpus), &cpus));
+    TEST_ASSERT_EQUAL(CPU_COUNT(&initial_cpus), CPU_COUNT(&cpus));
+}
+
+void test_rt_thread_fifo_priority(void) {
+    rt_thread_config_t fifo = {.priority = 10};
+    if (!rt_profile_apply_thread(pthread_self(), &fifo)) {
+        TEST_ASSERT_EQUAL(EPERM, errno);
+        TEST_IGNORE_MESSAGE("SCHED_FIFO not permitted");
+    }
+
+    int policy;
+    struct sched_param param;
+    TEST_ASSERT_EQUAL(0, pthread_getschedparam(pthread_self(), &policy, &param));
+    TEST_ASSERT_EQUAL(SCHED_FIFO, policy);
+    TEST_ASSERT_EQUAL(10, param.sched_priority);
+
+    rt_thread_config_t other = {0};
+    TEST_ASSERT_TRUE(rt_profile_apply_thread(pthread_self(), &other));
+    TEST_ASSERT_EQUAL(0, pthread_getschedparam(pthread_self(), &policy, &param));
+    TEST_ASSERT_EQUAL(SCHED_OTHER, policy);
+}
+
+void test_rt_thread_rejects_bad_priority(void) {
+    rt_thread_config_t bad = {.priority = 1000};
+    TEST_ASSERT_FALSE(rt_profile_apply_thread(pthread_self(), &bad));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    TEST_ASSERT_FALSE(rt_profile_apply_thread(pthread_self(), NULL));
+}
+
+void test_rt_profile_without_privileges(void) {
+    TEST_ASSERT_TRUE(rt_profile_apply(&plain_config));
+}
+
+void test_rt_profile_locks_memory(void) {
+    rt_profile_config_t config = plain_config;
+    config.lock_memory = true;
+    if (!rt_profile_apply(&config)) {
+        TEST_ASSERT_TRUE(errno == EPERM || errno == ENOMEM || errno == EAGAIN);
+        TEST_IGNORE_MESSAGE("mlockall() not permitted");
+    }
+
+    // The prefaulted heap reserve is part of the locked memory
+    TEST_ASSERT_GREATER_OR_EQUAL(256, locked_kb());
+}
+
+// Unity main
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_rt_thread_pinned_to_cpus);
+    RUN_TEST(test_rt_thread_fifo_priority);
+    RUN_TEST(test_rt_thread_rejects_bad_priority);
+    RUN_TEST(test_rt_profile_without_privileges);
+    RUN_TEST(test_rt_profile_locks_memory);
+
+    return UNITY_END();
+}
@@ -0,0 +1,279 @@
+#include "hal/soft_i2c.h"
+#include "hal/soft_spi.h"
+#include "mocks/bus_slave_mock.h"
+#include "mocks/gpio_mock.h"
+#include "unity.h"
+#include <string.h>
+#include <time.h>
+
+#define PIN_SCL 0
+#define PIN_SDA 1
+#define PIN_SCK 2
+#define PIN_MOSI 3
+#define PIN_MISO 4
+#define PIN_CS0 5
+#define PIN_CS1 6
+#define NUM_PINS 7
+
+#define SLAVE_ADDRESS 0x48
+
+// Test fixtures
+static gpio_handle_t pins[NUM_PINS];
+static i2c_slave_mock_t i2c_slave;
+static spi_slave_mock_t spi_slave;
+
+void setUp(void) {
+    gpio_mock_reset();
+
+    for (uint32_t i = 0; i < NUM_PINS; i++) {
+        gpio_config_t config = {
+            .pin = i,
+            .is_output = i != PIN_MISO,
+            .active_high = true,
+            .open_drain = i == PIN_SCL || i == PIN_SDA,
+        };
+        TEST_ASSERT_TRUE(gpio_mock_driver.create(&pins[i]));
+        TEST_ASSERT_TRUE(gpio_init(&pins[i], &config));
+    }
+
+    memset(&i2c_slave, 0, sizeof(i2c_slave));
+    i2c_slave.scl_pin = PIN_SCL;
+    i2c_slave.sda_pin = PIN_SDA;
+    i2c_slave.address = SLAVE_ADDRESS;
+
+    memset(&spi_slave, 0, sizeof(spi_slave));
+    spi_slave.sck_pin = PIN_SCK;
+    spi_slave.mosi_pin = PIN_MOSI;
+    spi_slave.miso_pin = PIN_MISO;
+    spi_slave.cs_pin = PIN_CS0;
+    spi_slave.reply = 0x5A;
+}
+
+void tearDown(void) {
+    bus_slave_mock_detach();
+    for (uint32_t i = 0; i < NUM_PINS; i++) {
+        gpio_deinit(&pins[i]);
+        gpio_mock_driver.destroy(&pins[i]);
+    }
+}
+
+static soft_i2c_config_t i2c_config(uint32_t speed_hz) {
+    soft_i2c_config_t config = {
+        .scl = &pins[PIN_SCL],
+        .sda = &pins[PIN_SDA],
+        .speed_hz = speed_hz,
+    };
+    return config;
+}
+
+static soft_spi_config_t spi_config(uint8_t mode) {
+    soft_spi_config_t config = {
+        .sck = &pins[PIN_SCK],
+        .mosi = &pins[PIN_MOSI],
+        .miso = &pins[PIN_MISO],
+        .cs = {&pins[PIN_CS0], &pins[PIN_CS1]},
+        .mode = mode,
+    };
+    return config;
+}
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// Test cases
+void test_soft_i2c_register_round_trip(void) {
+    soft_i2c_t bus;
+    soft_i2c_config_t config = i2c_config(0);
+    i2c_slave_mock_attach(&i2c_slave);
+    TEST_ASSERT_TRUE(soft_i2c_init(&bus, &config));
+
+    const uint8_t data[] = {0xDE, 0xAD, 0xBE, 0xEF};
+    TEST_ASSERT_TRUE(soft_i2c_write_reg(&bus, SLAVE_ADDRESS, 0x10, data, sizeof(data)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(data, &i2c_slave.regs[0x10], sizeof(data));
+
+    // Register pointer, repeated start, then the read
+    uint8_t read[4] = {0};
+    uint32_t starts = i2c_slave.starts;
+    TEST_ASSERT_TRUE(soft_i2c_read_reg(&bus, SLAVE_ADDRESS, 0x10, read, sizeof(read)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(data, read, sizeof(read));
+    TEST_ASSERT_EQUAL(starts + 2, i2c_slave.starts);
+    TEST_ASSERT_EQUAL(SOFT_I2C_OK, bus.error);
+
+    // The bus is released after every transfer
+    TEST_ASSERT_TRUE(gpio_mock_get_pin_state(PIN_SCL));
+    TEST_ASSERT_TRUE(gpio_mock_get_pin_state(PIN_SDA));
+}
+
+void test_soft_i2c_probe_and_nack(void) {
+    soft_i2c_t bus;
+    soft_i2c_config_t config = i2c_config(0);
+    i2c_slave_mock_attach(&i2c_slave);
+    TEST_ASSERT_TRUE(soft_i2c_init(&bus, &config));
+
+    TEST_ASSERT_TRUE(soft_i2c_probe(&bus, SLAVE_ADDRESS));
+
+    uint32_t stops = i2c_slave.stops;
+    uint8_t byte;
+    TEST_ASSERT_FALSE(soft_i2c_read(&bus, SLAVE_ADDRESS + 1, &byte, 1));
+    TEST_ASSERT_EQUAL(SOFT_I2C_NACK_ADDRESS, bus.error);
+    TEST_ASSERT_EQUAL(stops + 1, i2c_slave.stops);
+
+    TEST_ASSERT_FALSE(soft_i2c_probe(&bus, 0x80)); // Not a 7-bit address
+}
+
+void test_soft_i2c_clock_stretching(void) {
+    soft_i2c_t bus;
+    soft_i2c_config_t config = i2c_config(0);
+    i2c_slave.stretch_reads = 20;
+    i2c_slave_mock_attach(&i2c_slave);
+    TEST_ASSERT_TRUE(soft_i2c_init(&bus, &config));
+
+    i2c_slave.regs[3] = 0x77;
+    uint8_t byte = 0;
+    TEST_ASSERT_TRUE(soft_i2c_read_reg(&bus, SLAVE_ADDRESS, 3, &byte, 1));
+    TEST_ASSERT_EQUAL_HEX8(0x77, byte);
+
+    // A slave that never lets go
+    i2c_slave.stretch_reads = UINT32_MAX;
+    bus.stretch_timeout_us = 1000;
+    TEST_ASSERT_FALSE(soft_i2c_read_reg(&bus, SLAVE_ADDRESS, 3, &byte, 1));
+    TEST_ASSERT_EQUAL(SOFT_I2C_TIMEOUT, bus.error);
+}
+
+void test_soft_i2c_init_frees_stuck_bus(void) {
+    soft_i2c_t bus;
+    soft_i2c_config_t config = i2c_config(0);
+    i2c_slave_mock_attach(&i2c_slave);
+
+    // Reset in the middle of a read: the slave holds SDA low for a 0 bit
+    i2c_slave.state = I2C_SLAVE_TRANSMIT;
+    i2c_slave.clocks = 2;
+    i2c_slave.shift = 0x00;
+    i2c_slave.pull_sda = true;
+
+    TEST_ASSERT_TRUE(soft_i2c_init(&bus, &config));
+    TEST_ASSERT_FALSE(i2c_slave.pull_sda);
+    TEST_ASSERT_EQUAL(I2C_SLAVE_IDLE, i2c_slave.state);
+    TEST_ASSERT_TRUE(soft_i2c_probe(&bus, SLAVE_ADDRESS));
+}
+
+void test_soft_i2c_speed(void) {
+    soft_i2c_t bus;
+    soft_i2c_config_t config = i2c_config(100000);
+    i2c_slave_mock_attach(&i2c_slave);
+    TEST_ASSERT_TRUE(soft_i2c_init(&bus, &config));
+
+    // Address, register and 8 data bytes: 10 bytes of 9 clocks at 10 us
+    uint8_t data[8] = {0};
+    double start = now_us();
+    TEST_ASSERT_TRUE(soft_i2c_write_reg(&bus, SLAVE_ADDRESS, 0, data, sizeof(data)));
+    TEST_ASSERT_GREATER_OR_EQUAL(900, (int)(now_us() - start));
+}
+
+void test_soft_spi_modes(void) {
+    const uint8_t tx[] = {0xA5, 0x3C, 0x0F};
+    const uint8_t expected[] = {0x5A, 0xA5, 0x3C};
+
+    for (uint8_t mode = 0; mode < 4; mode++) {
+        soft_spi_t bus;
+        soft_spi_config_t config = spi_config(mode);
+        spi_slave.mode = mode;
+        spi_slave.reply = 0x5A;
+        spi_slave_mock_attach(&spi_slave);
+        TEST_ASSERT_TRUE(soft_spi_init(&bus, &config));
+        TEST_ASSERT_EQUAL(mode >= 2, gpio_mock_get_pin_state(PIN_SCK));
+
+        uint8_t rx[3] = {0};
+        TEST_ASSERT_TRUE(soft_spi_transfer(&bus, 0, tx, rx, sizeof(tx)));
+        TEST_ASSERT_EQUAL_HEX8_ARRAY_MESSAGE(expected, rx, sizeof(rx), "rx");
+        TEST_ASSERT_EQUAL(sizeof(tx), spi_slave.count);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY_MESSAGE(tx, spi_slave.received, sizeof(tx), "received");
+
+        // Idle clock and deselected slave afterwards
+        TEST_ASSERT_EQUAL(mode >= 2, gpio_mock_get_pin_state(PIN_SCK));
+        TEST_ASSERT_TRUE(gpio_mock_get_pin_state(PIN_CS0));
+    }
+}
+
+void test_soft_spi_lsb_first(void) {
+    soft_spi_t bus;
+    soft_spi_config_t config = spi_config(0);
+    config.lsb_first = true;
+    spi_slave.lsb_first = true;
+    spi_slave_mock_attach(&spi_slave);
+    TEST_ASSERT_TRUE(soft_spi_init(&bus, &config));
+
+    const uint8_t tx[] = {0x01, 0x80};
+    uint8_t rx[2];
+    TEST_ASSERT_TRUE(soft_spi_transfer(&bus, 0, tx, rx, sizeof(tx)));
+    TEST_ASSERT_EQUAL_HEX8(0x5A, rx[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, rx[1]);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(tx, spi_slave.received, sizeof(tx));
+}
+
+void test_soft_spi_write_then_read_and_chip_select(void) {
+    soft_spi_t bus;
+    soft_spi_config_t config = spi_config(0);
+    spi_slave.cs_pin = PIN_CS1;
+    spi_slave_mock_attach(&spi_slave);
+    TEST_ASSERT_TRUE(soft_spi_init(&bus, &config));
+
+    // The other slave's transfer does not reach this one
+    uint8_t byte = 0x11;
+    TEST_ASSERT_TRUE(soft_spi_transfer(&bus, 0, &byte, NULL, 1));
+    TEST_ASSERT_EQUAL(0, spi_slave.count);
+
+    const uint8_t command = 0x9F;
+    uint8_t rx[2];
+    TEST_ASSERT_TRUE(soft_spi_write_then_read(&bus, 1, &command, 1, rx, sizeof(rx)));
+    TEST_ASSERT_EQUAL_HEX8(0x9F, rx[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, rx[1]);
+    TEST_ASSERT_EQUAL(3, spi_slave.count);
+
+    TEST_ASSERT_FALSE(soft_spi_transfer(&bus, SOFT_SPI_MAX_DEVICES, &byte, NULL, 1));
+}
+
+void test_soft_spi_bank_writes_clock_and_data_together(void) {
+    gpio_handle_t *bank_pins[] = {&pins[PIN_SCK], &pins[PIN_MOSI]};
+    gpio_bank_t bank;
+    TEST_ASSERT_TRUE(gpio_bank_init(&bank, bank_pins, 2));
+    TEST_ASSERT_TRUE(gpio_mock_bank_attach(&bank));
+
+    soft_spi_t bus;
+    soft_spi_config_t config = spi_config(1);
+    config.bank = &bank;
+    spi_slave.mode = 1;
+    spi_slave_mock_attach(&spi_slave);
+    TEST_ASSERT_TRUE(soft_spi_init(&bus, &config));
+
+    const uint8_t tx[] = {0xC3, 0x81};
+    uint8_t rx[2];
+    TEST_ASSERT_TRUE(soft_spi_transfer(&bus, 0, tx, rx, sizeof(tx)));
+    TEST_ASSERT_EQUAL_HEX8(0x5A, rx[0]);
+    TEST_ASSERT_EQUAL_HEX8(0xC3, rx[1]);
+
+    // Two bank writes per bit, and no pin write behind the bank's back
+    TEST_ASSERT_EQUAL(0, gpio_mock_get_write_count(PIN_SCK));
+    TEST_ASSERT_EQUAL(0, gpio_mock_get_write_count(PIN_MOSI));
+    TEST_ASSERT_LESS_OR_EQUAL(1 + 2 * 8 * sizeof(tx) + 1, gpio_mock_get_bank_write_count());
+}
+
+// Unity main
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_soft_i2c_register_round_trip);
+    RUN_TEST(test_soft_i2c_probe_and_nack);
+    RUN_TEST(test_soft_i2c_clock_stretching);
+    RUN_TEST(test_soft_i2c_init_frees_stuck_bus);
+    RUN_TEST(test_soft_i2c_speed);
+    RUN_TEST(test_soft_spi_modes);
+    RUN_TEST(test_soft_spi_lsb_first);
+    RUN_TEST(test_soft_spi_write_then_read_and_chip_select);
+    RUN_TEST(test_soft_spi_bank_writes_clock_and_data_together);
+
+    return UNITY_END();
+}
@@ -0,0 +1,258 @@
+#include "core/timer_service.h"
+#include "components/button.h"
+#include "mocks/gpio_mock.h"
+#include "unity.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include <stdlib.h>
+
+#define NUM_TIMEOUTS 5000
+
+// Test fixtures
+static timeout_t timeouts[NUM_TIMEOUTS];
+static TickType_t fired_at[NUM_TIMEOUTS];
+static uint32_t fired;
+static uint32_t seed;
+
+static uint32_t next_random(void) {
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+}
+
+static void record_fire(void *arg) {
+    timeout_t *timeout = arg;
+    fired_at[timeout - timeouts] = timer_service_now();
+    fired++;
+}
+
+static void arm(int index, TickType_t delay) {
+    timeout_init(&timeouts[index], record_fire, &timeouts[index]);
+    timeout_arm(&timeouts[index], delay);
+}
+
+void setUp(void) {
+    fired = 0;
+    seed = 1;
+    for (int i = 0; i < NUM_TIMEOUTS; i++) {
+        fired_at[i] = 0;
+    }
+}
+
+void tearDown(void) {
+    for (int i = 0; i < NUM_TIMEOUTS; i++) {
+        timeout_cancel(&timeouts[i]);
+    }
+    TEST_ASSERT_EQUAL(0, timer_service_armed());
+}
+
+// Test cases
+void test_timeout_fires_on_its_tick_at_every_level(void) {
+    static const TickType_t delays[] = {
+        1, 2, 63, 64, 65, 127, 4095, 4096, 4097, 262143, 262144, 300000,
+        16777215, 16777216, 20000000,
+    };
+    const int count = sizeof(delays) / sizeof(delays[0]);
+
+    TickType_t start = timer_service_now();
+    for (int i = 0; i < count; i++) {
+        arm(i, delays[i]);
+    }
+    TEST_ASSERT_EQUAL(count, timer_service_armed());
+
+    // Advancing to the tick before each expiry fires nothing new
+    for (int i = 0; i < count; i++) {
+        timer_service_advance(start + delays[i] - 1);
+        TEST_ASSERT_EQUAL(i, fired);
+        timer_service_advance(start + delays[i]);
+        TEST_ASSERT_EQUAL(i + 1, fired);
+        TEST_ASSERT_EQUAL(start + delays[i], fired_at[i]);
+        TEST_ASSERT_FALSE(timeout_is_armed(&timeouts[i]));
+    }
+}
+
+void test_timeout_random_arm_cancel(void) {
+    TickType_t start = timer_service_now();
+    for (int i = 0; i < NUM_TIMEOUTS; i++) {
+        arm(i, 1 + next_random() % 100000);
+    }
+
+    // Cancel every third, re-arm every seventh somewhere else
+    uint32_t expected = 0;
+    for (int i = 0; i < NUM_TIMEOUTS; i++) {
+        if (i % 3 == 0) {
+            TEST_ASSERT_TRUE(timeout_cancel(&timeouts[i]));
+            TEST_ASSERT_FALSE(timeout_cancel(&timeouts[i]));
+        } else {
+            if (i % 7 == 0) {
+                timeout_arm(&timeouts[i], 1 + next_random() % 100000);
+            }
+            expected++;
+        }
+    }
+    TEST_ASSERT_EQUAL(expected, timer_service_armed());
+
+    // Move in uneven strides so slots are crossed in every pattern
+    TickType_t now = start;
+    while (timer_service_armed()) {
+        now += 1 + next_random() % 3000;
+        timer_service_advance(now);
+    }
+
+    TEST_ASSERT_EQUAL(expected, fired);
+    for (int i = 0; i < NUM_TIMEOUTS; i++) {
+        if (i % 3 == 0) {
+            TEST_ASSERT_EQUAL(0, fired_at[i]);
+        } else {
+            TEST_ASSERT_EQUAL(timeouts[i].expires, fired_at[i]);
+        }
+    }
+}
+
+static uint32_t periodic_count;
+
+static void periodic(void *arg) {
+    periodic_count++;
+    timeout_arm(arg, 10);
+}
+
+void test_timeout_rearm_from_callback(void) {
+    periodic_count = 0;
+    timeout_init(&timeouts[0], periodic, &timeouts[0]);
+    timeout_arm(&timeouts[0], 10);
+
+    TickType_t start = timer_service_now();
+    timer_service_advance(start + 1000);
+    TEST_ASSERT_EQUAL(100, periodic_count);
+    TEST_ASSERT_TRUE(timeout_is_armed(&timeouts[0]));
+}
+
+void test_timeout_batch_expiry(void) {
+    TickType_t start = timer_service_now();
+    for (int i = 0; i < NUM_TIMEOUTS; i++) {
+        arm(i, 500);
+    }
+
+    // Thousands of timeouts due on one tick fire in one call
+    timer_service_advance(start + 10000);
+    TEST_ASSERT_EQUAL(NUM_TIMEOUTS, fired);
+    for (int i = 0; i < NUM_TIMEOUTS; i++) {
+        TEST_ASSERT_EQUAL(start + 500, fired_at[i]);
+    }
+}
+
+void test_timeout_tick_wraparound(void) {
+    // The idle wheel jumps straight to the new tick
+    TickType_t start = (TickType_t)-300;
+    timer_service_advance(start);
+    TEST_ASSERT_EQUAL(start, timer_service_now());
+
+    for (int i = 0; i < 512; i++) {
+        arm(i, 1 + i * 2);
+    }
+    timer_service_advance(start + 2000);
+
+    TEST_ASSERT_EQUAL(512, fired);
+    for (int i = 0; i < 512; i++) {
+        TEST_ASSERT_EQUAL((TickType_t)(start + 1 + i * 2), fired_at[i]);
+    }
+}
+
+void test_timer_service_task(void) {
+    TEST_ASSERT_TRUE(timer_service_start());
+
+    // Far more timeouts than the kernel timer command queue holds
+    TickType_t start = xTaskGetTickCount();
+    for (int i = 0; i < NUM_TIMEOUTS; i++) {
+        arm(i, pdMS_TO_TICKS(20) + i % 16);
+    }
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    TEST_ASSERT_EQUAL(NUM_TIMEOUTS, fired);
+    for (int i = 0; i < NUM_TIMEOUTS; i++) {
+        TEST_ASSERT_TRUE(fired_at[i] - start >= pdMS_TO_TICKS(20) + i % 16);
+    }
+
+    timer_service_stop();
+}
+
+// Poll the button until the timer service has settled it
+static void poll_button(button_handle_t *button, int ms) {
+    button_event_t ignored;
+    for (int i = 0; i < ms; i++) {
+        button->process(button, &ignored);
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+}
+
+void test_button_long_press_repeat(void) {
+    QueueHandle_t events = xQueueCreate(32, sizeof(button_event_t));
+    button_handle_t button;
+    TEST_ASSERT_TRUE(button_driver.create(&button));
+    TEST_ASSERT_TRUE(gpio_mock_driver.create(&button.gpio));
+    button_config_t config = {
+        .gpio_config = {.pin = 0, .is_output = false, .active_high = true},
+        .debounce_ms = 10,
+        .long_press_ms = 100,
+        .repeat_ms = 50,
+        .event_queue = events,
+    };
+    gpio_mock_reset();
+    TEST_ASSERT_TRUE(button.init(&button, &config));
+
+    button_event_t event;
+    gpio_mock_set_pin_state(0, true);
+    poll_button(&button, 50);
+    TEST_ASSERT_TRUE(xQueueReceive(events, &event, 0));
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_PRESSED, event);
+    TEST_ASSERT_FALSE(button.process(&button, &event));
+
+    // Held past the long press: HELD from process, then REPEAT every 50 ms
+    vTaskDelay(pdMS_TO_TICKS(275));
+    TEST_ASSERT_TRUE(button.process(&button, &event));
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_HELD, event);
+
+    int repeats = 0;
+    while (xQueueReceive(events, &event, 0)) {
+        TEST_ASSERT_EQUAL(BUTTON_EVENT_REPEAT, event);
+        repeats++;
+    }
+    TEST_ASSERT_TRUE(repeats >= 3 && repeats <= 5);
+
+    // Release stops the repeat
+    gpio_mock_set_pin_state(0, false);
+    poll_button(&button, 50);
+    TEST_ASSERT_TRUE(xQueueReceive(events, &event, 0));
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_HELD, event);
+    vTaskDelay(pdMS_TO_TICKS(120));
+    TEST_ASSERT_FALSE(xQueueReceive(events, &event, 0));
+    TEST_ASSERT_FALSE(timeout_is_armed(&button.hold));
+
+    button_driver.destroy(&button);
+    gpio_mock_driver.destroy(&button.gpio);
+    vQueueDelete(events);
+    timer_service_stop();
+}
+
+static void test_runner(void *pvParameters) {
+    (void)pvParameters;
+    UNITY_BEGIN();
+
+    RUN_TEST(test_timeout_fires_on_its_tick_at_every_level);
+    RUN_TEST(test_timeout_random_arm_cancel);
+    RUN_TEST(test_timeout_rearm_from_callback);
+    RUN_TEST(test_timeout_batch_expiry);
+    RUN_TEST(test_timeout_tick_wraparound);
+    RUN_TEST(test_timer_service_task);
+    RUN_TEST(test_button_long_press_repeat);
+
+    exit(UNITY_END());
+}
+
+// Unity main
+int main(void) {
+    xTaskCreate(test_runner, "runner", configMINIMAL_STACK_SIZE, NULL,
+                tskIDLE_PRIORITY + 1, NULL);
+    vTaskStartScheduler();
+    return 1;
+}
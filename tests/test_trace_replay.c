@@ -0,0 +1,264 @@
+#include "components/button.h"
+#include "components/encoder.h"
+#include "mocks/gpio_mock.h"
+#include "mocks/gpio_trace.h"
+#include "unity.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include <stdlib.h>
+#include <unistd.h>
+
+#define BUTTON_PIN 0
+#define ENCODER_PIN_A 10
+#define ENCODER_PIN_B 11
+
+// Test fixtures
+static QueueHandle_t event_queue;
+static QueueHandle_t encoder_queue;
+static FILE *event_log;
+static char *event_log_buf;
+static size_t event_log_size;
+static char trace_path[] = "/tmp/uni_trace_XXXXXX";
+
+static const char *button_event_name(int event) {
+    switch (event) {
+        case BUTTON_EVENT_PRESSED: return "PRESSED";
+        case BUTTON_EVENT_RELEASED: return "RELEASED";
+        case BUTTON_EVENT_CLICKED: return "CLICKED";
+        case BUTTON_EVENT_HELD: return "HELD";
+    }
+    return "?";
+}
+
+// Virtual clock the golden replay moves: the timer service and the button
+// poll step through trace time one tick at a time, however fast it plays
+static TickType_t virtual_start;
+static TickType_t virtual_tick;
+
+static TickType_t virtual_now(void *arg) {
+    (void)arg;
+    return virtual_tick;
+}
+
+static const timer_service_clock_t virtual_clock = {.now = virtual_now};
+
+// Polls the button every tick up to time_us, like an application main loop,
+// and logs its events as they are sent, stamped with the tick they fired on
+static void poll_until(uint64_t time_us, void *arg) {
+    button_handle_t *button = arg;
+    TickType_t until = virtual_start + pdMS_TO_TICKS(time_us / 1000);
+    button_event_t event;
+
+    while ((int32_t)(until - virtual_tick) > 0) {
+        timer_service_advance(++virtual_tick);
+        button->process(button, &event);
+        while (xQueueReceive(event_queue, &event, 0)) {
+            uint64_t fired_us = (uint64_t)(virtual_tick - virtual_start) * portTICK_PERIOD_MS * 1000;
+            gpio_trace_log_event(event_log, fired_us, "button", button_event_name(event));
+        }
+    }
+}
+
+static char *read_file(const char *path) {
+    FILE *fp = fopen(path, "r");
+    TEST_ASSERT_NOT_NULL(fp);
+    static char buf[4096];
+    size_t n = fread(buf, 1, sizeof(buf) - 1, fp);
+    buf[n] = '\0';
+    fclose(fp);
+    return buf;
+}
+
+static void count_advance(uint64_t time_us, void *arg) {
+    (void)time_us;
+    (*(int *)arg)++;
+}
+
+// Quadrature steps, one per millisecond: forward then back
+static void build_encoder_trace(gpio_trace_t *trace, int forward, int back) {
+    static const uint8_t gray[4] = {0x0, 0x2, 0x3, 0x1};
+    int phase = 0;
+    uint64_t time_us = 0;
+
+    gpio_trace_init(trace);
+    for (int i = 0; i < forward + back; i++) {
+        int previous = gray[phase];
+        phase = (phase + (i < forward ? 1 : -1)) & 3;
+        time_us += 1000;
+        uint8_t pin = ((previous ^ gray[phase]) & 2) ? ENCODER_PIN_A : ENCODER_PIN_B;
+        bool level = pin == ENCODER_PIN_A ? gray[phase] & 2 : gray[phase] & 1;
+        TEST_ASSERT_TRUE(gpio_trace_append(trace, time_us, pin, level));
+    }
+}
+
+static void encoder_setup(encoder_handle_t *encoder) {
+    TEST_ASSERT_TRUE(encoder_driver.create(encoder));
+    TEST_ASSERT_TRUE(gpio_mock_driver.create(&encoder->gpio_a));
+    TEST_ASSERT_TRUE(gpio_mock_driver.create(&encoder->gpio_b));
+    encoder_config_t config = {
+        .gpio_a = {.pin = ENCODER_PIN_A, .active_high = true},
+        .gpio_b = {.pin = ENCODER_PIN_B, .active_high = true},
+        .steps_per_detent = 4,
+        .use_interrupts = true,
+        .event_queue = encoder_queue,
+    };
+    TEST_ASSERT_TRUE(encoder->init(encoder, &config));
+}
+
+static void encoder_teardown(encoder_handle_t *encoder) {
+    encoder_driver.destroy(encoder);
+    gpio_mock_driver.destroy(&encoder->gpio_a);
+    gpio_mock_driver.destroy(&encoder->gpio_b);
+}
+
+void setUp(void) {
+    gpio_mock_reset();
+    xQueueReset(encoder_queue);
+    event_log = open_memstream(&event_log_buf, &event_log_size);
+    TEST_ASSERT_NOT_NULL(event_log);
+}
+
+void tearDown(void) {
+    fclose(event_log);
+    free(event_log_buf);
+}
+
+// Test cases
+void test_trace_formats_round_trip(void) {
+    gpio_trace_t csv, binary;
+    TEST_ASSERT_TRUE(gpio_trace_load(&csv, TEST_DATA_DIR "/button_worn_switch.csv"));
+    TEST_ASSERT_EQUAL(28, csv.count);
+
+    int fd = mkstemp(trace_path);
+    TEST_ASSERT_TRUE(fd >= 0);
+    close(fd);
+    TEST_ASSERT_TRUE(gpio_trace_save_binary(&csv, trace_path));
+    TEST_ASSERT_TRUE(gpio_trace_load(&binary, trace_path));
+    unlink(trace_path);
+
+    TEST_ASSERT_EQUAL(csv.count, binary.count);
+    TEST_ASSERT_EQUAL_MEMORY(csv.transitions, binary.transitions,
+                             csv.count * sizeof(gpio_trace_transition_t));
+
+    gpio_trace_free(&csv);
+    gpio_trace_free(&binary);
+}
+
+void test_trace_csv_rejects_pin_out_of_range(void) {
+    char csv_path[] = "/tmp/uni_trace_XXXXXX";
+    int fd = mkstemp(csv_path);
+    TEST_ASSERT_TRUE(fd >= 0);
+    close(fd);
+    FILE *fp = fopen(csv_path, "w");
+    TEST_ASSERT_NOT_NULL(fp);
+    fprintf(fp, "0,1,1\n1000,256,1\n"); // 256 would wrap to pin 0
+    fclose(fp);
+
+    gpio_trace_t trace;
+    TEST_ASSERT_FALSE(gpio_trace_load(&trace, csv_path));
+    unlink(csv_path);
+}
+
+void test_trace_button_matches_golden(void) {
+    gpio_trace_t trace;
+    TEST_ASSERT_TRUE(gpio_trace_load(&trace, TEST_DATA_DIR "/button_worn_switch.csv"));
+
+    timer_service_stop();
+    virtual_start = virtual_tick = timer_service_now();
+    TEST_ASSERT_TRUE(timer_service_set_clock(&virtual_clock));
+
+    button_handle_t button;
+    TEST_ASSERT_TRUE(button_driver.create(&button));
+    TEST_ASSERT_TRUE(gpio_mock_driver.create(&button.gpio));
+    button_config_t config = {
+        .gpio_config = {.pin = BUTTON_PIN, .is_output = false, .active_high = true},
+        .debounce_ms = 50,
+        .long_press_ms = 1000,
+        .event_queue = event_queue,
+    };
+    TEST_ASSERT_TRUE(button.init(&button, &config));
+
+    gpio_trace_replay_config_t replay = {.speed = 0, .on_advance = poll_until, .arg = &button};
+    TEST_ASSERT_TRUE(gpio_trace_replay(&trace, &replay));
+    // Let the last debounce expire
+    poll_until(trace.transitions[trace.count - 1].time_us + 100000, &button);
+
+    button.deinit(&button);
+    gpio_mock_driver.destroy(&button.gpio);
+    gpio_trace_free(&trace);
+    TEST_ASSERT_TRUE(timer_service_set_clock(NULL));
+
+    fflush(event_log);
+    TEST_ASSERT_EQUAL_STRING(read_file(TEST_DATA_DIR "/button_worn_switch.golden"),
+                             event_log_buf);
+}
+
+void test_trace_replay_accelerated(void) {
+    gpio_trace_t trace;
+    build_encoder_trace(&trace, 64, 0); // 64 ms of trace time
+
+    encoder_handle_t encoder;
+    encoder_setup(&encoder);
+
+    gpio_trace_replay_config_t replay = {.speed = 8};
+    TickType_t start = xTaskGetTickCount();
+    TEST_ASSERT_TRUE(gpio_trace_replay(&trace, &replay));
+    TickType_t elapsed = xTaskGetTickCount() - start;
+
+    TEST_ASSERT_GREATER_OR_EQUAL(pdMS_TO_TICKS(64 / 8 - 1), elapsed);
+    TEST_ASSERT_LESS_THAN(pdMS_TO_TICKS(64 / 2), elapsed);
+    TEST_ASSERT_EQUAL(64, encoder.get_position(&encoder));
+
+    encoder_teardown(&encoder);
+    gpio_trace_free(&trace);
+}
+
+void test_trace_replay_as_fast_as_possible(void) {
+    gpio_trace_t trace;
+    build_encoder_trace(&trace, 40, 16);
+
+    encoder_handle_t encoder;
+    encoder_setup(&encoder);
+
+    int advances = 0;
+    gpio_trace_replay_config_t replay = {.speed = 0, .on_advance = count_advance, .arg = &advances};
+    TEST_ASSERT_TRUE(gpio_trace_replay(&trace, &replay));
+
+    TEST_ASSERT_EQUAL(56, advances);
+    TEST_ASSERT_EQUAL(24, encoder.get_position(&encoder));
+
+    // One event per detent, in trace order
+    encoder_event_t event;
+    for (int i = 0; i < 14; i++) {
+        TEST_ASSERT_TRUE(xQueueReceive(encoder_queue, &event, 0));
+        TEST_ASSERT_EQUAL(i < 10 ? ENCODER_EVENT_CW : ENCODER_EVENT_CCW, event);
+    }
+    TEST_ASSERT_FALSE(xQueueReceive(encoder_queue, &event, 0));
+
+    encoder_teardown(&encoder);
+    gpio_trace_free(&trace);
+}
+
+static void test_runner(void *pvParameters) {
+    (void)pvParameters;
+    UNITY_BEGIN();
+
+    RUN_TEST(test_trace_formats_round_trip);
+    RUN_TEST(test_trace_csv_rejects_pin_out_of_range);
+    RUN_TEST(test_trace_button_matches_golden);
+    RUN_TEST(test_trace_replay_accelerated);
+    RUN_TEST(test_trace_replay_as_fast_as_possible);
+
+    exit(UNITY_END());
+}
+
+// Unity main
+int main(void) {
+    event_queue = xQueueCreate(10, sizeof(button_event_t));
+    encoder_queue = xQueueCreate(32, sizeof(encoder_event_t));
+    xTaskCreate(test_runner, "runner", configMINIMAL_STACK_SIZE, NULL,
+                tskIDLE_PRIORITY + 1, NULL);
+    vTaskStartScheduler();
+    return 1;
+}
@@ -0,0 +1,244 @@
+#include "core/uni_log.h"
+#include "unity.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define NUM_TASKS 4
+#define TASK_MESSAGES 400
+
+// Test fixtures
+static char path[64];
+
+void setUp(void) {
+    snprintf(path, sizeof(path), "/tmp/uni-lib-log-%d", (int)getpid());
+}
+
+void tearDown(void) {
+    uni_log_stop();
+    unlink(path);
+}
+
+static void start_file(bool binary) {
+    uni_log_config_t config = {.sink = UNI_LOG_SINK_FILE, .path = path, .binary = binary};
+    TEST_ASSERT_TRUE(uni_log_start(&config));
+}
+
+static char *read_file(void) {
+    static char contents[1 << 20];
+    FILE *file = fopen(path, "r");
+    TEST_ASSERT_NOT_NULL(file);
+    size_t len = fread(contents, 1, sizeof(contents) - 1, file);
+    contents[len] = '\0';
+    fclose(file);
+    return contents;
+}
+
+static void assert_format(const char *expected, const char *fmt,
+                          const uni_log_arg_t *args, int count) {
+    char buf[128];
+    uni_log_format(buf, sizeof(buf), fmt, args, count);
+    TEST_ASSERT_EQUAL_STRING(expected, buf);
+}
+
+// Test cases
+void test_format_matches_printf(void) {
+    uni_log_arg_t args[4];
+
+    args[0].i = -42;
+    args[1].u = 0xbeef;
+    args[2].d = 3.25;
+    args[3].s = "pin";
+    assert_format("-42 beef 3.250 pin", "%d %x %.3f %s", args, 4);
+    assert_format("[  -42] [0XBEEF] [3.2] [pin  ]", "[%5d] [%#X] [%.1f] [%-5s]", args, 4);
+
+    // Narrowed to the length modifier, like printf's promotions
+    assert_format("4294967295 255 65535", "%u %hhu %hu", (uni_log_arg_t[]){{.i = -1}, {.i = -1}, {.i = -1}}, 3);
+    assert_format("-1 18446744073709551615", "%ld %llu", (uni_log_arg_t[]){{.i = -1}, {.i = -1}}, 2);
+
+    // * widths take an argument, %% takes none
+    assert_format("100% [   7]", "100%% [%*d]", (uni_log_arg_t[]){{.i = 4}, {.i = 7}}, 2);
+
+    // Missing arguments are marked, never read
+    assert_format("a=1 b=<?>", "a=%d b=%d", (uni_log_arg_t[]){{.i = 1}}, 1);
+}
+
+void test_arg_types(void) {
+    uni_log_arg_type_t types[8];
+    TEST_ASSERT_EQUAL(6, uni_log_arg_types("%d %% %s %*.*f %p", types, 8));
+    TEST_ASSERT_EQUAL(UNI_LOG_ARG_INT, types[0]);
+    TEST_ASSERT_EQUAL(UNI_LOG_ARG_STRING, types[1]);
+    TEST_ASSERT_EQUAL(UNI_LOG_ARG_INT, types[2]);
+    TEST_ASSERT_EQUAL(UNI_LOG_ARG_INT, types[3]);
+    TEST_ASSERT_EQUAL(UNI_LOG_ARG_DOUBLE, types[4]);
+    TEST_ASSERT_EQUAL(UNI_LOG_ARG_POINTER, types[5]);
+}
+
+static int evaluated;
+
+static int side_effect(void) {
+    return ++evaluated;
+}
+
+void test_filtered_level_is_not_evaluated(void) {
+    evaluated = 0;
+    UNI_LOG_NONE("never %d", side_effect());
+    TEST_ASSERT_EQUAL(0, evaluated);
+}
+
+void test_text_file_sink(void) {
+    start_file(false);
+    enum { LEVEL_LOW = 3 } level = LEVEL_LOW;
+    UNI_LOG_INFO("pin %u level %d", 18u, level);
+    UNI_LOG_WARN("ratio %.2f of %s", 0.5, "budget");
+    UNI_LOG_ERROR("no arguments");
+    uni_log_stop();
+
+    char *text = read_file();
+    TEST_ASSERT_NOT_NULL(strstr(text, " INFO  runner       pin 18 level 3\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, " WARN  runner       ratio 0.50 of budget\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, " ERROR runner       no arguments\n"));
+    TEST_ASSERT_TRUE(strstr(text, "pin 18") < strstr(text, "no arguments"));
+}
+
+void test_binary_round_trip(void) {
+    start_file(true);
+    char transient[16];
+    strcpy(transient, "copied");
+    for (int i = 0; i < 3; i++) {
+        UNI_LOG_INFO("loop %d of %s at %p", i, "three", (void *)0x1234);
+    }
+    UNI_LOG_DEBUG("%s %c %lld %g", transient, 'x', -5ll, 1.5);
+    uni_log_stop();
+
+    FILE *file = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL(file);
+    uni_log_reader_t reader;
+    TEST_ASSERT_TRUE(uni_log_reader_open(&reader, file));
+    TEST_ASSERT_EQUAL(configTICK_RATE_HZ, reader.tick_rate);
+
+    static uni_log_message_t message;
+    char buf[UNI_LOG_MAX_LINE];
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(uni_log_reader_next(&reader, &message));
+        TEST_ASSERT_EQUAL(UNI_LOG_LEVEL_INFO, message.level);
+        TEST_ASSERT_EQUAL_STRING("runner", message.task);
+        uni_log_format(buf, sizeof(buf), message.fmt, message.args, message.count);
+        char expected[64];
+        snprintf(expected, sizeof(expected), "loop %d of three at %p", i, (void *)0x1234);
+        TEST_ASSERT_EQUAL_STRING(expected, buf);
+    }
+
+    // Strings are copied into the log, not kept as pointers
+    TEST_ASSERT_TRUE(uni_log_reader_next(&reader, &message));
+    TEST_ASSERT_EQUAL(UNI_LOG_LEVEL_DEBUG, message.level);
+    uni_log_format(buf, sizeof(buf), message.fmt, message.args, message.count);
+    TEST_ASSERT_EQUAL_STRING("copied x -5 1.5", buf);
+
+    TEST_ASSERT_FALSE(uni_log_reader_next(&reader, &message));
+    TEST_ASSERT_TRUE(feof(file));
+    uni_log_reader_close(&reader);
+    fclose(file);
+}
+
+void test_full_ring_counts_drops(void) {
+    start_file(false);
+    uni_log_flush();
+    uint32_t before = uni_log_dropped();
+
+    // The drain runs below this task, so nothing drains until it blocks and
+    // exactly the last 10 messages overflow the ring
+    for (int i = 0; i < LOG_RING_SLOTS + 10; i++) {
+        UNI_LOG_DEBUG("burst %d", i);
+    }
+    uni_log_stop();
+
+    uint32_t dropped = uni_log_dropped() - before;
+    char *text = read_file();
+    int lines = 0;
+    for (char *p = strstr(text, "burst "); p; p = strstr(p + 1, "burst ")) {
+        lines++;
+    }
+    TEST_ASSERT_EQUAL(10, dropped);
+    TEST_ASSERT_EQUAL(LOG_RING_SLOTS, lines);
+
+    // The drops are reported in a single line
+    int reports = 0;
+    for (char *p = strstr(text, "dropped "); p; p = strstr(p + 1, "dropped ")) {
+        reports++;
+    }
+    TEST_ASSERT_EQUAL(1, reports);
+    TEST_ASSERT_NOT_NULL(strstr(text, "dropped 10 messages"));
+}
+
+static atomic_int finished;
+
+static void log_task(void *arg) {
+    int index = (int)(intptr_t)arg;
+    for (int i = 0; i < TASK_MESSAGES; i++) {
+        UNI_LOG_INFO("task %d message %d", index, i);
+        if (i % 4 == 3) vTaskDelay(1); // Well under a ring per drain period
+    }
+    atomic_fetch_add(&finished, 1);
+    vTaskDelete(NULL);
+}
+
+void test_tasks_log_concurrently(void) {
+    start_file(false);
+    uint32_t before = uni_log_dropped();
+    atomic_store(&finished, 0);
+    for (intptr_t i = 0; i < NUM_TASKS; i++) {
+        char name[8];
+        snprintf(name, sizeof(name), "log%d", (int)i);
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(log_task, name, configMINIMAL_STACK_SIZE,
+                                              (void *)i, tskIDLE_PRIORITY + 1, NULL));
+    }
+    while (atomic_load(&finished) < NUM_TASKS) {
+        vTaskDelay(5);
+    }
+    uni_log_stop();
+    TEST_ASSERT_EQUAL(before, uni_log_dropped());
+
+    // Every message once, in order within its task, under the task's name
+    char *text = read_file();
+    int next[NUM_TASKS] = {0};
+    for (char *line = strtok(text, "\n"); line; line = strtok(NULL, "\n")) {
+        int task, message;
+        char name[8];
+        if (sscanf(line, "%*u INFO %7s task %d message %d", name, &task, &message) != 3) continue;
+        TEST_ASSERT_TRUE(task >= 0 && task < NUM_TASKS);
+        TEST_ASSERT_EQUAL(next[task], message);
+        TEST_ASSERT_EQUAL(task, name[3] - '0');
+        next[task]++;
+    }
+    for (int i = 0; i < NUM_TASKS; i++) {
+        TEST_ASSERT_EQUAL(TASK_MESSAGES, next[i]);
+    }
+}
+
+static void test_runner(void *pvParameters) {
+    (void)pvParameters;
+    UNITY_BEGIN();
+
+    RUN_TEST(test_format_matches_printf);
+    RUN_TEST(test_arg_types);
+    RUN_TEST(test_filtered_level_is_not_evaluated);
+    RUN_TEST(test_text_file_sink);
+    RUN_TEST(test_binary_round_trip);
+    RUN_TEST(test_full_ring_counts_drops);
+    RUN_TEST(test_tasks_log_concurrently);
+
+    exit(UNITY_END());
+}
+
+// Unity main
+int main(void) {
+    xTaskCreate(test_runner, "runner", configMINIMAL_STACK_SIZE, NULL,
+                tskIDLE_PRIORITY + 2, NULL);
+    vTaskStartScheduler();
+    return 1;
+}
@@ -0,0 +1,240 @@
+#include "core/uni_loop.h"
+#include "unity.h"
+#include <pthread.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <time.h>
+#include <unistd.h>
+
+#define WAKEUPS 100
+
+// Test fixtures
+static uni_loop_t loop;
+static int calls;
+
+void setUp(void) {
+    calls = 0;
+    TEST_ASSERT_TRUE(uni_loop_init(&loop));
+    TEST_ASSERT_TRUE(loop.drives_timers);
+}
+
+void tearDown(void) {
+    uni_loop_deinit(&loop);
+}
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void count_call(uni_loop_source_t *source, void *arg) {
+    (void)source;
+    (void)arg;
+    calls++;
+}
+
+// Run the loop until calls reaches target or the time runs out
+static void run_until(int target, int max_ms) {
+    double deadline = now_ms() + max_ms;
+    while (calls < target && now_ms() < deadline) {
+        TEST_ASSERT_TRUE(uni_loop_run_once(&loop, 10) >= 0);
+    }
+}
+
+// Test cases
+void test_loop_periodic_timer(void) {
+    uni_loop_source_t timer;
+    TEST_ASSERT_TRUE(uni_loop_add_timer(&loop, &timer, 5, 5, count_call, NULL));
+
+    double start = now_ms();
+    run_until(10, 1000);
+    TEST_ASSERT_EQUAL(10, calls);
+    TEST_ASSERT_TRUE(now_ms() - start >= 45);
+
+    // Sleeping, not spinning: about one wakeup per expiry
+    TEST_ASSERT_TRUE(loop.stats.wakeups <= 12);
+    uni_loop_remove(&timer);
+}
+
+void test_loop_one_shot_timer(void) {
+    uni_loop_source_t timer;
+    TEST_ASSERT_TRUE(uni_loop_add_timer(&loop, &timer, 0, 0, count_call, NULL));
+
+    run_until(1, 100);
+    TEST_ASSERT_EQUAL(1, calls);
+    TEST_ASSERT_EQUAL(0, uni_loop_run_once(&loop, 20));
+    uni_loop_remove(&timer);
+}
+
+static uni_loop_source_t wakeup;
+
+static void *wake_thread(void *arg) {
+    (void)arg;
+    for (int i = 0; i < WAKEUPS; i++) {
+        uni_loop_wake(&wakeup);
+        usleep(100);
+    }
+    return NULL;
+}
+
+void test_loop_wakeup_from_thread(void) {
+    TEST_ASSERT_TRUE(uni_loop_add_wakeup(&loop, &wakeup, count_call, NULL));
+
+    pthread_t thread;
+    TEST_ASSERT_EQUAL(0, pthread_create(&thread, NULL, wake_thread, NULL));
+    pthread_join(thread, NULL);
+
+    // Wakeups coalesce, so there is at least one callback and no more than sent
+    run_until(1, 100);
+    while (uni_loop_run_once(&loop, 0) > 0) {
+    }
+    TEST_ASSERT_TRUE(calls >= 1 && calls <= WAKEUPS);
+    uni_loop_remove(&wakeup);
+}
+
+static void read_pipe(uni_loop_source_t *source, void *arg) {
+    char byte;
+    TEST_ASSERT_EQUAL(1, read(source->fd, &byte, 1));
+    *(char *)arg = byte;
+    calls++;
+}
+
+void test_loop_fd_sources_share_descriptor(void) {
+    int fds[2];
+    TEST_ASSERT_EQUAL(0, pipe(fds));
+
+    // Two sources on one descriptor: only the first reads, both are called
+    char got = 0;
+    uni_loop_source_t reader, watcher;
+    TEST_ASSERT_TRUE(uni_loop_add_fd(&loop, &reader, fds[0], EPOLLIN, read_pipe, &got));
+    TEST_ASSERT_TRUE(uni_loop_add_fd(&loop, &watcher, fds[0], EPOLLIN, count_call, NULL));
+    TEST_ASSERT_EQUAL(0, uni_loop_run_once(&loop, 0));
+
+    TEST_ASSERT_EQUAL(1, write(fds[1], "x", 1));
+    TEST_ASSERT_EQUAL(2, uni_loop_run_once(&loop, 100));
+    TEST_ASSERT_EQUAL('x', got);
+
+    // The descriptor stays registered for the remaining source
+    uni_loop_remove(&watcher);
+    TEST_ASSERT_EQUAL(1, write(fds[1], "y", 1));
+    TEST_ASSERT_EQUAL(1, uni_loop_run_once(&loop, 100));
+    TEST_ASSERT_EQUAL('y', got);
+
+    uni_loop_remove(&reader);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+static uni_loop_source_t removable[2];
+
+static void remove_other(uni_loop_source_t *source, void *arg) {
+    (void)arg;
+    uni_loop_remove(&removable[source == &removable[0] ? 1 : 0]);
+    calls++;
+}
+
+void test_loop_callback_removes_source(void) {
+    int fds[2];
+    TEST_ASSERT_EQUAL(0, pipe(fds));
+    TEST_ASSERT_TRUE(uni_loop_add_fd(&loop, &removable[0], fds[0], EPOLLIN, remove_other, NULL));
+    TEST_ASSERT_TRUE(uni_loop_add_fd(&loop, &removable[1], fds[0], EPOLLIN, remove_other, NULL));
+
+    TEST_ASSERT_EQUAL(1, write(fds[1], "x", 1));
+    TEST_ASSERT_EQUAL(1, uni_loop_run_once(&loop, 100));
+    TEST_ASSERT_EQUAL(1, calls);
+    TEST_ASSERT_NULL(loop.sources->next);
+
+    uni_loop_remove(loop.sources);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+static double fired_ms[3];
+static timeout_t timeouts[3];
+
+static void record_timeout(void *arg) {
+    fired_ms[(timeout_t *)arg - timeouts] = now_ms();
+    calls++;
+}
+
+void test_loop_drives_timer_service(void) {
+    double start = now_ms();
+    static const int delays[] = {30, 10, 20};
+    for (int i = 0; i < 3; i++) {
+        timeout_init(&timeouts[i], record_timeout, &timeouts[i]);
+        timeout_arm(&timeouts[i], pdMS_TO_TICKS(delays[i]));
+    }
+
+    // The loop sleeps until each timeout instead of polling
+    run_until(3, 1000);
+    TEST_ASSERT_EQUAL(3, calls);
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(fired_ms[i] - start >= delays[i] - 1);
+    }
+    TEST_ASSERT_TRUE(fired_ms[1] <= fired_ms[2] && fired_ms[2] <= fired_ms[0]);
+    TEST_ASSERT_TRUE(loop.stats.wakeups <= 8);
+    TEST_ASSERT_EQUAL(0, timer_service_armed());
+}
+
+static void *arm_thread(void *arg) {
+    (void)arg;
+    usleep(10000);
+    timeout_arm(&timeouts[0], pdMS_TO_TICKS(5));
+    return NULL;
+}
+
+void test_loop_timeout_armed_from_thread(void) {
+    timeout_init(&timeouts[0], record_timeout, &timeouts[0]);
+
+    // The loop blocks with nothing armed and must be woken to notice it
+    pthread_t thread;
+    TEST_ASSERT_EQUAL(0, pthread_create(&thread, NULL, arm_thread, NULL));
+    double start = now_ms();
+    while (!calls && now_ms() - start < 1000) {
+        uni_loop_run_once(&loop, -1);
+    }
+    pthread_join(thread, NULL);
+
+    TEST_ASSERT_EQUAL(1, calls);
+    TEST_ASSERT_TRUE(now_ms() - start < 100);
+}
+
+static void stop_loop(uni_loop_source_t *source, void *arg) {
+    (void)source;
+    if (++calls == 3) uni_loop_stop(arg);
+}
+
+void test_loop_run_until_stopped(void) {
+    uni_loop_source_t timer;
+    TEST_ASSERT_TRUE(uni_loop_add_timer(&loop, &timer, 1, 1, stop_loop, &loop));
+
+    TEST_ASSERT_TRUE(uni_loop_run(&loop));
+    TEST_ASSERT_EQUAL(3, calls);
+    uni_loop_remove(&timer);
+}
+
+void test_second_loop_leaves_timer_service(void) {
+    uni_loop_t other;
+    TEST_ASSERT_TRUE(uni_loop_init(&other));
+    TEST_ASSERT_FALSE(other.drives_timers);
+    uni_loop_deinit(&other);
+    TEST_ASSERT_TRUE(loop.drives_timers);
+}
+
+// Unity main
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_loop_periodic_timer);
+    RUN_TEST(test_loop_one_shot_timer);
+    RUN_TEST(test_loop_wakeup_from_thread);
+    RUN_TEST(test_loop_fd_sources_share_descriptor);
+    RUN_TEST(test_loop_callback_removes_source);
+    RUN_TEST(test_loop_drives_timer_service);
+    RUN_TEST(test_loop_timeout_armed_from_thread);
+    RUN_TEST(test_loop_run_until_stopped);
+    RUN_TEST(test_second_loop_leaves_timer_service);
+
+    return UNITY_END();
+}
@@ -0,0 +1,77 @@
+#include "core/event_ring.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static const char *kind_name(uint16_t kind) {
+  switch (kind) {
+  case EVENT_KIND_GPIO_EDGE:
+    return "gpio";
+  case EVENT_KIND_BUTTON:
+    return "button";
+  case EVENT_KIND_ENCODER:
+    return "encoder";
+  case EVENT_KIND_KEYPAD:
+    return "keypad";
+  }
+  return "unknown";
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "Usage: %s [-a] [-n count] [name]\n"
+          "  -a        start from the oldest record instead of new ones\n"
+          "  -n count  exit after count records\n"
+          "  name      shared memory name (default %s)\n",
+          prog, EVENT_RING_DEFAULT_NAME);
+}
+
+int main(int argc, char *argv[]) {
+  bool all = false;
+  long limit = -1;
+  int opt;
+  while ((opt = getopt(argc, argv, "an:h")) != -1) {
+    switch (opt) {
+    case 'a':
+      all = true;
+      break;
+    case 'n':
+      limit = strtol(optarg, NULL, 10);
+      break;
+    default:
+      usage(argv[0]);
+      return opt == 'h' ? 0 : 1;
+    }
+  }
+  const char *name = optind < argc ? argv[optind] : EVENT_RING_DEFAULT_NAME;
+
+  event_ring_reader_t reader;
+  if (!event_ring_reader_open(&reader, name, !all)) {
+    fprintf(stderr, "Cannot open event ring %s\n", name);
+    return 1;
+  }
+
+  // One line per record: seq time_ns kind source code
+  uint64_t lost = 0;
+  event_record_t record;
+  while (limit != 0) {
+    if (!event_ring_read(&reader, &record)) {
+      fflush(stdout);
+      event_ring_wait(&reader, 1000);
+      continue;
+    }
+
+    if (reader.lost != lost) {
+      printf("# lost %" PRIu64 " records\n", reader.lost - lost);
+      lost = reader.lost;
+    }
+    printf("%" PRIu64 " %" PRIu64 " %s %u %" PRIu32 "\n", record.seq,
+           record.time_ns, kind_name(record.kind), record.source, record.code);
+    if (limit > 0)
+      limit--;
+  }
+
+  event_ring_reader_close(&reader);
+  return 0;
+}
@@ -0,0 +1,70 @@
+#include "core/uni_log_format.h"
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "Usage: %s [-l level] [file]\n"
+          "  -l level  skip messages below level (0 debug .. 3 error)\n"
+          "  file      binary log written by uni_log (default stdin)\n",
+          prog);
+}
+
+int main(int argc, char *argv[]) {
+  int min_level = UNI_LOG_LEVEL_DEBUG;
+  int opt;
+  while ((opt = getopt(argc, argv, "l:h")) != -1) {
+    switch (opt) {
+    case 'l':
+      min_level = atoi(optarg);
+      break;
+    default:
+      usage(argv[0]);
+      return opt == 'h' ? 0 : 1;
+    }
+  }
+
+  FILE *file = stdin;
+  if (optind < argc && !(file = fopen(argv[optind], "rb"))) {
+    fprintf(stderr, "Cannot open %s\n", argv[optind]);
+    return 1;
+  }
+
+  uni_log_reader_t reader;
+  if (!uni_log_reader_open(&reader, file)) {
+    fprintf(stderr, "Not a uni_log binary log\n");
+    return 1;
+  }
+  printf("# tick rate %u Hz\n", reader.tick_rate);
+
+  // Same lines as the text sink
+  static uni_log_message_t message;
+  uint64_t dropped = 0;
+  char line[UNI_LOG_MAX_LINE];
+  while (uni_log_reader_next(&reader, &message)) {
+    if (reader.dropped != dropped) {
+      printf("# dropped %" PRIu64 " messages\n", reader.dropped - dropped);
+      dropped = reader.dropped;
+    }
+    if (message.level < min_level)
+      continue;
+
+    uni_log_format_line(line, sizeof(line), message.level, message.tick,
+                        message.task, message.fmt, message.args,
+                        message.count);
+    fputs(line, stdout);
+  }
+  bool complete = feof(file) != 0;
+
+  uni_log_reader_close(&reader);
+  if (file != stdin)
+    fclose(file);
+
+  if (!complete) {
+    fprintf(stderr, "Malformed record\n");
+    return 1;
+  }
+  return 0;
+}